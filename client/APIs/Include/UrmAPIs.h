@@ -44,6 +44,34 @@ extern "C" {
  */
 int64_t tuneResources(int64_t duration, int32_t prop, int32_t numRes, SysResource* resourceList);
 
+/**
+ * @brief A single Tune Request, part of a batch issued via tuneResourcesBatch.
+ *        The fields carry the same meaning as the corresponding tuneResources params.
+ */
+typedef struct {
+    int64_t mDuration;
+    int32_t mProperties;
+    int32_t mNumRes;
+    SysResource* mResourceList;
+} TuneRequestInfo;
+
+/**
+ * @brief Issue multiple independent Tune Requests in a single round trip.
+ * @details Each Request carries its own duration, properties and Resource List, and is processed
+ *          exactly as if it were issued via tuneResources, i.e. the Requests can be individually
+ *          retuned or untuned via their handles. All the Requests are sent to the server in a single
+ *          message, and the handles are received in a single response. This is useful for clients
+ *          configuring a set of knobs at once, for example at app launch.
+ * @param numRequests Number of Requests in the batch, at most MAX_TUNE_BATCH_SIZE (64).
+ * @param requestList List of Requests to be issued.
+ * @param handles An array of (at least) numRequests entries, populated with the handle of each Request,
+ *                in the same order as requestList. The handle is -1, if the server dropped the Request.
+ * @return int8_t:\n
+ *            - 0: If the batch was sent to the server, and the handles were received.\n
+ *            - -1: Otherwise.
+ */
+int8_t tuneResourcesBatch(int32_t numRequests, TuneRequestInfo* requestList, int64_t* handles);
+
 /**
  * @brief Modify the duration of a previously issued Tune Request.
  * @details Use this API to increase the duration (in milliseconds) of an existing Request issued via.
@@ -163,6 +191,115 @@ int8_t relaySignal(uint32_t sigId,
  */
 int8_t untuneSignal(int64_t handle);
 
+/**
+ * @brief Enable (or disable) the persistent session mode for the calling process.
+ * @details By default, each API call opens a new connection to the server, which is closed once
+ *          the Request has been sent (and the response, if any, has been received).\n
+ *          In the persistent session mode, each client thread establishes a connection on first use and
+ *          keeps it open for all of its subsequent API calls. The server serves all the Requests received
+ *          on it, in order. This saves the connect, accept and teardown cost on every call, and is recommended
+ *          for clients issuing Requests at a high rate. Requests which do not expect a response
+ *          (untune, retune, relay) are pipelined, i.e. the call returns as soon as the Request is sent.\n
+ *          If the server declines the session, the client falls back to a connection per Request.\n
+ *          The mode applies to all the threads of the process, the sessions held by the other threads
+ *          are updated on their next API call.
+ * @param enable 1 to enable the persistent session mode, 0 to disable it (any open session is closed).
+ * @return int8_t:\n
+ *            - 0: If the mode was successfully updated.\n
+ *            - -1: Otherwise
+ */
+int8_t setPersistentSession(int8_t enable);
+
+/**
+ * @brief Enable (or disable) the Shared Ring transport for the calling process.
+ * @details In this mode, each client thread sets up a shared memory Submission Queue and Completion
+ *          Queue with the server (over a persistent session). Tune, retune and untune Requests (for both Resources and
+ *          Signals) are then written to the Submission Queue, and the handles are read from the Completion
+ *          Queue. Either side only issues a syscall (an eventfd write) to wake up the other side, if it is
+ *          sleeping. Hence a client issuing Requests at a high rate (for example once per frame) does not
+ *          pay the socket syscalls and copies per Request. getProp is still served over the socket.\n
+ *          If the server declines the ring, the client falls back to the socket transport.
+ * @param enable 1 to enable the Shared Ring transport, 0 to disable it (any attached ring is released).
+ * @return int8_t:\n
+ *            - 0: If the mode was successfully updated.\n
+ *            - -1: Otherwise
+ */
+int8_t setRingTransport(int8_t enable);
+
+/**
+ * @brief Completion of a Request issued via one of the async APIs.
+ */
+typedef struct {
+    int64_t mTicket; //!< Ticket returned by the async API, when the Request was issued.
+    int64_t mHandle; //!< Handle of the Request (for untune, the handle which was passed in).
+    int32_t mStatus; //!< 0 if the Request was accepted by the server, -1 otherwise.
+} UrmCompletion;
+
+/**
+ * @brief Get the completion fd, for the async APIs.
+ * @details The fd (an eventfd) becomes readable whenever a completion is available to be reaped via
+ *          urmReapCompletions. It can hence be added to the caller's own event loop (poll / epoll),
+ *          and remains valid for the lifetime of the process. The fd must not be read or closed by
+ *          the caller. It may occasionally be readable with no completion pending.
+ * @return int32_t:\n
+ *            - The completion fd.\n
+ *            - -1: If the fd could not be created.
+ */
+int32_t urmGetCompletionFd();
+
+/**
+ * @brief Asynchronous variant of tuneResources.
+ * @details The Request is submitted to the server via a Shared Ring, and the call returns without waiting
+ *          for the handle. The handle is delivered as a completion, reaped via urmReapCompletions.
+ *          The params carry the same meaning as for tuneResources. Requests which do not fit a Shared
+ *          Ring entry (REQ_BUFFER_SIZE, i.e. 580 bytes) must be issued via tuneResources instead.
+ * @return int64_t:\n
+ *            - A Positive Ticket, which identifies the completion of the Request.\n
+ *            - -1: If the Request could not be submitted, for example if SHARED_RING_ENTRIES (128) Requests
+ *                  are already awaiting their completion.
+ */
+int64_t tuneResourcesAsync(int64_t duration, int32_t prop, int32_t numRes, SysResource* resourceList);
+
+/**
+ * @brief Asynchronous variant of untuneResources.
+ * @details The server does not acknowledge untune Requests, hence the completion is posted as soon as the
+ *          Request has been submitted to the server.
+ * @param handle Request Handle, returned by tuneResources (or via a tuneResourcesAsync completion).
+ * @return int64_t:\n
+ *            - A Positive Ticket, which identifies the completion of the Request.\n
+ *            - -1: If the Request could not be submitted.
+ */
+int64_t untuneResourcesAsync(int64_t handle);
+
+/**
+ * @brief Asynchronous variant of tuneSignal.
+ * @details The params carry the same meaning as for tuneSignal. The handle is delivered as a completion,
+ *          reaped via urmReapCompletions.
+ * @return int64_t:\n
+ *            - A Positive Ticket, which identifies the completion of the Request.\n
+ *            - -1: If the Request could not be submitted.
+ */
+int64_t tuneSignalAsync(uint32_t sigId,
+                        uint32_t sigType,
+                        int64_t duration,
+                        int32_t properties,
+                        const char* appName,
+                        const char* scenario,
+                        int32_t numArgs,
+                        uint32_t* list);
+
+/**
+ * @brief Reap the available completions of the Requests issued via the async APIs, without blocking.
+ * @details Completions of tune Requests are reaped in the order in which the Requests were issued. If the
+ *          server goes away, the outstanding Requests are completed with a status of -1.
+ * @param completions An array to be populated with the completions.
+ * @param maxCompletions Max number of completions to be reaped, i.e. the size of the completions array.
+ * @return int32_t:\n
+ *            - The number of completions reaped (0 if none is available).\n
+ *            - -1: If the params are invalid.
+ */
+int32_t urmReapCompletions(UrmCompletion* completions, int32_t maxCompletions);
+
 #ifdef __cplusplus
 }
 #endif
@@ -2,11 +2,18 @@
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <thread>
 #include <memory>
+#include <deque>
+#include <unistd.h>
+#include <sys/eventfd.h>
 
 #include "Utils.h"
 #include "UrmAPIs.h"
 #include "AuxRoutines.h"
+#include "SharedRing.h"
 #include "SocketClient.h"
 
 #define FILE_TAG "URM_API_CLIENT"
@@ -14,67 +21,283 @@
 #define CONN_SEND_FAIL "Failed to send Request to Server"
 #define CONN_INIT_FAIL "Failed to initialize Connection to resource-tuner Server"
 
+// Process wide client state.
 class ClientMgr {
 public:
     int8_t isUrmCli;
+    std::atomic<int8_t> mPersistent; //!< Persistent session mode requested by the client.
+    std::atomic<int8_t> mRingRequested; //!< Shared Ring transport requested by the client.
     std::string mClientComm;
-    std::shared_ptr<ClientEndpoint> conn;
 
     ClientMgr() {
         this->isUrmCli = false;
+        this->mPersistent = false;
+        this->mRingRequested = false;
         this->mClientComm = "";
         if(AuxRoutines::fetchComm(getpid(), this->mClientComm) == 0) {
             if(this->mClientComm == "urmCli") {
                 this->isUrmCli = true;
             }
         }
+    }
+};
 
-        if(conn == nullptr) {
-            try {
-                conn = std::shared_ptr<SocketClient> (new SocketClient());
-            } catch(const std::bad_alloc& e) {
-                LOGE(FILE_TAG, "Failed to establish connection with URM server");
-            }
+// Per thread client state. Each client thread sends its Requests over its own connection
+// (and its own session or Shared Ring, if requested), hence the client threads of a process
+// issue Requests in parallel, without contending on any lock.
+class ThreadClientCtx {
+public:
+    int8_t mSessionOpen; //!< A persistent session is currently established with the server.
+    int8_t mAwaitingRing; //!< Response to the last Request is posted to the Shared Ring CQ.
+    std::shared_ptr<ClientEndpoint> conn;
+    std::shared_ptr<SharedRing> mRing; //!< Attached to the current session, if any.
+
+    ThreadClientCtx() {
+        this->mSessionOpen = false;
+        this->mAwaitingRing = false;
+        this->mRing = nullptr;
+
+        try {
+            this->conn = std::shared_ptr<SocketClient> (new SocketClient());
+        } catch(const std::bad_alloc& e) {
+            this->conn = nullptr;
+            LOGE(FILE_TAG, "Failed to establish connection with URM server");
         }
     }
 };
 
-// Byte Encoder
-static FlatBuffEncoder batch;
-static std::mutex apiLock;
+// Byte Encoder, Requests are encoded into the frame following the frame header.
+// Note: The number of Resources per Request is only bounded by the frame
+// size (MAX_FRAME_PAYLOAD_SIZE).
+static thread_local FlatBuffEncoder batch;
+static thread_local std::vector<char> frame;
 
-// Max cap of 20 Resources per Request
-// Note: The actual number eventually allowed might be lower if there are
-// a lot of multi-valued resources, as the entire request needs to be encoded
-// as a byte-buffer of size REQ_BUFFER_SIZE.
-static const int32_t maxResPerReq = 20;
+// Max time (in milliseconds) to wait for space in the Shared Ring SQ,
+// and for a result in the Shared Ring CQ respectively.
+static const int32_t ringSubmitTimeout = 100;
+static const int32_t ringReapTimeout = 2000;
 
 static ClientMgr urmClientInfo;
+static thread_local ThreadClientCtx threadClientInfo;
 
-static int8_t sendMsgHelper(char* buf) {
-    if(urmClientInfo.conn == nullptr || RC_IS_NOTOK(urmClientInfo.conn->initiateConnection())) {
-        LOGE(FILE_TAG, CONN_INIT_FAIL);
+// State of the asynchronous APIs. These are served over a dedicated Shared Ring session, independent
+// of the connection used by the synchronous APIs, so that a pending completion never stalls (or is
+// mistaken for the response to) a synchronous call.
+class AsyncClientMgr {
+public:
+    int32_t mCompletionFd; //!< eventfd, used as the CQ doorbell of every ring attached over time.
+    int64_t mNextTicket;
+    std::shared_ptr<ClientEndpoint> mConn;
+    std::shared_ptr<SharedRing> mRing; //!< Attached to the current async session, if any.
+    std::deque<int64_t> mAwaitingCq; //!< Tickets of the Requests answered via the CQ, in submission order.
+    std::deque<UrmCompletion> mCompleted; //!< Completions generated locally, yet to be reaped.
+    FlatBuffEncoder mEncoder;
+    std::vector<char> mFrame;
+
+    AsyncClientMgr() {
+        this->mCompletionFd = -1;
+        this->mNextTicket = 1;
+        this->mConn = nullptr;
+        this->mRing = nullptr;
+    }
+
+    ~AsyncClientMgr() {
+        this->mRing = nullptr;
+        if(this->mConn != nullptr) {
+            this->mConn->closeConnection();
+        }
+        if(this->mCompletionFd >= 0) {
+            close(this->mCompletionFd);
+        }
+    }
+};
+
+static AsyncClientMgr asyncClientInfo;
+static std::mutex asyncLock;
+
+static void closeSessionHelper() {
+    if(threadClientInfo.conn != nullptr) {
+        threadClientInfo.conn->closeConnection();
+    }
+    threadClientInfo.mSessionOpen = false;
+    threadClientInfo.mRing = nullptr;
+}
+
+// Write the frame header, for a payload of the given size.
+static void writeFrameHeader(char* buf, uint32_t payloadSize) {
+    buf[0] = (char)WIRE_VERSION_BYTE(WIRE_PROTOCOL_VERSION);
+    memcpy(buf + sizeof(uint8_t), &payloadSize, sizeof(uint32_t));
+}
+
+// Transport control messages carry no payload, apart from the Module ID and Request Type.
+static void encodeControlFrame(char* buf, int8_t requestType) {
+    writeFrameHeader(buf, 2 * sizeof(int8_t));
+    buf[WIRE_FRAME_HEADER_SIZE] = MOD_RESTUNE;
+    buf[WIRE_FRAME_HEADER_SIZE + 1] = requestType;
+}
+
+// Upgrade the newly established connection to a persistent session.
+// If the server declines, it closes the connection, hence the caller needs to reconnect.
+static int8_t openSessionHelper() {
+    char buf[WIRE_FRAME_HEADER_SIZE + 2 * sizeof(int8_t)];
+    encodeControlFrame(buf, REQ_SESSION_OPEN);
+
+    int64_t status = 0;
+    if(RC_IS_OK(threadClientInfo.conn->sendMsg(buf, sizeof(buf))) &&
+       RC_IS_OK(threadClientInfo.conn->readMsg((char*)&status, sizeof(status))) && status == 1) {
+        threadClientInfo.mSessionOpen = true;
+        return 0;
+    }
+
+    return -1;
+}
+
+// Create a Shared Ring, and pass it to the server as the first message on the newly
+// established connection. The connection is upgraded to a persistent session as well.
+// Returns the ring if the server accepted it, nullptr otherwise.
+static std::shared_ptr<SharedRing> openRingHelper(std::shared_ptr<ClientEndpoint> conn, int32_t cqEventFd = -1) {
+    std::shared_ptr<SharedRing> ring = nullptr;
+    try {
+        ring = std::shared_ptr<SharedRing>(new SharedRing());
+    } catch(const std::bad_alloc& e) {
+        return nullptr;
+    }
+
+    if(RC_IS_NOTOK(ring->create(cqEventFd))) {
+        return nullptr;
+    }
+
+    char buf[WIRE_FRAME_HEADER_SIZE + 2 * sizeof(int8_t)];
+    encodeControlFrame(buf, REQ_RING_OPEN);
+
+    int32_t fds[SHARED_RING_FD_COUNT] = {ring->getMemFd(), ring->getSqEventFd(), ring->getCqEventFd()};
+    int64_t status = 0;
+    if(RC_IS_OK(conn->sendMsgWithFds(buf, sizeof(buf), fds, SHARED_RING_FD_COUNT)) &&
+       RC_IS_OK(conn->readMsg((char*)&status, sizeof(status))) && status == 1) {
+        return ring;
+    }
+
+    return nullptr;
+}
+
+// A session established by the thread is reused only as long as it matches the transport
+// mode requested for the process, which may have been changed by another thread since.
+static int8_t isSessionModeCurrent() {
+    if(urmClientInfo.mRingRequested.load()) {
+        return (threadClientInfo.mRing != nullptr);
+    }
+    return urmClientInfo.mPersistent.load() && (threadClientInfo.mRing == nullptr);
+}
+
+static int8_t connectHelper() {
+    if(threadClientInfo.conn == nullptr) {
         return -1;
     }
 
-    // Send the request to URM Server
-    if(RC_IS_NOTOK(urmClientInfo.conn->sendMsg(buf, REQ_BUFFER_SIZE))) {
-        LOGE(FILE_TAG, CONN_SEND_FAIL);
+    if(threadClientInfo.mSessionOpen) {
+        if(isSessionModeCurrent()) {
+            return 0;
+        }
+        closeSessionHelper();
+    }
+
+    if(RC_IS_NOTOK(threadClientInfo.conn->initiateConnection())) {
         return -1;
     }
 
+    if(urmClientInfo.mRingRequested) {
+        threadClientInfo.mRing = openRingHelper(threadClientInfo.conn);
+        if(threadClientInfo.mRing != nullptr) {
+            threadClientInfo.mSessionOpen = true;
+            return 0;
+        }
+
+        LOGW(FILE_TAG, "Shared Ring declined by server, falling back to the socket transport");
+        urmClientInfo.mRingRequested = false;
+        if(RC_IS_NOTOK(threadClientInfo.conn->initiateConnection())) {
+            return -1;
+        }
+    }
+
+    if(urmClientInfo.mPersistent && openSessionHelper() != 0) {
+        LOGW(FILE_TAG, "Persistent session declined by server, using a connection per Request");
+        urmClientInfo.mPersistent = false;
+        if(RC_IS_NOTOK(threadClientInfo.conn->initiateConnection())) {
+            return -1;
+        }
+    }
+
     return 0;
 }
 
+// Submit the Request to the Shared Ring SQ, waiting for a bounded time if it is full.
+static int8_t submitToRingHelper(const char* payload, uint32_t payloadSize) {
+    auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ringSubmitTimeout);
+    while(!threadClientInfo.mRing->submit(payload, payloadSize)) {
+        if(std::chrono::steady_clock::now() >= deadline) {
+            return -1;
+        }
+        // Back off, so that the server gets to drain the SQ (even on a single CPU).
+        std::this_thread::sleep_for(std::chrono::microseconds(50));
+    }
+
+    return 0;
+}
+
+// Send the Request encoded in the frame to the server. Requests which can be answered via a
+// Shared Ring (ringEligible) are submitted to the ring, if one is attached to the session and
+// the Request fits a ring entry. The others are sent over the socket, as a single frame.
+static int8_t sendMsgHelper(int8_t ringEligible = true) {
+    uint32_t payloadSize = batch.getSize();
+    writeFrameHeader(frame.data(), payloadSize);
+
+    // A send failure on an open session indicates that the server has gone away
+    // (for example, it was restarted). In such a case, reconnect and retry once.
+    for(int32_t attempt = 0; attempt < 2; attempt++) {
+        if(connectHelper() != 0) {
+            LOGE(FILE_TAG, CONN_INIT_FAIL);
+            return -1;
+        }
+
+        threadClientInfo.mAwaitingRing = (ringEligible && threadClientInfo.mRing != nullptr &&
+                                       payloadSize <= REQ_BUFFER_SIZE);
+        if(threadClientInfo.mAwaitingRing) {
+            if(submitToRingHelper(frame.data() + WIRE_FRAME_HEADER_SIZE, payloadSize) == 0) {
+                return 0;
+            }
+        } else if(RC_IS_OK(threadClientInfo.conn->sendMsg(frame.data(), WIRE_FRAME_HEADER_SIZE + payloadSize))) {
+            // Send the request to URM Server
+            return 0;
+        }
+
+        if(!threadClientInfo.mSessionOpen) {
+            break;
+        }
+        closeSessionHelper();
+    }
+
+    LOGE(FILE_TAG, CONN_SEND_FAIL);
+    return -1;
+}
+
 static int64_t readHandleHelper() {
     // Get the handle
-    char resultBuf[64] = {0};
-    if(RC_IS_NOTOK(urmClientInfo.conn->readMsg(resultBuf, sizeof(resultBuf)))) {
+    int64_t handleReceived = -1;
+    if(threadClientInfo.mAwaitingRing) {
+        if(!threadClientInfo.mRing->reap(handleReceived, ringReapTimeout)) {
+            closeSessionHelper();
+            return -1;
+        }
+        return handleReceived;
+    }
+
+    if(RC_IS_NOTOK(threadClientInfo.conn->readMsg((char*)&handleReceived, sizeof(handleReceived)))) {
+        if(threadClientInfo.mSessionOpen) {
+            closeSessionHelper();
+        }
         return -1;
     }
 
-    int64_t handleReceived = -1;
-    std::memcpy(&handleReceived, resultBuf, sizeof(handleReceived));
     return handleReceived;
 }
 
@@ -92,6 +315,125 @@ static int32_t getClientTid() {
     return (int32_t)gettid();
 }
 
+static int8_t isTuneRequestSane(int64_t duration, int32_t numRes, SysResource* resourceList) {
+    return !(resourceList == nullptr || numRes <= 0 || duration == 0 || duration < -1);
+}
+
+// Encoding Order:
+// 0. Module ID
+// 1. Request Type
+// 2. Request Handle (applicable for untune and retune requests)
+// 3. Duration
+// 4. Number of Resources
+// 5. Properties
+// 6. PID
+// 7. TID
+// 8. Resource List:
+//      Each resource is encoded as:
+//          8.1 ResCode
+//          8.2 ResInfo
+//          8.3 OptionalInfo
+//          8.4 NumValues
+//          8.5 List of "#NumValues" values.
+static void encodeTuneRequest(FlatBuffEncoder& encoder,
+                              int64_t duration,
+                              int32_t properties,
+                              int32_t numRes,
+                              SysResource* resourceList) {
+    encoder.append<int8_t>(MOD_RESTUNE)
+         .append<int8_t>(REQ_RESOURCE_TUNING)
+         .append<int64_t>(0)
+         .append<int64_t>(duration)
+         .append<int32_t>(VALIDATE_GT(numRes, 0))
+         .append<int32_t>(VALIDATE_GE(properties, 0))
+         .append<int32_t>(getClientPid())
+         .append<int32_t>(getClientTid());
+
+    for(int32_t i = 0; i < numRes; i++) {
+        SysResource resource = SafeDeref((resourceList + i));
+
+        encoder.append<uint32_t>(VALIDATE_GT(resource.mResCode, 0))
+             .append<int32_t>(VALIDATE_GE(resource.mResInfo, 0))
+             .append<int32_t>(VALIDATE_GE(resource.mOptionalInfo, 0))
+             .append<int32_t>(VALIDATE_GT(resource.mNumValues, 0));
+
+        if(resource.mNumValues == 1) {
+            encoder.append<int32_t>(resource.mResValue.value);
+        } else {
+            for(int32_t j = 0; j < resource.mNumValues; j++) {
+                encoder.append<int32_t>(resource.mResValue.values[j]);
+            }
+        }
+    }
+}
+
+// Untune Requests carry only the handle, the remaining fields are placeholders.
+static void encodeUntuneRequest(FlatBuffEncoder& encoder, int64_t handle) {
+    encoder.append<int8_t>(MOD_RESTUNE)
+           .append<int8_t>(REQ_RESOURCE_UNTUNING)
+           .append<int64_t>(handle)
+           .append<int64_t>(-1)
+           .append<int32_t>(0)
+           .append<int32_t>(0)
+           .append<int32_t>(getClientPid())
+           .append<int32_t>(getClientTid());
+}
+
+// Encoding Order:
+// 0. Module ID
+// 1. Request Type (tune or relay)
+// 2. Signal ID
+// 3. Signal Type
+// 4. Request Handle (placeholder)
+// 5. Duration
+// 6. App Name and Scenario, as null terminated strings
+// 7. Number of Args
+// 8. Properties
+// 9. PID
+// 10. TID
+// 11. List of "#NumArgs" Args
+static void encodeSignalRequest(FlatBuffEncoder& encoder,
+                                int8_t requestType,
+                                uint32_t sigId,
+                                uint32_t sigType,
+                                int64_t duration,
+                                int32_t properties,
+                                const char* appName,
+                                const char* scenario,
+                                int32_t numArgs,
+                                uint32_t* list) {
+    encoder.append<int8_t>(MOD_RESTUNE)
+           .append<int8_t>(requestType)
+           .append<uint32_t>(sigId)
+           .append<uint32_t>(sigType)
+           .append<int64_t>(0)
+           .append<int64_t>(duration);
+
+    const char* charIterator = appName;
+    while(*charIterator != '\0') {
+        encoder.append<uint8_t>(*charIterator);
+        charIterator++;
+    }
+
+    encoder.append<uint8_t>('\0');
+
+    charIterator = scenario;
+    while(*charIterator != '\0') {
+        encoder.append<uint8_t>(*charIterator);
+        charIterator++;
+    }
+
+    encoder.append<uint8_t>('\0');
+    encoder.append<int32_t>(VALIDATE_GE(numArgs, 0))
+           .append<int32_t>(VALIDATE_GE(properties, 0))
+           .append<int32_t>(getClientPid())
+           .append<int32_t>(getClientTid());
+
+    for(int32_t i = 0; i < numArgs; i++) {
+        encoder.append<uint32_t>(list[i]);
+    }
+}
+
 // - Construct a Request object and populate it with the API specified Params
 // - Initiate a connection to the URM Server, and send the request to the server
 // - Wait for the response from the server, and return the response to the caller (end-client).
@@ -99,74 +441,90 @@ int64_t tuneResources(int64_t duration,
                       int32_t properties,
                       int32_t numRes,
                       SysResource* resourceList) {
-    // Only one client Thread can send a Request at any moment
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         // Preliminary Tests
         // These are some basic checks done at the Client end itself to detect
         // Potentially Malformed Reqeusts, to prevent wastage of Server-End Resources.
-        if(resourceList == nullptr || numRes <= 0 || duration == 0 || duration < -1) {
+        if(!isTuneRequestSane(duration, numRes, resourceList)) {
             LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        if(numRes > maxResPerReq) {
-            LOGE(FILE_TAG, "Number of Resources in Request exceeds max limit.");
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
+        encodeTuneRequest(batch, duration, properties, numRes, resourceList);
+
+        if(batch.isBufSane()) {
+            if(sendMsgHelper() == 0) return readHandleHelper();
+        } else {
+            LOGE(FILE_TAG, "Request Size exceeds max capacity");
+        }
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+// - Encode all the Requests into a single message, each Request is preceded by its encoded size
+// - Initiate a connection to the URM Server, and send the batch to the server
+// - Wait for the handles of all the Requests, which are sent back in a single response.
+int8_t tuneResourcesBatch(int32_t numRequests, TuneRequestInfo* requestList, int64_t* handles) {
+    try {
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
+
+        if(requestList == nullptr || handles == nullptr ||
+           numRequests <= 0 || numRequests > MAX_TUNE_BATCH_SIZE) {
+            LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        // Encoding Order:
-        // 0. Module ID
-        // 1. Request Type
-        // 2. Request Handle (applicable for untune and retune requests)
-        // 3. Duration
-        // 4. Number of Resources
-        // 5. Properties
-        // 6. PID
-        // 7. TID
-        // 8. Resource List:
-        //      Each resource is encoded as:
-        //          8.1 ResCode
-        //          8.2 ResInfo
-        //          8.3 OptionalInfo
-        //          8.4 NumValues
-        //          8.5 List of "#NumValues" values.
-
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
+        for(int32_t i = 0; i < numRequests; i++) {
+            handles[i] = -1;
+            if(!isTuneRequestSane(requestList[i].mDuration, requestList[i].mNumRes,
+                                  requestList[i].mResourceList)) {
+                LOGE(FILE_TAG, "Invalid Request Params, for Request at index: " + std::to_string(i));
+                return -1;
+            }
+        }
+
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
         batch.append<int8_t>(MOD_RESTUNE)
-             .append<int8_t>(REQ_RESOURCE_TUNING)
-             .append<int64_t>(0)
-             .append<int64_t>(duration)
-             .append<int32_t>(VALIDATE_GT(numRes, 0))
-             .append<int32_t>(VALIDATE_GE(properties, 0))
-             .append<int32_t>(getClientPid())
-             .append<int32_t>(getClientTid());
+             .append<int8_t>(REQ_RESOURCE_TUNING_BATCH)
+             .append<int32_t>(numRequests);
+
+        for(int32_t i = 0; i < numRequests; i++) {
+            // The entry size is patched in, once the Request has been encoded.
+            int32_t sizeOffset = batch.getSize();
+            batch.append<uint32_t>(0);
+            encodeTuneRequest(batch, requestList[i].mDuration, requestList[i].mProperties,
+                              requestList[i].mNumRes, requestList[i].mResourceList);
+
+            if(!batch.isBufSane()) {
+                LOGE(FILE_TAG, "Request Size exceeds max capacity");
+                return -1;
+            }
 
-        for(int32_t i = 0; i < numRes; i++) {
-            SysResource resource = SafeDeref((resourceList + i));
+            uint32_t entrySize = batch.getSize() - sizeOffset - sizeof(uint32_t);
+            memcpy(frame.data() + WIRE_FRAME_HEADER_SIZE + sizeOffset, &entrySize, sizeof(uint32_t));
+        }
 
-            batch.append<uint32_t>(VALIDATE_GT(resource.mResCode, 0))
-                 .append<int32_t>(VALIDATE_GE(resource.mResInfo, 0))
-                 .append<int32_t>(VALIDATE_GE(resource.mOptionalInfo, 0))
-                 .append<int32_t>(VALIDATE_GT(resource.mNumValues, 0));
+        // The handles are not bounded by the size of a ring completion,
+        // hence the batch is always sent over the socket.
+        if(sendMsgHelper(false) != 0) {
+            return -1;
+        }
 
-            if(resource.mNumValues == 1) {
-                batch.append<int32_t>(resource.mResValue.value);
-            } else {
-                for(int32_t j = 0; j < resource.mNumValues; j++) {
-                    batch.append<int32_t>(resource.mResValue.values[j]);
-                }
+        if(RC_IS_NOTOK(threadClientInfo.conn->readMsgFully((char*)handles, numRequests * sizeof(int64_t)))) {
+            if(threadClientInfo.mSessionOpen) {
+                closeSessionHelper();
             }
+            return -1;
         }
 
-        if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return readHandleHelper();
-        } else {
-            LOGE(FILE_TAG, "Request Size exceeds max capacity");
-        }
+        return 0;
 
     } catch(const std::exception& e) {
         LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
@@ -179,16 +537,14 @@ int64_t tuneResources(int64_t duration,
 // - Initiate a connection to the URM Server, and send the request to the server
 int8_t retuneResources(int64_t handle, int64_t duration) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         if(handle <= 0 || duration == 0 || duration < -1) {
             LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
         batch.append<int8_t>(MOD_RESTUNE)
              .append<int8_t>(REQ_RESOURCE_RETUNING)
              .append<int64_t>(handle)
@@ -199,7 +555,7 @@ int8_t retuneResources(int64_t handle, int64_t duration) {
              .append<int32_t>(getClientTid());
 
         if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return 0;
+            if(sendMsgHelper() == 0) return 0;
         } else {
             LOGE(FILE_TAG, "Malformed Request");
         }
@@ -215,27 +571,18 @@ int8_t retuneResources(int64_t handle, int64_t duration) {
 // - Initiate a connection to the URM Server, and send the request to the server
 int8_t untuneResources(int64_t handle) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         if(handle <= 0) {
             LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
-        batch.append<int8_t>(MOD_RESTUNE)
-             .append<int8_t>(REQ_RESOURCE_UNTUNING)
-             .append<int64_t>(handle)
-             .append<int64_t>(-1)
-             .append<int32_t>(0)
-             .append<int32_t>(0)
-             .append<int32_t>(getClientPid())
-             .append<int32_t>(getClientTid());
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
+        encodeUntuneRequest(batch, handle);
 
         if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return 0;
+            if(sendMsgHelper() == 0) return 0;
         } else {
             LOGE(FILE_TAG, "Malformed Request");
         }
@@ -252,16 +599,14 @@ int8_t untuneResources(int64_t handle) {
 // - Wait for the response from the server, and return the response to the caller (end-client).
 int8_t getProp(const char* prop, char* buffer, size_t bufferSize, const char* defValue) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         if(prop == nullptr || buffer == nullptr) {
             LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
         batch.append<int8_t>(MOD_RESTUNE)
              .append<int8_t>(REQ_PROP_GET)
              .append<uint64_t>(bufferSize);
@@ -278,20 +623,19 @@ int8_t getProp(const char* prop, char* buffer, size_t bufferSize, const char* de
             return -1;
         }
 
-        if(urmClientInfo.conn == nullptr || RC_IS_NOTOK(urmClientInfo.conn->initiateConnection())) {
-            LOGE(FILE_TAG, CONN_INIT_FAIL);
-            return -1;
-        }
-
-        if(RC_IS_NOTOK(urmClientInfo.conn->sendMsg(buf, sizeof(buf)))) {
-            LOGE(FILE_TAG, CONN_SEND_FAIL);
+        // Property values are not bounded by the size of a ring completion,
+        // hence the Request is always sent over the socket.
+        if(sendMsgHelper(false) != 0) {
             return -1;
         }
 
         // read the response
         char resultBuf[bufferSize];
         memset(resultBuf, 0, sizeof(resultBuf));
-        if(RC_IS_NOTOK(urmClientInfo.conn->readMsg(resultBuf, sizeof(resultBuf)))) {
+        if(RC_IS_NOTOK(threadClientInfo.conn->readMsg(resultBuf, sizeof(resultBuf)))) {
+            if(threadClientInfo.mSessionOpen) {
+                closeSessionHelper();
+            }
             return -1;
         }
 
@@ -328,8 +672,7 @@ int64_t tuneSignal(uint32_t sigId,
                    int32_t numArgs,
                    uint32_t* list) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         // Duration == 0 is a placeholder for default signal-config specified duration
         if(duration < -1 || numArgs < 0 || (list != nullptr && numArgs == 0)) {
@@ -337,41 +680,12 @@ int64_t tuneSignal(uint32_t sigId,
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
-        batch.append<int8_t>(MOD_RESTUNE)
-             .append<int8_t>(REQ_SIGNAL_TUNING)
-             .append<uint32_t>(sigId)
-             .append<uint32_t>(sigType)
-             .append<int64_t>(0)
-             .append<int64_t>(duration);
-
-        const char* charIterator = appName;
-        while(*charIterator != '\0') {
-            batch.append<uint8_t>(*charIterator);
-            charIterator++;
-        }
-
-        batch.append<uint8_t>('\0');
-
-        charIterator = scenario;
-        while(*charIterator != '\0') {
-            batch.append<uint8_t>(*charIterator);
-            charIterator++;
-        }
-
-        batch.append<uint8_t>('\0');
-        batch.append<int32_t>(VALIDATE_GE(numArgs, 0))
-             .append<int32_t>(VALIDATE_GE(properties, 0))
-             .append<int32_t>(getClientPid())
-             .append<int32_t>(getClientTid());
-
-        for(int32_t i = 0; i < numArgs; i++) {
-            batch.append<uint32_t>(list[i]);
-        }
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
+        encodeSignalRequest(batch, REQ_SIGNAL_TUNING, sigId, sigType, duration, properties,
+                            appName, scenario, numArgs, list);
 
         if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return readHandleHelper();
+            if(sendMsgHelper() == 0) return readHandleHelper();
         } else {
             LOGE(FILE_TAG, "Request Size exceeds max capacity");
         }
@@ -387,16 +701,14 @@ int64_t tuneSignal(uint32_t sigId,
 // - Initiate a connection to the URM Server, and send the request to the server
 int8_t untuneSignal(int64_t handle) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         if(handle <= 0) {
             LOGE(FILE_TAG, "Invalid Request Params");
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
         batch.append<int8_t>(MOD_RESTUNE)
              .append<int8_t>(REQ_SIGNAL_UNTUNING)
              .append<uint32_t>(0)
@@ -412,7 +724,7 @@ int8_t untuneSignal(int64_t handle) {
 
 
         if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return 0;
+            if(sendMsgHelper() == 0) return 0;
         } else {
             LOGE(FILE_TAG, "Malformed Request");
         }
@@ -435,8 +747,7 @@ int8_t relaySignal(uint32_t sigId,
                    int32_t numArgs,
                    uint32_t* list) {
     try {
-        const std::lock_guard<std::mutex> lock(apiLock);
-        const ConnectionManager connMgr(urmClientInfo.conn);
+        const ConnectionManager connMgr(threadClientInfo.conn, &threadClientInfo.mSessionOpen);
 
         // Duration == 0 is a placeholder for default signal-config specified duration
         if(duration < -1 || numArgs < 0 || (list != nullptr && numArgs == 0)) {
@@ -444,45 +755,337 @@ int8_t relaySignal(uint32_t sigId,
             return -1;
         }
 
-        char buf[REQ_BUFFER_SIZE] = {0};
-        batch.setBuf(buf);
-        batch.append<int8_t>(MOD_RESTUNE)
-             .append<int8_t>(REQ_SIGNAL_RELAY)
-             .append<uint32_t>(sigId)
-             .append<uint32_t>(sigType)
-             .append<int64_t>(0)
-             .append<int64_t>(duration);
+        batch.setStorage(&frame, WIRE_FRAME_HEADER_SIZE);
+        encodeSignalRequest(batch, REQ_SIGNAL_RELAY, sigId, sigType, duration, properties,
+                            appName, scenario, numArgs, list);
 
-        const char* charIterator = appName;
-        while(*charIterator != '\0') {
-            batch.append<uint8_t>(*charIterator);
-            charIterator++;
+        if(batch.isBufSane()) {
+            if(sendMsgHelper() == 0) return 0;
+        } else {
+            LOGE(FILE_TAG, "Request Size exceeds max capacity");
         }
 
-        batch.append<uint8_t>('\0');
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
 
-        charIterator = scenario;
-        while(*charIterator != '\0') {
-            batch.append<uint8_t>(*charIterator);
-            charIterator++;
+    return -1;
+}
+
+int8_t setPersistentSession(int8_t enable) {
+    try {
+        if(threadClientInfo.conn == nullptr) {
+            LOGE(FILE_TAG, CONN_INIT_FAIL);
+            return -1;
         }
 
-        batch.append<uint8_t>('\0');
-        batch.append<int32_t>(VALIDATE_GE(numArgs, 0))
-             .append<int32_t>(VALIDATE_GE(properties, 0))
-             .append<int32_t>(getClientPid())
-             .append<int32_t>(getClientTid());
+        // The sessions held by the other threads are closed (or re-established),
+        // on their next Request.
+        urmClientInfo.mPersistent = (enable != 0);
+        if(threadClientInfo.mSessionOpen && !isSessionModeCurrent()) {
+            closeSessionHelper();
+        }
+
+        return 0;
 
-        for(int32_t i = 0; i < numArgs; i++) {
-            batch.append<uint32_t>(list[i]);
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+int8_t setRingTransport(int8_t enable) {
+    try {
+        if(threadClientInfo.conn == nullptr) {
+            LOGE(FILE_TAG, CONN_INIT_FAIL);
+            return -1;
         }
 
-        if(batch.isBufSane()) {
-            if(sendMsgHelper(buf) == 0) return 0;
-        } else {
-            LOGE(FILE_TAG, "Request Size exceeds max capacity");
+        // Any existing session is closed, so that the next Request establishes a session with
+        // (or without) the ring attached. The other threads do the same, on their next Request.
+        urmClientInfo.mRingRequested = (enable != 0);
+        if(threadClientInfo.mSessionOpen && !isSessionModeCurrent()) {
+            closeSessionHelper();
+        }
+
+        return 0;
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+// Make the completion fd readable, for the completions generated on the client side.
+static void signalCompletionHelper() {
+    uint64_t count = 1;
+    if(write(asyncClientInfo.mCompletionFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        LOGE(FILE_TAG, "Failed to signal the completion fd");
+    }
+}
+
+static int8_t initCompletionFdHelper() {
+    if(asyncClientInfo.mCompletionFd < 0) {
+        asyncClientInfo.mCompletionFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+    return (asyncClientInfo.mCompletionFd >= 0);
+}
+
+// Tear down the async session. The Requests still waiting for a CQ entry will never
+// receive one, hence they are completed with a failure status.
+static void closeAsyncSessionHelper() {
+    while(!asyncClientInfo.mAwaitingCq.empty()) {
+        UrmCompletion completion;
+        completion.mTicket = asyncClientInfo.mAwaitingCq.front();
+        completion.mHandle = -1;
+        completion.mStatus = -1;
+        asyncClientInfo.mCompleted.push_back(completion);
+        asyncClientInfo.mAwaitingCq.pop_front();
+    }
+    if(!asyncClientInfo.mCompleted.empty()) {
+        signalCompletionHelper();
+    }
+
+    asyncClientInfo.mRing = nullptr;
+    if(asyncClientInfo.mConn != nullptr) {
+        asyncClientInfo.mConn->closeConnection();
+    }
+}
+
+// Establish the async session if there is none, or if the server has gone away.
+static int8_t asyncConnectHelper() {
+    if(!initCompletionFdHelper()) {
+        LOGE(FILE_TAG, "Failed to create the completion fd");
+        return -1;
+    }
+
+    if(asyncClientInfo.mConn == nullptr) {
+        try {
+            asyncClientInfo.mConn = std::shared_ptr<SocketClient>(new SocketClient());
+        } catch(const std::bad_alloc& e) {
+            return -1;
+        }
+    }
+
+    if(asyncClientInfo.mRing != nullptr) {
+        if(!asyncClientInfo.mConn->isPeerClosed()) {
+            return 0;
+        }
+        closeAsyncSessionHelper();
+    }
+
+    if(RC_IS_NOTOK(asyncClientInfo.mConn->initiateConnection())) {
+        return -1;
+    }
+
+    asyncClientInfo.mRing = openRingHelper(asyncClientInfo.mConn, asyncClientInfo.mCompletionFd);
+    if(asyncClientInfo.mRing == nullptr) {
+        LOGE(FILE_TAG, "Shared Ring declined by server, async APIs are unavailable");
+        asyncClientInfo.mConn->closeConnection();
+        return -1;
+    }
+
+    // The server rings the doorbell only if the client is waiting,
+    // hence the wait is announced right away.
+    asyncClientInfo.mRing->prepareCqWait();
+    return 0;
+}
+
+// Submit the Request encoded via the async encoder to the ring, and return its ticket.
+// Requests which do not expect a response from the server are completed right away.
+static int64_t asyncSubmitHelper(int8_t expectsResponse, int64_t handle) {
+    if(!asyncClientInfo.mEncoder.isBufSane() || asyncClientInfo.mEncoder.getSize() > REQ_BUFFER_SIZE) {
+        LOGE(FILE_TAG, "Request Size exceeds max capacity of a Shared Ring entry");
+        return -1;
+    }
+
+    if(asyncConnectHelper() != 0) {
+        LOGE(FILE_TAG, CONN_INIT_FAIL);
+        return -1;
+    }
+
+    // A CQ entry is reserved for each outstanding Request, since the server
+    // drops the response if the CQ is full.
+    if(expectsResponse && asyncClientInfo.mAwaitingCq.size() >= SHARED_RING_ENTRIES) {
+        LOGW(FILE_TAG, "Too many outstanding async Requests, reap the completions first");
+        return -1;
+    }
+
+    if(!asyncClientInfo.mRing->submit(asyncClientInfo.mFrame.data(), asyncClientInfo.mEncoder.getSize())) {
+        LOGW(FILE_TAG, "Shared Ring SQ full, Request not submitted");
+        return -1;
+    }
+
+    int64_t ticket = asyncClientInfo.mNextTicket++;
+    if(expectsResponse) {
+        asyncClientInfo.mAwaitingCq.push_back(ticket);
+    } else {
+        UrmCompletion completion;
+        completion.mTicket = ticket;
+        completion.mHandle = handle;
+        completion.mStatus = 0;
+        asyncClientInfo.mCompleted.push_back(completion);
+        signalCompletionHelper();
+    }
+
+    return ticket;
+}
+
+int32_t urmGetCompletionFd() {
+    try {
+        const std::lock_guard<std::mutex> lock(asyncLock);
+        if(!initCompletionFdHelper()) {
+            LOGE(FILE_TAG, "Failed to create the completion fd");
+            return -1;
+        }
+        return asyncClientInfo.mCompletionFd;
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+int64_t tuneResourcesAsync(int64_t duration,
+                           int32_t properties,
+                           int32_t numRes,
+                           SysResource* resourceList) {
+    try {
+        const std::lock_guard<std::mutex> lock(asyncLock);
+
+        if(!isTuneRequestSane(duration, numRes, resourceList)) {
+            LOGE(FILE_TAG, "Invalid Request Params");
+            return -1;
+        }
+
+        asyncClientInfo.mEncoder.setStorage(&asyncClientInfo.mFrame, 0);
+        encodeTuneRequest(asyncClientInfo.mEncoder, duration, properties, numRes, resourceList);
+        return asyncSubmitHelper(true, -1);
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+int64_t untuneResourcesAsync(int64_t handle) {
+    try {
+        const std::lock_guard<std::mutex> lock(asyncLock);
+
+        if(handle <= 0) {
+            LOGE(FILE_TAG, "Invalid Request Params");
+            return -1;
+        }
+
+        asyncClientInfo.mEncoder.setStorage(&asyncClientInfo.mFrame, 0);
+        encodeUntuneRequest(asyncClientInfo.mEncoder, handle);
+        return asyncSubmitHelper(false, handle);
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+int64_t tuneSignalAsync(uint32_t sigId,
+                        uint32_t sigType,
+                        int64_t duration,
+                        int32_t properties,
+                        const char* appName,
+                        const char* scenario,
+                        int32_t numArgs,
+                        uint32_t* list) {
+    try {
+        const std::lock_guard<std::mutex> lock(asyncLock);
+
+        // Duration == 0 is a placeholder for default signal-config specified duration
+        if(duration < -1 || numArgs < 0 || (list != nullptr && numArgs == 0)) {
+            LOGE(FILE_TAG, "Invalid Request Params");
+            return -1;
         }
 
+        asyncClientInfo.mEncoder.setStorage(&asyncClientInfo.mFrame, 0);
+        encodeSignalRequest(asyncClientInfo.mEncoder, REQ_SIGNAL_TUNING, sigId, sigType, duration,
+                            properties, appName, scenario, numArgs, list);
+        return asyncSubmitHelper(true, -1);
+
+    } catch(const std::exception& e) {
+        LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
+    }
+
+    return -1;
+}
+
+// Completions are reaped in the order: the ones generated locally, followed by the ones posted
+// to the CQ. The CQ wait is announced again only once the CQ has been drained, so that the
+// completion fd is readable whenever a completion is pending.
+int32_t urmReapCompletions(UrmCompletion* completions, int32_t maxCompletions) {
+    try {
+        const std::lock_guard<std::mutex> lock(asyncLock);
+
+        if(completions == nullptr || maxCompletions <= 0) {
+            LOGE(FILE_TAG, "Invalid Request Params");
+            return -1;
+        }
+
+        if(asyncClientInfo.mCompletionFd < 0) {
+            return 0;
+        }
+
+        uint64_t count = 0;
+        if(read(asyncClientInfo.mCompletionFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+            LOGE(FILE_TAG, "Failed to read the completion fd");
+        }
+
+        int32_t numReaped = 0;
+        while(true) {
+            while(numReaped < maxCompletions && !asyncClientInfo.mCompleted.empty()) {
+                completions[numReaped++] = asyncClientInfo.mCompleted.front();
+                asyncClientInfo.mCompleted.pop_front();
+            }
+
+            int64_t result = -1;
+            while(numReaped < maxCompletions && asyncClientInfo.mRing != nullptr &&
+                  asyncClientInfo.mRing->tryReap(result)) {
+                if(asyncClientInfo.mAwaitingCq.empty()) {
+                    LOGW(FILE_TAG, "Unexpected Shared Ring completion, dropping it");
+                    continue;
+                }
+
+                UrmCompletion& completion = completions[numReaped++];
+                completion.mTicket = asyncClientInfo.mAwaitingCq.front();
+                completion.mHandle = result;
+                completion.mStatus = (result > 0) ? 0 : -1;
+                asyncClientInfo.mAwaitingCq.pop_front();
+            }
+
+            if(numReaped == maxCompletions) {
+                // More completions may be pending, keep the fd readable.
+                signalCompletionHelper();
+                break;
+            }
+
+            if(asyncClientInfo.mRing == nullptr) {
+                break;
+            }
+
+            if(!asyncClientInfo.mAwaitingCq.empty() && asyncClientInfo.mConn->isPeerClosed()) {
+                closeAsyncSessionHelper();
+                continue;
+            }
+
+            if(asyncClientInfo.mRing->prepareCqWait()) {
+                break;
+            }
+        }
+
+        return numReaped;
+
     } catch(const std::exception& e) {
         LOGE(FILE_TAG, REQ_SEND_ERR(e.what()));
     }
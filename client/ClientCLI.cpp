@@ -126,6 +126,67 @@ void sendTuneRequest(int64_t duration, int32_t priority, int32_t count, const st
     }
 }
 
+// Each Request in the batch is specified as: "<duration>|<priority>|<resources>",
+// where resources follows the same format as a regular tune Request.
+void sendTuneBatchRequest(const std::vector<std::string>& requestSpecs) {
+    int32_t numRequests = requestSpecs.size();
+    if(numRequests == 0) {
+        std::cout<<"No Requests specified for the batch"<<std::endl;
+        return;
+    }
+
+    std::vector<std::vector<std::pair<uint32_t, std::pair<int32_t, std::vector<int32_t>>>>> resourceVecs(numRequests);
+    std::vector<std::vector<SysResource>> resourceLists(numRequests);
+    std::vector<TuneRequestInfo> requestList(numRequests);
+
+    for(int32_t i = 0; i < numRequests; i++) {
+        std::vector<std::string> fields;
+        std::istringstream specStream(requestSpecs[i]);
+        std::string field;
+        while(std::getline(specStream, field, '|')) {
+            fields.push_back(field);
+        }
+
+        if(fields.size() != 3 || parseResources(fields[2], resourceVecs[i]) == -1 || resourceVecs[i].empty()) {
+            std::cout<<"Failed to parse Request: "<<requestSpecs[i]<<std::endl;
+            return;
+        }
+
+        int32_t priority = std::stoi(fields[1]);
+        priority = (priority < REQ_PRIORITY_HIGH) ? REQ_PRIORITY_HIGH : priority;
+        priority = (priority > REQ_PRIORITY_LOW) ? REQ_PRIORITY_LOW : priority;
+
+        for(auto& entry: resourceVecs[i]) {
+            SysResource resource;
+            memset(&resource, 0, sizeof(SysResource));
+            resource.mResCode = entry.first;
+            resource.mResInfo = entry.second.first;
+            resource.mNumValues = entry.second.second.size();
+            if(resource.mNumValues == 1) {
+                resource.mResValue.value = entry.second.second[0];
+            } else {
+                resource.mResValue.values = entry.second.second.data();
+            }
+            resourceLists[i].push_back(resource);
+        }
+
+        requestList[i].mDuration = std::stoll(fields[0]);
+        requestList[i].mProperties = priority;
+        requestList[i].mNumRes = resourceLists[i].size();
+        requestList[i].mResourceList = resourceLists[i].data();
+    }
+
+    std::vector<int64_t> handles(numRequests, -1);
+    if(tuneResourcesBatch(numRequests, requestList.data(), handles.data()) != 0) {
+        std::cout<<"Failed to send Tune Batch Request"<<std::endl;
+        return;
+    }
+
+    for(int32_t i = 0; i < numRequests; i++) {
+        std::cout<<"Handle Received from Server for Request ["<<i<<"] is: "<<handles[i]<<std::endl;
+    }
+}
+
 void sendRetuneRequest(int64_t handle, int64_t duration) {
     int8_t status = retuneResources(handle, duration);
     if(status == 0) {
@@ -293,7 +354,7 @@ static void startPersistentMode() {
 }
 
 int32_t main(int32_t argc, char* argv[]) {
-    const char* shortPrompts = "turd:p:l:n:h:s:gk:qm:";
+    const char* shortPrompts = "turd:p:l:n:h:s:gk:qm:be:";
     const struct option longPrompts[] = {
         {"tune", no_argument, nullptr, 't'},
         {"untune", no_argument, nullptr, 'u'},
@@ -309,6 +370,8 @@ int32_t main(int32_t argc, char* argv[]) {
         {"signal", no_argument, nullptr, 'q'},
         {"untuneSignal", no_argument, nullptr, 'x'},
         {"scode", required_argument, nullptr, 'm'},
+        {"tuneBatch", no_argument, nullptr, 'b'},
+        {"req", required_argument, nullptr, 'e'},
         {nullptr, no_argument, nullptr, 0}
     };
 
@@ -322,6 +385,7 @@ int32_t main(int32_t argc, char* argv[]) {
     const char* resources = nullptr;
     const char* propKey = nullptr;
     const char* sigCode = nullptr;
+    std::vector<std::string> batchRequests;
     int8_t persistent = false;
 
     while((c = getopt_long(argc, argv, shortPrompts, longPrompts, nullptr)) != -1) {
@@ -368,6 +432,12 @@ int32_t main(int32_t argc, char* argv[]) {
             case 'm':
                 sigCode = optarg;
                 break;
+            case 'b':
+                requestType = REQ_RESOURCE_TUNING_BATCH;
+                break;
+            case 'e':
+                batchRequests.push_back(optarg);
+                break;
             default:
                 break;
         }
@@ -393,6 +463,16 @@ int32_t main(int32_t argc, char* argv[]) {
             }
             break;
 
+        case REQ_RESOURCE_TUNING_BATCH:
+            if(batchRequests.empty()) {
+                std::cout<<"Invalid Params for Tune Batch Request"<<std::endl;
+                std::cout<<"Usage: --tuneBatch --req \"<duration>|<priority>|<resources>\" [--req ...]"<<std::endl;
+                std::cout<<"Example: --tuneBatch --req \"5000|0|0x00030000:700\" --req \"-1|1|0x00040000#0x00000100:1620438\""<<std::endl;
+                break;
+            }
+            sendTuneBatchRequest(batchRequests);
+            break;
+
         case REQ_RESOURCE_RETUNING:
             if(duration == 0 || duration < -1 || handle <= 0) {
                 std::cout<<"Invalid Params for Retune Request"<<std::endl;
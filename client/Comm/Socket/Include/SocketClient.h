@@ -4,6 +4,7 @@
 #ifndef RESOURCE_TUNER_SOCKET_CLIENT_H
 #define RESOURCE_TUNER_SOCKET_CLIENT_H
 
+#include <poll.h>
 #include <unistd.h>
 #include <sys/socket.h>
 #include <sys/un.h>
@@ -18,6 +19,9 @@
 
 #define RESTUNE_SOCKET_PATH "/run/restune_sock"
 
+// Max number of fds which can be passed along with a single message.
+#define MAX_PASSED_FDS 4
+
 class SocketClient : public ClientEndpoint {
 private:
     int32_t sockFd;
@@ -28,7 +32,10 @@ public:
 
     virtual int32_t initiateConnection();
     virtual int32_t sendMsg(char* buf, size_t bufSize);
+    virtual int32_t sendMsgWithFds(char* buf, size_t bufSize, int32_t* fds, int32_t fdCount);
     virtual int32_t readMsg(char* buf, size_t bufSize);
+    virtual int32_t readMsgFully(char* buf, size_t bufSize);
+    virtual int8_t isPeerClosed();
     virtual int32_t closeConnection();
 };
 
@@ -12,6 +12,8 @@ SocketClient::SocketClient() {
 }
 
 int32_t SocketClient::initiateConnection() {
+    this->closeConnection();
+
     if((this->sockFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
         TYPELOGV(ERRNO_LOG, "socket", strerror(errno));
         return RC_SOCKET_CONN_NOT_INITIALIZED;
@@ -41,8 +43,43 @@ int32_t SocketClient::initiateConnection() {
 int32_t SocketClient::sendMsg(char* buf, size_t bufSize) {
     if(buf == nullptr) return RC_BAD_ARG;
 
-    if(write(this->sockFd, buf, bufSize) == -1) {
-        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+    // MSG_NOSIGNAL: A server side close must not raise SIGPIPE in the client process.
+    if(send(this->sockFd, buf, bufSize, MSG_NOSIGNAL) == -1) {
+        TYPELOGV(ERRNO_LOG, "send", strerror(errno));
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    return RC_SUCCESS;
+}
+
+// Send the message along with the given fds, passed as SCM_RIGHTS ancillary data.
+int32_t SocketClient::sendMsgWithFds(char* buf, size_t bufSize, int32_t* fds, int32_t fdCount) {
+    if(buf == nullptr || fds == nullptr || fdCount <= 0 || fdCount > MAX_PASSED_FDS) {
+        return RC_BAD_ARG;
+    }
+
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = bufSize;
+
+    char control[CMSG_SPACE(MAX_PASSED_FDS * sizeof(int32_t))];
+    memset(control, 0, sizeof(control));
+
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = CMSG_SPACE(fdCount * sizeof(int32_t));
+
+    struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(fdCount * sizeof(int32_t));
+    std::memcpy(CMSG_DATA(cmsg), fds, fdCount * sizeof(int32_t));
+
+    if(sendmsg(this->sockFd, &msg, MSG_NOSIGNAL) == -1) {
+        TYPELOGV(ERRNO_LOG, "sendmsg", strerror(errno));
         return RC_SOCKET_FD_WRITE_FAILURE;
     }
 
@@ -60,12 +97,54 @@ int32_t SocketClient::readMsg(char* buf, size_t bufSize) {
         return RC_SOCKET_FD_READ_FAILURE;
     }
 
+    if(statusCode == 0) {
+        // Connection closed by the server without a response.
+        return RC_SOCKET_FD_READ_FAILURE;
+    }
+
     return RC_SUCCESS;
 }
 
+int32_t SocketClient::readMsgFully(char* buf, size_t bufSize) {
+    if(buf == nullptr || bufSize == 0) {
+        return RC_BAD_ARG;
+    }
+
+    ssize_t bytesRead = recv(this->sockFd, buf, bufSize, MSG_WAITALL);
+    if(bytesRead < 0) {
+        TYPELOGV(ERRNO_LOG, "recv", strerror(errno));
+        return RC_SOCKET_FD_READ_FAILURE;
+    }
+
+    if(bytesRead != (ssize_t)bufSize) {
+        // Connection closed by the server before the complete response was sent.
+        return RC_SOCKET_FD_READ_FAILURE;
+    }
+
+    return RC_SUCCESS;
+}
+
+int8_t SocketClient::isPeerClosed() {
+    if(this->sockFd == -1) {
+        return true;
+    }
+
+    struct pollfd pollInfo;
+    pollInfo.fd = this->sockFd;
+    pollInfo.events = POLLRDHUP;
+    pollInfo.revents = 0;
+    if(poll(&pollInfo, 1, 0) < 0) {
+        return false;
+    }
+
+    return (pollInfo.revents & (POLLRDHUP | POLLHUP | POLLERR)) != 0;
+}
+
 int32_t SocketClient::closeConnection() {
     if(this->sockFd != -1) {
-        return close(this->sockFd);
+        int32_t statusCode = close(this->sockFd);
+        this->sockFd = -1;
+        return statusCode;
     }
     return RC_SOCKET_FD_CLOSE_FAILURE;
 }
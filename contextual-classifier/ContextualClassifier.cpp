@@ -168,6 +168,7 @@ ErrCode ContextualClassifier::Terminate() {
 
 void ContextualClassifier::ClassifierMain() {
     pthread_setname_np(pthread_self(), "urmClassifier");
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_CLASSIFIER);
     while (true) {
         ProcEvent ev{};
 
@@ -301,6 +302,7 @@ void ContextualClassifier::ClassifierMain() {
 
 int32_t ContextualClassifier::HandleProcEv() {
     pthread_setname_np(pthread_self(), "urmNetlinkListener");
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_CLASSIFIER);
     int32_t rc = 0;
 
     while(!this->mNeedExit) {
@@ -84,6 +84,9 @@ public:
  * \param resourceApplierCallback A function Pointer to the Custom Applier Callback.
  *
  * \note This macro must be used in the Global Scope.
+ * \note If resource_tuner.applier.shards is more than 1, the callback is invoked on an Applier
+ *       Shard thread. All the custom Applier and Tear callbacks are invoked on the same thread
+ *       in order, however concurrently with the default callbacks of the other Resources.
  */
 #define URM_REGISTER_RES_APPLIER_CB(resCode, resourceApplierCallback) \
         static Extensions CONCAT(_resourceApplier, resCode)(resCode, 0, resourceApplierCallback);
@@ -95,6 +98,7 @@ public:
  * \param resourceTearCallback A function Pointer to the Custom Teardown Callback.
  *
  * \note This macro must be used in the Global Scope.
+ * \note See URM_REGISTER_RES_APPLIER_CB, for the thread the callback is invoked on.
  */
 #define URM_REGISTER_RES_TEAR_CB(resCode, resourceTearCallback) \
         static Extensions CONCAT(_resourceTear, resCode)(resCode, 1, resourceTearCallback);
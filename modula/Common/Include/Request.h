@@ -15,7 +15,6 @@
 #include "DLManager.h"
 
 #define REQUEST_DL_NR 0
-#define COCO_TABLE_DL_NR 1
 
 /**
  * @brief Encapsulation type for a Resource Provisioning Request.
@@ -38,7 +37,7 @@ public:
     void unsetTimer();
     void clearResources();
 
-    ErrCode deserialize(char* buf);
+    ErrCode deserialize(char* buf, uint64_t bufSize);
 
     void populateUntuneRequest(Request* request);
     void populateRetuneRequest(Request* request, int64_t duration);
@@ -68,6 +68,17 @@ public:
     ErrCode setValueAt(int32_t index, int32_t value);
 };
 
-typedef ExtIterable1<Resource*> ResIterable;
+/**
+ * @brief Node wrapping a Resource, linked into the Resource list of its Request, and
+ *        tracked by the CocoTable slot (see CocoSlot) the Resource is inserted into.
+ */
+class ResIterable final : public Iterable<Resource*> {
+public:
+    int32_t mSlotPos; //!< Position in the CocoSlot heap, -1 if not part of any slot.
+    int64_t mSlotKey; //!< Ordering key within the slot, derived from the Resource Policy.
+    uint64_t mSlotSeq; //!< Insertion order within the slot, used for breaking ties.
+
+    ResIterable() : mSlotPos(-1), mSlotKey(0), mSlotSeq(0) {}
+};
 
 #endif
@@ -44,7 +44,7 @@ public:
     void setList(std::vector<uint32_t>* mListArgs);
 
     ErrCode serialize(char* buf);
-    ErrCode deserialize(char* buf);
+    ErrCode deserialize(char* buf, uint64_t bufSize);
 
     static void cleanUpSignal(Signal* signal);
 };
@@ -32,7 +32,10 @@ enum RequestType : int8_t {
     REQ_PROP_GET,
     REQ_SIGNAL_TUNING,
     REQ_SIGNAL_UNTUNING,
-    REQ_SIGNAL_RELAY
+    REQ_SIGNAL_RELAY,
+    REQ_SESSION_OPEN, //!< Transport control, upgrades the connection to a persistent session.
+    REQ_RING_OPEN, //!< Transport control, attaches a Shared Ring to a persistent session.
+    REQ_RESOURCE_TUNING_BATCH, //!< Multiple independent Tune Requests, carried in a single message.
 };
 
 /**
@@ -75,6 +78,36 @@ enum Policy {
     PASS_THROUGH_APPEND, //!< Request Ordering is immaterial, however multiple values can co-exist
 };
 
+/**
+ * @enum TaskLane
+ * @brief Priority Lanes for the tasks submitted to the ThreadPool.
+ */
+enum TaskLane {
+    TASK_LANE_CRITICAL, //!< Latency critical tasks, for example: High priority Signals.
+    TASK_LANE_HIGH,
+    TASK_LANE_NORMAL, //!< Default Lane
+    TOTAL_TASK_LANES
+};
+
+enum TaskLanePolicy {
+    TASK_LANE_STRICT, //!< A task is picked from a Lane only if all the higher Lanes are empty.
+    TASK_LANE_WEIGHTED, //!< Lanes are served in proportion to their weights, no Lane is starved.
+};
+
+/**
+ * @enum ThreadClass
+ * @brief Classes of daemon-internal threads, which can be assigned a CPU set
+ *        and scheduling attributes via InitConfig.yaml.
+ */
+enum ThreadClass {
+    THREAD_CLASS_LISTENER, //!< Socket listener thread
+    THREAD_CLASS_CONSUMER, //!< RequestQueue consumer thread
+    THREAD_CLASS_WORKER, //!< ThreadPool workers
+    THREAD_CLASS_TIMER, //!< TimerWheel expiry thread
+    THREAD_CLASS_CLASSIFIER, //!< Contextual classifier threads
+    TOTAL_THREAD_CLASSES
+};
+
 enum TranslationUnit {
     U_NA = 1,
     U_BYTE = 1,
@@ -112,6 +145,8 @@ typedef struct {
 // Global Typedefs: Declare Function Pointers as types
 typedef ErrCode (*EventCallback)(void*);
 typedef int8_t (*ServerOnlineCheckCallback)();
+// The message is only valid for the duration of the callback, i.e. its buffer is owned by the
+// caller. A message which needs to outlive the callback must be copied (cloneMsgForwardInfo).
 typedef void (*MessageReceivedCallback)(int32_t, MsgForwardInfo*);
 
 #define HIGH_TRANSFER_PRIORITY -1
@@ -133,6 +168,20 @@ typedef void (*MessageReceivedCallback)(int32_t, MsgForwardInfo*);
 #define LOGGER_LOGGING_OUTPUT_REDIRECT "urm.logging.redirect_to"
 #define URM_MAX_PLUGIN_COUNT "urm.extensions_lib.count"
 #define CLASSIFIER_APPLY_MODE "urm.classifier.apply_mode"
+#define EXPIRY_BATCHING "resource_tuner.expiry.batching"
+#define REQUEST_QUEUE_MODE "resource_tuner.request_queue.mode"
+#define REQUEST_QUEUE_BATCH_SIZE "resource_tuner.request_queue.batch_size"
+#define THREAD_POOL_MODE "resource_tuner.thread_pool.mode"
+#define THREAD_POOL_LANE_POLICY "resource_tuner.thread_pool.lane_policy"
+#define THREAD_POOL_LANE_WEIGHTS "resource_tuner.thread_pool.lane_weights"
+#define MEMORY_POOL_BOOT_SHARE "resource_tuner.memory_pool.boot_share"
+#define MEMORY_POOL_CEILING_FACTOR "resource_tuner.memory_pool.ceiling_factor"
+#define MEMORY_POOL_IDLE_RELEASE "resource_tuner.memory_pool.idle_release"
+#define LISTENER_THREAD_COUNT "resource_tuner.listener.threads"
+#define LISTENER_BACKEND "resource_tuner.listener.backend"
+#define APPLIER_SHARD_COUNT "resource_tuner.applier.shards"
+#define WRITE_PLAN "resource_tuner.request_queue.write_plan"
+#define NODE_SHADOW_VALIDITY "resource_tuner.applier.shadow_validity"
 
 #define COMM(pid) ("/proc/" + std::to_string(pid) + "/comm")
 #define COMM_S(pidstr) ("/proc/" + pidstr + "/comm")
@@ -95,41 +95,51 @@ void Request::populateRetuneRequest(Request* retuneRequest, int64_t newDuration)
     retuneRequest->mResourceList = nullptr;
 }
 
-ErrCode Request::deserialize(char* buf) {
+ErrCode Request::deserialize(char* buf, uint64_t bufSize) {
     try {
+        const char* end = buf + bufSize;
         int32_t numResources = 0;
         int8_t* ptr8 = (int8_t*)buf;
-        DEREF_AND_INCR(ptr8, int8_t);
-        this->mReqType = DEREF_AND_INCR(ptr8, int8_t);
+        DEREF_AND_INCR_BOUNDED(ptr8, int8_t, end);
+        this->mReqType = DEREF_AND_INCR_BOUNDED(ptr8, int8_t, end);
 
         int64_t* ptr64 = (int64_t*)ptr8;
-        this->mHandle = DEREF_AND_INCR(ptr64, int64_t);
-        this->mDuration = DEREF_AND_INCR(ptr64, int64_t);
+        this->mHandle = DEREF_AND_INCR_BOUNDED(ptr64, int64_t, end);
+        this->mDuration = DEREF_AND_INCR_BOUNDED(ptr64, int64_t, end);
 
         int32_t* ptr = (int32_t*)ptr64;
-        numResources = DEREF_AND_INCR(ptr, int32_t);
-        this->mProperties = DEREF_AND_INCR(ptr, int32_t);
-        this->mClientPID = DEREF_AND_INCR(ptr, int32_t);
-        this->mClientTID = DEREF_AND_INCR(ptr, int32_t);
+        numResources = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mProperties = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mClientPID = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mClientTID = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
 
         if(this->mReqType == REQ_RESOURCE_TUNING) {
+            // Each Resource takes up at least 4 int32_t fields, reject a count which the
+            // buffer cannot hold, before any Resource is allocated.
+            const char* resStart = (const char*)ptr;
+            if(numResources < 0 ||
+               (uint64_t)numResources * 4 * sizeof(int32_t) > (uint64_t)(end - resStart)) {
+                return RC_REQUEST_DESERIALIZATION_FAILURE;
+            }
+
             for(int32_t i = 0; i < numResources; i++) {
+                // Linked to the Request right away, so that it is freed along with the
+                // Request if the remainder of the buffer turns out to be malformed.
                 ResIterable* resIterable = MPLACED(ResIterable);
                 Resource* resource = MPLACED(Resource);
+                resIterable->mData = resource;
+                this->addResource(resIterable);
 
-                resource->setResCode(DEREF_AND_INCR(ptr, int32_t));
-                resource->setResInfo(DEREF_AND_INCR(ptr, int32_t));
-                resource->setOptionalInfo(DEREF_AND_INCR(ptr, int32_t));
-                resource->setNumValues(DEREF_AND_INCR(ptr, int32_t));
+                resource->setResCode(DEREF_AND_INCR_BOUNDED(ptr, int32_t, end));
+                resource->setResInfo(DEREF_AND_INCR_BOUNDED(ptr, int32_t, end));
+                resource->setOptionalInfo(DEREF_AND_INCR_BOUNDED(ptr, int32_t, end));
+                resource->setNumValues(DEREF_AND_INCR_BOUNDED(ptr, int32_t, end));
 
                 for(int32_t j = 0; j < resource->getValuesCount(); j++) {
-                    if(RC_IS_NOTOK(resource->setValueAt(j, DEREF_AND_INCR(ptr, int32_t)))) {
+                    if(RC_IS_NOTOK(resource->setValueAt(j, DEREF_AND_INCR_BOUNDED(ptr, int32_t, end)))) {
                         return RC_REQUEST_DESERIALIZATION_FAILURE;
                     }
                 }
-
-                resIterable->mData = resource;
-                this->addResource(resIterable);
             }
         }
 
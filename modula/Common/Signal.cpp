@@ -57,46 +57,53 @@ void Signal::setList(std::vector<uint32_t>* listArgs) {
     this->mListArgs = listArgs;
 }
 
-ErrCode Signal::deserialize(char* buf) {
+ErrCode Signal::deserialize(char* buf, uint64_t bufSize) {
     try {
+        const char* end = buf + bufSize;
         int8_t* ptr8 = (int8_t*)buf;
-        DEREF_AND_INCR(ptr8, int8_t);
-        this->mReqType = DEREF_AND_INCR(ptr8, int8_t);
+        DEREF_AND_INCR_BOUNDED(ptr8, int8_t, end);
+        this->mReqType = DEREF_AND_INCR_BOUNDED(ptr8, int8_t, end);
 
         int32_t* ptr = (int32_t*)ptr8;
-        this->mSignalCode = DEREF_AND_INCR(ptr, int32_t);
-        this->mSignalType = DEREF_AND_INCR(ptr, int32_t);
+        this->mSignalCode = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mSignalType = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
 
         int64_t* ptr64 = (int64_t*)ptr;
-        this->mHandle = DEREF_AND_INCR(ptr64, int64_t);
-        this->mDuration = DEREF_AND_INCR(ptr64, int64_t);
+        this->mHandle = DEREF_AND_INCR_BOUNDED(ptr64, int64_t, end);
+        this->mDuration = DEREF_AND_INCR_BOUNDED(ptr64, int64_t, end);
 
         char* charIterator = (char*)ptr64;
         this->mAppName = charIterator;
 
-        while(*charIterator != '\0') {
+        while(charIterator < end && *charIterator != '\0') {
             charIterator++;
         }
+        if(charIterator >= end) {
+            throw std::invalid_argument("Unterminated string while decoding");
+        }
         charIterator++;
 
         this->mScenario = charIterator;
 
-        while(*charIterator != '\0') {
+        while(charIterator < end && *charIterator != '\0') {
             charIterator++;
         }
+        if(charIterator >= end) {
+            throw std::invalid_argument("Unterminated string while decoding");
+        }
         charIterator++;
 
         ptr = (int32_t*)charIterator;
-        this->mNumArgs = DEREF_AND_INCR(ptr, int32_t);
-        this->mProperties = DEREF_AND_INCR(ptr, int32_t);
-        this->mClientPID = DEREF_AND_INCR(ptr, int32_t);
-        this->mClientTID = DEREF_AND_INCR(ptr, int32_t);
+        this->mNumArgs = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mProperties = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mClientPID = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
+        this->mClientTID = DEREF_AND_INCR_BOUNDED(ptr, int32_t, end);
 
         this->mListArgs = MPLACED(std::vector<uint32_t>);
         this->mListArgs->resize(this->mNumArgs);
 
         for(int32_t i = 0; i < this->mNumArgs; i++) {
-            (*this->mListArgs)[i] = DEREF_AND_INCR(ptr, uint32_t);
+            (*this->mListArgs)[i] = DEREF_AND_INCR_BOUNDED(ptr, uint32_t, end);
         }
 
     } catch(const std::invalid_argument& e) {
@@ -13,7 +13,10 @@ class ClientEndpoint {
 public:
     virtual int32_t initiateConnection() = 0;
     virtual int32_t sendMsg(char* buf, size_t bufSize) = 0;
+    virtual int32_t sendMsgWithFds(char* buf, size_t bufSize, int32_t* fds, int32_t fdCount) = 0;
     virtual int32_t readMsg(char* buf, size_t bufSize) = 0;
+    virtual int32_t readMsgFully(char* buf, size_t bufSize) = 0; //!< Waits until bufSize bytes are read.
+    virtual int8_t isPeerClosed() = 0; //!< Non blocking check, if the server has closed the connection.
     virtual int32_t closeConnection() = 0;
 };
 
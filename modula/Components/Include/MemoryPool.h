@@ -23,27 +23,83 @@
  *            => X* xPtr = new (GetBlock<X>()) X(...);\n\n
  *          - To free a memory block, retrieved via the Memory Pool, make use of the FreeBlock API,
  *            as follows:\n
- *            => FreeBlock<X>(xPtr);
+ *            => FreeBlock<X>(xPtr);\n\n
+ *          - The pool for a type is held in a TypedPoolSlot, which is resolved at compile time.
+ *            Hence no type lookup or global lock is involved in GetBlock and FreeBlock.\n\n
+ *          - Memory is reserved in contiguous Slabs. If a maximum block count (ceiling) is passed
+ *            to MakeAlloc, the pool grows on exhaustion by adding Slabs of the same size as the
+ *            initial reservation, upto the ceiling, instead of throwing std::bad_alloc. Grown Slabs
+ *            which are fully free, and were not needed during the last trim period, are released
+ *            via ReleaseIdleSlabs. The initial reservation is never released.\n\n
+ *          - Each thread holds a small Magazine (cache) of free blocks per type. GetBlock and FreeBlock
+ *            are served from the calling thread's Magazine without taking any lock, the shared pool
+ *            is only accessed to refill or flush a Magazine, MAGAZINE_BATCH_SIZE blocks at a time.
+ *            If the shared pool runs dry, the blocks cached in the Magazines of the other threads are
+ *            reclaimed, before failing the allocation.
  *
  * @{
  */
 
+#include <atomic>
 #include <vector>
 #include <exception>
 #include <mutex>
 #include <memory>
-#include <unordered_map>
-#include <typeindex>
-#include <typeinfo>
 
 #include "Utils.h"
 #include "Logger.h"
 
+// Free list linkage, held in the free block itself.
 typedef struct _memoryNode {
     _memoryNode* next;
-    void* block;
 } MemoryNode;
 
+typedef struct _memorySlab {
+    _memorySlab* next;
+    char* base;
+    int32_t blockCount;
+    int32_t freeCount; //!< Only valid during a trim pass.
+    int8_t isReserved; //!< Slabs reserved via makeAllocation are never released.
+} MemorySlab;
+
+#define MAGAZINE_CAPACITY 32
+#define MAGAZINE_BATCH_SIZE (MAGAZINE_CAPACITY / 2)
+
+class MemoryPool;
+
+/**
+ * @brief MagazineCache
+ * @details Per-thread cache of free blocks of a single type. Only the owning thread allocates
+ *          from or frees to the Magazine. The mInUse flag is held by the owner for the duration
+ *          of each operation, so that the blocks can be safely reclaimed by another thread when
+ *          the shared pool is exhausted.
+ */
+class MagazineCache {
+    friend class MemoryPool;
+
+private:
+    void* mBlocks[MAGAZINE_CAPACITY];
+    int32_t mCount;
+    std::atomic<int8_t> mInUse;
+    MemoryPool* mPool;
+    MagazineCache* mNext; //!< Linkage in the list of Magazines attached to mPool.
+
+    void acquire();
+    void release();
+
+public:
+    MagazineCache();
+    ~MagazineCache();
+
+    int8_t isAttached() {
+        return this->mPool != nullptr;
+    }
+
+    void attach(MemoryPool* pool);
+    void* getBlock();
+    void freeBlock(void* block);
+};
+
 /**
  * @brief MemoryPool
  * @details Preallocate Memory for Commonly Used types, to decrease the
@@ -57,12 +113,24 @@ private:
 
     MemoryNode* mFreeListHead;
     MemoryNode* mFreeListTail;
-    MemoryNode* mAllocatedListHead;
 
-    int32_t mBlockSize;
+    MemorySlab* mSlabs;
+
+    int32_t mBlockSize; //!< Rounded up, so that a free block can hold a MemoryNode.
     int32_t mfreeBlocks;
+    int32_t mTotalBlocks; //!< Total blocks across all the Slabs.
+    int32_t mMaxBlocks; //!< Ceiling upto which the pool can grow.
+    int32_t mGrowthBlockCount; //!< Number of blocks added per growth step.
+    int32_t mPeakInUse; //!< Maximum blocks in use since the last trim pass.
 
-    int32_t addNodesToFreeList(int32_t blockCount);
+    int32_t addNodesToFreeList(int32_t blockCount, int8_t isReserved);
+    int32_t grow();
+    MemorySlab* findSlab(void* block);
+    void* popFreeBlock();
+    int8_t pushFreeBlock(void* block);
+    void reclaimMagazines();
+
+    MagazineCache* mMagazines; //!< Magazines (one per thread) attached to this pool.
 
 public:
     MemoryPool(int32_t blockSize);
@@ -72,10 +140,22 @@ public:
      * @brief Allocate memory for the specified type T.
      * @details This routine will allocate the number of memory blocks for the type specified by the client.
      * @param blockCount Number of blocks to be allocated.
+     * @param maxBlockCount Ceiling upto which the pool can grow on exhaustion, in steps of
+     *                      blockCount blocks. No growth if it does not exceed the reserved count.
      * @return int32_t:\n
      *            - Number of blocks which were actually allocated (might be smaller than blockCount)
      */
-    int32_t makeAllocation(int32_t blockCount);
+    int32_t makeAllocation(int32_t blockCount, int32_t maxBlockCount = 0);
+
+    /**
+     * @brief Release the grown Slabs which are fully free, provided that the peak usage since the
+     *        last call did not need them.
+     * @return int32_t:\n
+     *            - Number of blocks released.
+     */
+    int32_t releaseIdleSlabs();
+
+    int32_t getTotalBlockCount();
 
     /**
      * @brief Get an allocated block for the already allocated type T.
@@ -91,18 +171,73 @@ public:
      * @param block Pointer to the block to be freed.
      */
     void freeBlock(void* block);
+
+    /**
+     * @brief Move up to blockCount free blocks to the given array, under a single lock acquisition.
+     * @return int32_t:\n
+     *            - Number of blocks which were moved.
+     */
+    int32_t fetchBlocks(void** blocks, int32_t blockCount);
+
+    /**
+     * @brief Return blockCount blocks from the given array to the pool, under a single lock acquisition.
+     */
+    void returnBlocks(void** blocks, int32_t blockCount);
+
+    /**
+     * @brief Get a block after the calling thread's Magazine and the free list are found empty.
+     * @details Blocks cached in the Magazines of the other threads are reclaimed first.
+     *          Note: If a block is still not available then the Routine throws a std::bad_alloc exception.
+     */
+    void* getBlockSlowPath();
+
+    void registerMagazine(MagazineCache* magazine);
+    void unregisterMagazine(MagazineCache* magazine);
+};
+
+/**
+ * @brief TypedPoolSlot
+ * @details Holds the MemoryPool of the type T. The slot is resolved at compile time, and
+ *          filled in on the first makeAllocation call for T. Hence allocations go straight
+ *          to the pool, without any lookup or global lock.
+ */
+template <typename T>
+struct TypedPoolSlot {
+    static inline std::atomic<MemoryPool*> mPool {nullptr};
 };
 
 class PoolWrapper {
 private:
-    std::unordered_map<std::type_index, MemoryPool*> mMemoryPoolRefs;
+    // All the pools created so far, along with the slots referring to them.
+    std::vector<std::pair<MemoryPool*, std::atomic<MemoryPool*>*>> mMemoryPools;
     std::mutex mPoolWrapperMutex;
 
-    MemoryPool* getMemoryPool(std::type_index typeIndex);
+    MemoryPool* createMemoryPool(int32_t blockSize, std::atomic<MemoryPool*>& slot);
+    void* reportMissingPool(int32_t blockSize);
+
+    // Magazine of the calling thread, for the type T.
+    template <typename T>
+    static MagazineCache& getMagazine() {
+        static thread_local MagazineCache magazine;
+        return magazine;
+    }
+
+    template <typename T>
+    void freeToMagazine(void* block) {
+        if(block == nullptr) return;
 
-    int32_t makeAllocation(int32_t blockCount, int32_t blockSize, std::type_index typeIndex);
-    void* getBlock(int32_t blockSize, std::type_index typeIndex);
-    void freeBlock(std::type_index typeIndex, void* block);
+        MagazineCache& magazine = getMagazine<T>();
+        if(!magazine.isAttached()) {
+            MemoryPool* memoryPool = TypedPoolSlot<T>::mPool.load(std::memory_order_acquire);
+            if(memoryPool == nullptr) {
+                // Block was never allocated through the Memory Pool, ignore the call.
+                return;
+            }
+            magazine.attach(memoryPool);
+        }
+
+        magazine.freeBlock(block);
+    }
 
 public:
     PoolWrapper() {}
@@ -112,12 +247,32 @@ public:
      * @brief Allocate memory for the specified type T.
      * @details This routine will allocate the number of memory blocks for the type specified by the client.
      * @param int32_t Number of blocks to be allocated.
+     * @param maxBlockCount Ceiling upto which the pool can grow on exhaustion.
      */
     template <typename T>
-    int32_t makeAllocation(int32_t blockCount) {
-        return makeAllocation(blockCount, sizeof(T), std::type_index(typeid(T)));
+    int32_t makeAllocation(int32_t blockCount, int32_t maxBlockCount = 0) {
+        // Sanity Checks
+        if(blockCount <= 0) return 0;
+
+        MemoryPool* memoryPool = TypedPoolSlot<T>::mPool.load(std::memory_order_acquire);
+        if(memoryPool == nullptr) {
+            memoryPool = createMemoryPool(sizeof(T), TypedPoolSlot<T>::mPool);
+            if(memoryPool == nullptr) {
+                TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, (int32_t)sizeof(T), blockCount, 0);
+                return 0;
+            }
+        }
+
+        return memoryPool->makeAllocation(blockCount, maxBlockCount);
     }
 
+    /**
+     * @brief Release the idle grown Slabs of all the pools.
+     * @return int32_t:\n
+     *            - Total number of blocks released.
+     */
+    int32_t releaseIdleSlabs();
+
     /**
      * @brief Get an allocated block for the already allocated type T.
      * @details This routine should only be called after the makeAllocation call for a particular type
@@ -126,7 +281,17 @@ public:
      */
     template <typename T>
     void* getBlock() {
-        return getBlock(sizeof(T), std::type_index(typeid(T)));
+        MagazineCache& magazine = getMagazine<T>();
+        if(!magazine.isAttached()) {
+            MemoryPool* memoryPool = TypedPoolSlot<T>::mPool.load(std::memory_order_acquire);
+            if(memoryPool == nullptr) {
+                // No allocation made for this type
+                return reportMissingPool(sizeof(T));
+            }
+            magazine.attach(memoryPool);
+        }
+
+        return magazine.getBlock();
     }
 
     /**
@@ -138,7 +303,7 @@ public:
     typename std::enable_if<std::is_class<T>::value, void>::type
     freeBlock(void* block) {
         reinterpret_cast<T*>(block)->~T();
-        freeBlock(std::type_index(typeid(T)), block);
+        freeToMagazine<T>(block);
     }
 
     /**
@@ -148,15 +313,20 @@ public:
     template<typename T>
     typename std::enable_if<!std::is_class<T>::value, void>::type
     freeBlock(void* block) {
-        freeBlock(std::type_index(typeid(T)), block);
+        freeToMagazine<T>(block);
     }
 };
 
-std::shared_ptr<PoolWrapper> getPoolWrapper();
+// Returned by reference, to avoid touching the shared reference count on every allocation.
+const std::shared_ptr<PoolWrapper>& getPoolWrapper();
 
 template <typename T>
-inline void MakeAlloc(int32_t blockCount) {
-    getPoolWrapper()->makeAllocation<T>(blockCount);
+inline void MakeAlloc(int32_t blockCount, int32_t maxBlockCount = 0) {
+    getPoolWrapper()->makeAllocation<T>(blockCount, maxBlockCount);
+}
+
+inline int32_t ReleaseIdleSlabs() {
+    return getPoolWrapper()->releaseIdleSlabs();
 }
 
 template <typename T>
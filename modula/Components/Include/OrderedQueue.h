@@ -7,24 +7,99 @@
 #include <queue>
 #include <vector>
 #include <mutex>
+#include <atomic>
 #include <condition_variable>
 
 #include "Message.h"
 #include "MemoryPool.h"
 #include "Utils.h"
 
+// Capacity of each Ingest Ring, must be a power of 2
+#define INGEST_RING_CAPACITY 1024
+
+// One Ingest Ring per Priority Class, i.e. the Request Priorities
+// along with HIGH_TRANSFER_PRIORITY and SERVER_CLEANUP_TRIGGER_PRIORITY
+#define INGEST_RING_CLASSES (TOTAL_PRIORITIES - SERVER_CLEANUP_TRIGGER_PRIORITY)
+
+enum OrderedQueueMode {
+    ORDERED_QUEUE_LOCKED, //!< Producers push directly to the Ordered Structure, under the Queue lock.
+    ORDERED_QUEUE_INGEST_RING, //!< Producers push to lock-free Ingest Rings, drained by the consumer.
+};
+
 /**
- * @brief This class represents a mutex-protected multiple producer, single consumer priority queue.
+ * @brief Bounded, lock-free, multiple producer single consumer Ring of Messages.
+ * @details Producers claim a cell by advancing the shared tail (CAS), and publish the Message
+ *          by updating the cell's sequence number. The consumer reads the cells in order, hence
+ *          no lock is needed on either end.
+ */
+class IngestRing {
+private:
+    typedef struct {
+        std::atomic<uint32_t> mSequence;
+        Message* mData;
+    } IngestCell;
+
+    IngestCell* mCells;
+    uint32_t mMask;
+
+    alignas(64) std::atomic<uint32_t> mTail; //!< Next cell to be claimed by the producers
+    alignas(64) uint32_t mHead; //!< Next cell to be read by the consumer
+
+public:
+    IngestRing(uint32_t capacity);
+    ~IngestRing();
+
+    /**
+     * @brief Used by the producers to publish a Message to the Ring.
+     * @return int8_t:\n
+     *            - 1: If the Message was successfully published
+     *            - 0: If the Ring is full
+     */
+    int8_t push(Message* message);
+
+    /**
+     * @brief Used by the (single) consumer to read the oldest published Message.
+     * @return Message*:\n
+     *           - Pointer to the Message, or nullptr if no Message is available.
+     */
+    Message* pop();
+};
+
+/**
+ * @brief This class represents a multiple producer, single consumer priority queue.
  * @details The Queue items are ordered by their Priority, so that the Queue Item with the highest
- *          Priority is always served first.
+ *          Priority is always served first.\n
+ *          Two implementations are supported, selected at construction:\n
+ *          - ORDERED_QUEUE_LOCKED: The Ordered Structure is protected by a single mutex, which is
+ *            held by the consumer while processing the Requests.\n
+ *          - ORDERED_QUEUE_INGEST_RING: Producers push to a per Priority Class Ingest Ring, and
+ *            the consumer drains the Rings into its private Ordered Structure. Producers never
+ *            block on the consumer, the Queue lock is only taken to wake up a sleeping consumer,
+ *            or if an Ingest Ring overflows.
  */
 class OrderedQueue {
 protected:
-    int32_t mElementCount;
+    std::atomic<int32_t> mElementCount;
     std::mutex mOrderedQueueMutex;
     std::condition_variable mOrderedQueueCondition;
     int8_t lockStatus;
 
+    OrderedQueueMode mQueueMode;
+    IngestRing* mIngestRings[INGEST_RING_CLASSES];
+    std::atomic<int8_t> mConsumerSleeping;
+
+    // Messages which could not be accomodated in their Ingest Ring
+    std::vector<Message*> mOverflow;
+    std::atomic<int32_t> mOverflowCount;
+    std::mutex mOverflowMutex;
+
+    // Batch Consumer statistics
+    std::atomic<int32_t> mLastBatchSize;
+    std::atomic<int64_t> mBatchCount;
+    std::atomic<int64_t> mBatchedMessageCount;
+
+    void drainIngestRings();
+
     struct QueueOrdering {
         int8_t operator() (Message* &a,  Message* &b) {
             return a->getPriority() > b->getPriority();
@@ -38,7 +113,7 @@ protected:
     std::priority_queue<Message*, std::vector<Message*>, QueueOrdering> mOrderedQueue;
 
 public:
-    OrderedQueue();
+    OrderedQueue(OrderedQueueMode queueMode=ORDERED_QUEUE_LOCKED);
     ~OrderedQueue();
 
     /**
@@ -58,6 +133,14 @@ public:
      */
     virtual void orderedQueueConsumerHook() = 0;
 
+    /**
+     * @brief Provides a mechanism, to hook or plug-in the Batch Consumer Code.
+     * @details Invoked by waitForBatch, with the Queue lock released. The Messages in the
+     *          batch are ordered by their Priority. The consumer is responsible for freeing them.
+     * @param batch Messages extracted from the OrderedQueue as part of a single wakeup.
+     */
+    virtual void orderedQueueBatchHook(std::vector<Message*>& batch) { (void)batch; }
+
     /**
      * @brief Used by the consumer end to poll a request from the OrderedQueue
      * @details This routine will return the Request with the highest priority to the consumer
@@ -70,10 +153,34 @@ public:
 
     /**
      * @brief Used by the Consumer end to wait for Requests.
-     * @details This routine will put the consumer to sleep.
+     * @details This routine will put the consumer to sleep, until a Request is available.
+     *          The consumer hook is then invoked, with the Queue lock held in the
+     *          ORDERED_QUEUE_LOCKED mode.
      */
     void wait();
 
+    /**
+     * @brief Used by the Consumer end to wait for Requests, and process them in batches.
+     * @details This routine will put the consumer to sleep, until a Request is available.
+     *          Upto maxBatchSize Requests are then extracted as part of a single lock acquisition,
+     *          and handed over to the batch consumer hook, after the Queue lock is released.
+     *          Hence the producers are not blocked while the batch is being processed.
+     * @param maxBatchSize Maximum number of Requests to be extracted per wakeup.
+     * @return int32_t:\n
+     *            - Number of Requests processed as part of this wakeup.
+     */
+    int32_t waitForBatch(int32_t maxBatchSize);
+
+    /**
+     * @brief Get the number of Requests processed as part of the most recent batch.
+     */
+    int32_t getLastBatchSize();
+
+    /**
+     * @brief Get the average number of Requests processed per batch.
+     */
+    double getAverageBatchSize();
+
     /**
      * @brief Used by the consumer to check if there are any pending requests in the OrderedQueue
      * @return int8_t:\n
@@ -83,6 +190,8 @@ public:
     int8_t hasPendingTasks();
 
     void forcefulAwake();
+
+    OrderedQueueMode getQueueMode();
 };
 
 #endif
@@ -116,6 +116,13 @@ T Divide(T firstArg, T secondArg, OperationStatus& status)  {
     val;                                 \
 })
 
+// Same as DEREF_AND_INCR, additionally ensures that the value lies before end.
+#define DEREF_AND_INCR_BOUNDED(ptr, type, end) ({                                   \
+    ((const char*)(ptr) + sizeof(*(ptr)) > (const char*)(end)) ?                      \
+        throw std::invalid_argument("Buffer overrun while decoding") : 0;             \
+    DEREF_AND_INCR(ptr, type);                                                        \
+})
+
 #define VALIDATE_GT(val, base) \
     (val > base) ? val : throw std::invalid_argument("Invalid value: " #val " should be greater than " #base)
 
@@ -0,0 +1,169 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef SHARED_RING_H
+#define SHARED_RING_H
+
+/*!
+ * \file  SharedRing.h
+ */
+
+/*!
+ * \ingroup SHARED_RING
+ * \defgroup SHARED_RING Shared Ring
+ * \details Shared memory transport between a client process and the Server.
+ *
+ *          The client creates a memfd backed region, holding a Submission Queue (SQ) of
+ *          Request buffers and a Completion Queue (CQ) of int64_t results, along with two
+ *          eventfds: the SQ doorbell (client to Server) and the CQ doorbell (Server to client).
+ *          The fds are passed to the Server over the client socket, and the Server maps the
+ *          same region.\n\n
+ *          - Both queues are single producer, single consumer. The client produces Requests and
+ *            consumes results, the Server does the opposite. Hence no lock is involved.\n\n
+ *          - A doorbell is only rung if the consumer has announced that it is about to sleep
+ *            (via the NeedWakeup flag), so a busy consumer drains the queue without any syscall
+ *            on either side.\n\n
+ *          - The region is writable by the client at all times, hence the Server never trusts
+ *            the indices: an out of range index marks the ring as corrupt, and the Requests are
+ *            copied out of the ring before being parsed.
+ *
+ * @{
+ */
+
+#include <atomic>
+#include <cstdint>
+#include <cstddef>
+
+#include "UrmSettings.h"
+
+#define SHARED_RING_MAGIC 0x55524D52
+#define SHARED_RING_ENTRIES 128
+#define SHARED_RING_MASK (SHARED_RING_ENTRIES - 1)
+
+// fds passed along with the REQ_RING_OPEN message, in order: memfd, SQ doorbell, CQ doorbell.
+#define SHARED_RING_FD_COUNT 3
+
+typedef struct {
+    uint32_t mMagic;
+    uint32_t mEntries;
+
+    alignas(64) std::atomic<uint32_t> mSqHead; //!< Written by the Server.
+    std::atomic<uint32_t> mSqNeedWakeup; //!< Set by the Server before it sleeps on the SQ doorbell.
+    alignas(64) std::atomic<uint32_t> mSqTail; //!< Written by the client.
+
+    alignas(64) std::atomic<uint32_t> mCqHead; //!< Written by the client.
+    std::atomic<uint32_t> mCqNeedWakeup; //!< Set by the client before it sleeps on the CQ doorbell.
+    alignas(64) std::atomic<uint32_t> mCqTail; //!< Written by the Server.
+} SharedRingHeader;
+
+/**
+ * @brief SharedRing
+ * @details A mapping of the shared region, along with the doorbells. The client side is set up
+ *          via create, the Server side via attach.
+ */
+class SharedRing {
+private:
+    int32_t mMemFd;
+    int32_t mSqEventFd;
+    int32_t mCqEventFd;
+    size_t mSize;
+
+    SharedRingHeader* mHeader;
+    char* mSqEntries;
+    int64_t* mCqEntries;
+
+    int8_t map();
+    void ringDoorbell(int32_t eventFd);
+
+public:
+    SharedRing();
+    ~SharedRing();
+
+    /**
+     * @brief Create and map a new region along with its doorbells (client side).
+     * @param cqEventFd Optional eventfd to be used as the CQ doorbell. The ring holds a duplicate of it,
+     *                  hence the caller can keep waiting on the same fd across rings. By default, a new
+     *                  eventfd is created.
+     * @return int32_t: RC_SUCCESS if the ring was created, an error code otherwise.
+     */
+    int32_t create(int32_t cqEventFd = -1);
+
+    /**
+     * @brief Map the region created by the client (Server side).
+     * @details The SharedRing takes ownership of the fds, irrespective of the outcome.
+     *          The doorbells must be eventfds, they are switched to non-blocking mode.
+     * @return int32_t: RC_SUCCESS if the region was successfully mapped and validated,
+     *                  an error code otherwise.
+     */
+    int32_t attach(int32_t memFd, int32_t sqEventFd, int32_t cqEventFd);
+
+    /**
+     * @brief Copy a Request (an unframed payload of at most REQ_BUFFER_SIZE bytes) into the SQ,
+     *        and ring the SQ doorbell if the Server is sleeping (client side).
+     * @return int8_t: true if the Request was submitted, false if the SQ is full or the
+     *                 Request does not fit an SQ entry.
+     */
+    int8_t submit(const char* buf, size_t bufSize);
+
+    /**
+     * @brief Copy the next Request (REQ_BUFFER_SIZE bytes) out of the SQ (Server side).
+     * @return int8_t:\n
+     *            - 1: if a Request was copied into buf\n
+     *            - 0: if the SQ is empty\n
+     *            - -1: if the indices are corrupt
+     */
+    int8_t consume(char* buf);
+
+    /**
+     * @brief Announce that the Server is about to sleep on the SQ doorbell.
+     * @return int8_t: true if the SQ is still empty, i.e. it is safe to sleep. If false, the
+     *                 announcement is withdrawn and the pending Requests must be consumed.
+     */
+    int8_t prepareSqWait();
+
+    /**
+     * @brief Reset the SQ doorbell counter (Server side).
+     */
+    void drainSqDoorbell();
+
+    /**
+     * @brief Post a result to the CQ, and ring the CQ doorbell if the client is sleeping (Server side).
+     * @return int8_t: true if the result was posted, false if the CQ is full.
+     */
+    int8_t complete(int64_t result);
+
+    /**
+     * @brief Wait for the next result in the CQ (client side).
+     * @param result Populated with the result.
+     * @param timeout Max time (in milliseconds) to wait for the result.
+     * @return int8_t: true if a result was received, false on timeout.
+     */
+    int8_t reap(int64_t& result, int32_t timeout);
+
+    /**
+     * @brief Fetch the next result in the CQ if one is available, without waiting (client side).
+     * @return int8_t: true if a result was fetched, false if the CQ is empty.
+     */
+    int8_t tryReap(int64_t& result);
+
+    /**
+     * @brief Announce that the client is about to wait on the CQ doorbell.
+     * @return int8_t: true if the CQ is still empty, i.e. the Server will ring the doorbell on the
+     *                 next result. If false, the announcement is withdrawn and the pending results
+     *                 must be reaped.
+     */
+    int8_t prepareCqWait();
+
+    /**
+     * @brief Reset the CQ doorbell counter (client side).
+     */
+    void drainCqDoorbell();
+
+    int32_t getMemFd();
+    int32_t getSqEventFd();
+    int32_t getCqEventFd();
+};
+
+#endif
+
+/*! @} */
@@ -31,11 +31,25 @@
  *          Condition Variable. Whenever a task comes in, one of these threads (considering there
  *          are threads available in the pool), will be woken up and it will pick up the new task.
  *
+ *          Two modes of operation are supported:\n
+ *          - THREAD_POOL_SHARED_QUEUE: All the tasks are added to a single shared Task Queue,
+ *            protected by the Pool lock.\n\n
+ *          - THREAD_POOL_WORK_STEALING: Each worker owns a (Chase-Lev) Task Deque. Tasks submitted
+ *            from a worker thread are pushed to its own Deque, while tasks submitted from outside
+ *            the pool go to the shared Task Queue. A worker first drains its own Deque, then the
+ *            shared Task Queue, and finally steals from the other workers' Deques. The Pool lock
+ *            is only needed for the shared Task Queue, and to put to sleep / wake up idle workers.
+ *
+ *          The shared Task Queue is split into Priority Lanes (see TaskLane). Tasks are picked up
+ *          from the Lanes either strictly in the order of their priority, or in proportion to the
+ *          configured Lane weights (see TaskLanePolicy).
+ *
  * @{
  */
 
 #include <thread>
 #include <vector>
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <condition_variable>
@@ -78,6 +92,74 @@ public:
     ~TaskQueue();
 };
 
+/**
+ * @brief Set of per Lane Task Queues.
+ * @details Tasks are picked up from the Lanes as per the configured TaskLanePolicy.
+ *          In the Weighted mode, each Lane is assigned credits equal to its weight, and a Lane
+ *          is served only if it has credits left. Once all the non-empty Lanes run out of
+ *          credits, the credits are replenished. Hence a task in the Critical Lane waits for at
+ *          most the sum of the weights of the other Lanes.
+ */
+class TaskLanes {
+private:
+    int32_t mSize;
+    TaskLanePolicy mPolicy;
+    TaskQueue mLanes[TOTAL_TASK_LANES];
+    int32_t mWeights[TOTAL_TASK_LANES];
+    int32_t mCredits[TOTAL_TASK_LANES];
+
+public:
+    TaskLanes();
+
+    void setPolicy(TaskLanePolicy policy, const int32_t weights[TOTAL_TASK_LANES]);
+    void add(TaskNode* taskNode, int32_t lane);
+    TaskNode* poll();
+    int8_t isEmpty();
+    int32_t getSize();
+    int32_t getLaneSize(int32_t lane);
+};
+
+// Capacity of each worker's Task Deque, must be a power of 2
+#define TASK_DEQUE_CAPACITY 256
+
+/**
+ * @brief Fixed capacity Chase-Lev Work Stealing Deque.
+ * @details The owner (worker) pushes and takes Tasks from the bottom end, without any locking.
+ *          Other workers steal Tasks from the top end, using a CAS on the top index.
+ */
+class TaskDeque {
+private:
+    alignas(64) std::atomic<int64_t> mTop;
+    alignas(64) std::atomic<int64_t> mBottom;
+    std::atomic<TaskNode*> mBuffer[TASK_DEQUE_CAPACITY];
+
+public:
+    TaskDeque();
+
+    /**
+     * @brief Push a Task to the bottom of the Deque. Must only be called by the owner.
+     * @return int8_t:\n
+     *            - 1 if the Task was successfully pushed,
+     *            - 0 if the Deque is full.
+     */
+    int8_t push(TaskNode* taskNode);
+
+    /**
+     * @brief Take the most recently pushed Task. Must only be called by the owner.
+     */
+    TaskNode* take();
+
+    /**
+     * @brief Steal the oldest Task. Can be called by any thread.
+     */
+    TaskNode* steal();
+};
+
+enum ThreadPoolMode {
+    THREAD_POOL_SHARED_QUEUE, //!< All workers pick up tasks from a single shared Task Queue.
+    THREAD_POOL_WORK_STEALING, //!< Each worker owns a Task Deque, idle workers steal tasks.
+};
+
 static const int32_t maxLoadPerThread = 3;
 
 /**
@@ -89,34 +171,60 @@ private:
     int32_t mDesiredPoolCapacity; //!< Desired or Base Thread Pool Capacity
     int32_t mMaxPoolCapacity; //!< Max Capacity upto which the Thread Pool can scale up.
 
-    int32_t mCurrentThreadsCount;
+    std::atomic<int32_t> mCurrentThreadsCount;
     int32_t mTotalTasksCount;
-    int8_t mTerminatePool;
+    std::atomic<int8_t> mTerminatePool;
 
-    TaskQueue* mCurrentTasks;
+    TaskLanes* mCurrentTasks;
     ThreadNode* mThreadQueueHead;
     ThreadNode* mThreadQueueTail;
 
     std::mutex mThreadPoolMutex;
     std::condition_variable mThreadPoolCond;
 
+    // Work Stealing mode
+    ThreadPoolMode mPoolMode;
+    std::atomic<int32_t> mPendingTasksCount; //!< Tasks submitted, but not yet picked up.
+    std::atomic<int32_t> mSharedTasksCount; //!< Tasks in the shared Task Queue.
+    std::atomic<int32_t> mIdleWorkersCount;
+    std::vector<TaskDeque*> mWorkerDeques;
+    std::vector<int32_t> mFreeWorkerSlots;
+
     TaskNode* createTaskNode(std::function<void(void*)> taskCallback, void* args);
     int8_t addNewThread(int8_t isCoreThread);
     int8_t threadRoutineHelper(int8_t isCoreThread);
 
+    TaskNode* findTask(int32_t workerSlot);
+    int8_t workStealingRoutineHelper(int8_t isCoreThread, int32_t workerSlot);
+    int8_t enqueueWorkStealing(std::function<void(void*)> taskCallback, void* args, int32_t lane);
+    int32_t getLaneHeadroom(int32_t lane);
+
 public:
-    ThreadPool(int32_t desiredCapacity, int32_t maxCapacity);
+    ThreadPool(int32_t desiredCapacity,
+               int32_t maxCapacity,
+               ThreadPoolMode poolMode=THREAD_POOL_SHARED_QUEUE);
     ~ThreadPool();
 
     /**
      * @brief Enqueue a task for processing by one of ThreadPool's thread.
      * @param taskCallback function pointer to the task.
      * @param arg Pointer to the task arguments.
+     * @param lane Priority Lane of the task. Tasks in the Critical Lane are also admitted
+     *             beyond the regular per thread load limit, upto a reserved headroom.
      * @return int8_t:\n
      *            - 1 if the request was successfully enqueued,
      *            - 0 otherwise.
      */
-    int8_t enqueueTask(std::function<void(void*)> callBack, void* arg);
+    int8_t enqueueTask(std::function<void(void*)> callBack, void* arg, int32_t lane=TASK_LANE_NORMAL);
+
+    /**
+     * @brief Configure how the tasks are picked up from the Priority Lanes.
+     * @param policy Strict or Weighted dequeue.
+     * @param weights Per Lane weights, only used with the Weighted policy.
+     */
+    void setLanePolicy(TaskLanePolicy policy, const int32_t weights[TOTAL_TASK_LANES]);
+
+    ThreadPoolMode getPoolMode();
 };
 
 #endif
@@ -5,33 +5,32 @@
 #define RESOURCE_TUNER_TIMER_H
 
 #include <chrono>
-#include <thread>
 #include <atomic>
 #include <functional>
-#include <mutex>
-#include <condition_variable>
 
 #include "Logger.h"
-#include "ThreadPool.h"
+#include "MemoryPool.h"
+#include "DLManager.h"
+#include "TimerWheel.h"
 
 /**
  * @brief Timer
  */
 class Timer {
+    friend class TimerWheel;
+
 private:
     int64_t mDuration; //!< Duration of the timer.
     int8_t mIsRecurring; //!< Flag to set a recurring timer. It is never modified. False by default.
-    std::atomic<int8_t> mTimerStop; //!< Flag to let the timer thread know it has been killed.
-    std::condition_variable mTimerCond; //!< Condition variable to stop the thread for the timer duration and wake up either after the duration has ended or the timer is killed.
-    std::mutex mTimerMutex; // !<Mutex to protect the condition variable.
+    std::atomic<int8_t> mTimerStop; //!< Flag to indicate the timer has been killed.
     std::function<void(void*)> mCallback; //!< Callback function to be called after timer is over.
 
-    void implementTimer();
+    int64_t mExpiryTick; //!< Absolute Wheel tick at which the timer expires.
+    int32_t mWheelLevel; //!< Wheel level in which the timer is currently linked.
+    DLManager* mWheelSlot; //!< Wheel slot in which the timer is currently linked, nullptr if not armed.
+    Iterable<Timer*> mWheelNode; //!< Linkage used to chain the timer into its Wheel slot.
 
 public:
-    // Create the ThreadPool as a static member so that all the Timer objects can share it.
-    static ThreadPool* mTimerThreadPool;
-
     /**
      * @brief Initialize the Timer
      * @param callBack Function that needs to be invoked after the specified timer duration
@@ -46,10 +45,9 @@ public:
 
     /**
      * @brief Starts the timer for the given duration in milliseconds
-     * @details As part of this routine, a task is submitted to the Thread Pool, this task forces
-     *          the thread (which picked up the submitted task) to wait (on Condition Variable)
-     *          for the given duration (wait_for). When woken up, the thread atomically checks if the timer was
-     *          updated or not. Following which it it executes a pre-registered callback function.
+     * @details As part of this routine, the timer is armed in the process wide TimerWheel.
+     *          No thread is blocked for the duration of the timer, instead the Wheel's expiry
+     *          thread invokes the pre-registered callback function once the duration elapses.
      * @param duration Time Interval (in milliseconds) after which the Callback needs
      *                 needs to be triggered.
      * @return int8_t:\n
@@ -60,8 +58,14 @@ public:
 
     /**
      * @brief Invalidates current timer.
+     * @details The timer is unlinked from the TimerWheel, hence its callback will not be invoked.
      */
     void killTimer();
+
+    /**
+     * @brief Check if the Timer is armed, i.e. it has been started and is yet to expire.
+     */
+    int8_t isArmed();
 };
 
 #endif
@@ -0,0 +1,157 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef TIMER_WHEEL_H
+#define TIMER_WHEEL_H
+
+/*!
+ * \file  TimerWheel.h
+ */
+
+/*!
+ * \ingroup TIMER_WHEEL
+ * \defgroup TIMER_WHEEL Timer Wheel
+ * \details Single threaded Hierarchical Timer Wheel, which drives the expiry of all the
+ *          Timer objects in the process.
+ *
+ *          The wheel is made up of TIMER_WHEEL_LEVELS levels, each containing TIMER_WHEEL_SLOTS
+ *          slots. A slot in level 0 spans a single tick (1 millisecond), a slot in level 1 spans
+ *          TIMER_WHEEL_SLOTS ticks and so on. A Timer is placed in the level which can
+ *          accomodate its remaining duration, and is moved (cascaded) to a lower level, once
+ *          the wheel rotates to its slot.\n\n
+ *          - Arming and Cancelling a Timer are O(1) operations, since they amount to linking
+ *            (or unlinking) the Timer from the slot's Linked List.\n\n
+ *          - A single expiry thread processes the ticks, it sleeps until the next tick at which
+ *            either a Timer is due or a cascade needs to be performed. Hence the thread count
+ *            does not grow with the number of active Timers.\n\n
+ *          - Timer Callbacks are invoked on the expiry thread, outside the Wheel lock. Callbacks
+ *            are expected to be short (for example, submitting an Untune Request to the RequestQueue).
+ *
+ * @{
+ */
+
+#include <chrono>
+#include <thread>
+#include <mutex>
+#include <memory>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+#include "DLManager.h"
+#include "Logger.h"
+
+#define TIMER_WHEEL_LEVELS 5
+#define TIMER_WHEEL_SLOT_BITS 6
+#define TIMER_WHEEL_SLOTS (1 << TIMER_WHEEL_SLOT_BITS)
+#define TIMER_WHEEL_SLOT_MASK (TIMER_WHEEL_SLOTS - 1)
+
+class Timer;
+
+/**
+ * @brief TimerWheel
+ * @details Tracks all the armed Timers, and invokes their callbacks once they expire.
+ */
+class TimerWheel {
+private:
+    static std::shared_ptr<TimerWheel> mTimerWheelInstance;
+    static std::mutex instanceProtectionLock;
+
+    std::chrono::steady_clock::time_point mStartPoint; //!< Tick 0 of the Wheel.
+    int64_t mCurrentTick; //!< Next tick to be processed, all ticks before it have been processed.
+    int64_t mNextWakeTick; //!< Tick at which the expiry thread is scheduled to wake up.
+    int32_t mArmedCount; //!< Total Number of Timers currently linked in the Wheel.
+    int32_t mLevelCount[TIMER_WHEEL_LEVELS]; //!< Number of Timers linked in each level.
+    int8_t mTerminate;
+
+    DLManager* mSlots[TIMER_WHEEL_LEVELS][TIMER_WHEEL_SLOTS];
+
+    std::mutex mTimerWheelMutex;
+    std::condition_variable mTimerWheelCond;
+    std::thread mExpiryThread;
+
+    TimerWheel();
+
+    int64_t getElapsedTicks();
+    int64_t getNextEventTick();
+
+    void link(Timer* timer);
+    void unlink(Timer* timer);
+    int32_t cascade(int32_t level);
+    void processTick(std::vector<std::function<void(void*)>>& expired);
+    void advance(int64_t uptoTick, std::vector<std::function<void(void*)>>& expired);
+    void expiryThreadRoutine();
+
+public:
+    ~TimerWheel();
+
+    /**
+     * @brief Arm the Timer, so that its callback is invoked after the given duration.
+     * @details If the Timer is already armed, it is first cancelled.
+     * @param timer Pointer to the Timer to be armed.
+     * @param duration Time Interval (in milliseconds) after which the Timer expires.
+     * @return int8_t:\n
+     *            - 1 if the Timer was successfully armed\n
+     *            - 0 otherwise.
+     */
+    int8_t arm(Timer* timer, int64_t duration);
+
+    /**
+     * @brief Cancel a previously armed Timer.
+     * @details If the Timer is not armed (i.e. it has already expired), then this call is a no-op.
+     * @param timer Pointer to the Timer to be cancelled.
+     */
+    void cancel(Timer* timer);
+
+    /**
+     * @brief Check if the Timer is currently armed, i.e. it is yet to expire.
+     * @param timer Pointer to the Timer.
+     * @return int8_t:\n
+     *            - 1 if the Timer is armed\n
+     *            - 0 otherwise.
+     */
+    int8_t isArmed(Timer* timer);
+
+    /**
+     * @brief Stop the expiry thread. No Timer callbacks will be invoked after this call returns.
+     */
+    void stop();
+
+    /**
+     * @brief Get the Number of Timers currently armed in the Wheel.
+     */
+    int32_t getArmedCount();
+
+    static std::shared_ptr<TimerWheel> getInstance() {
+        if(mTimerWheelInstance == nullptr) {
+            instanceProtectionLock.lock();
+            if(mTimerWheelInstance == nullptr) {
+                try {
+                    mTimerWheelInstance = std::shared_ptr<TimerWheel> (new TimerWheel());
+                } catch(const std::bad_alloc& e) {
+                    instanceProtectionLock.unlock();
+                    return nullptr;
+                } catch(const std::system_error& e) {
+                    instanceProtectionLock.unlock();
+                    return nullptr;
+                }
+            }
+            instanceProtectionLock.unlock();
+        }
+        return mTimerWheelInstance;
+    }
+
+    /**
+     * @brief Get the Wheel instance only if it has already been created.
+     * @details No Timer can be armed before the Wheel exists, hence this is used on paths
+     *          which only need to cancel, so as to not spawn the expiry thread needlessly.
+     */
+    static std::shared_ptr<TimerWheel> getExistingInstance() {
+        const std::lock_guard<std::mutex> lock(instanceProtectionLock);
+        return mTimerWheelInstance;
+    }
+};
+
+#endif
+
+/*! @} */
@@ -1,57 +1,119 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <thread>
+#include <algorithm>
+
 #include "MemoryPool.h"
 
 MemoryPool::MemoryPool(int32_t blockSize) {
     this->mFreeListHead = this->mFreeListTail = nullptr;
-    this->mAllocatedListHead = nullptr;
+    this->mMagazines = nullptr;
+    this->mSlabs = nullptr;
     this->mfreeBlocks = 0;
-    this->mBlockSize = blockSize;
+    this->mTotalBlocks = 0;
+    this->mMaxBlocks = 0;
+    this->mGrowthBlockCount = 0;
+    this->mPeakInUse = 0;
+
+    // Each block must be able to hold the free list linkage, and stay aligned for it.
+    int32_t nodeSize = (int32_t)sizeof(MemoryNode);
+    blockSize = std::max(blockSize, nodeSize);
+    this->mBlockSize = ((blockSize + nodeSize - 1) / nodeSize) * nodeSize;
 }
 
-int32_t MemoryPool::addNodesToFreeList(int32_t blockCount) {
-    int32_t allocatedCount = 0;
+// Reserve a contiguous Slab of blockCount blocks, and add them to the free list.
+// The free blocks are linked through their own storage, hence no memory beyond the
+// Slab itself is needed.
+// Note: Must be called with mMemoryPoolMutex held.
+int32_t MemoryPool::addNodesToFreeList(int32_t blockCount, int8_t isReserved) {
+    MemorySlab* slab = new(std::nothrow) MemorySlab;
+    if(slab == nullptr) {
+        TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, this->mBlockSize, blockCount, 0);
+        return 0;
+    }
 
-    for(int32_t i = 0; i < blockCount; i++) {
-        MemoryNode* allocationBlock = nullptr;
+    slab->base = new(std::nothrow) char[(size_t)blockCount * this->mBlockSize];
+    if(slab->base == nullptr) {
+        TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, this->mBlockSize, blockCount, 0);
+        delete slab;
+        return 0;
+    }
 
-        allocationBlock = new(std::nothrow) MemoryNode;
-        if(allocationBlock == nullptr) {
-            TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, this->mBlockSize,
-                     blockCount, allocatedCount);
-            return allocatedCount;
-        }
+    MemoryNode* chainHead = nullptr;
+    MemoryNode* chainTail = nullptr;
+
+    for(int32_t i = 0; i < blockCount; i++) {
+        MemoryNode* freeNode = new(slab->base + (size_t)i * this->mBlockSize) MemoryNode;
+        freeNode->next = nullptr;
 
-        allocationBlock->next = nullptr;
-        allocationBlock->block = new(std::nothrow) char[this->mBlockSize];
-        if(allocationBlock->block == nullptr) {
-            TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, this->mBlockSize,
-                     blockCount, allocatedCount);
-            delete(allocationBlock);
-            return allocatedCount;
+        if(chainHead == nullptr) {
+            chainHead = chainTail = freeNode;
+        } else {
+            chainTail->next = freeNode;
+            chainTail = freeNode;
         }
+    }
 
-        allocatedCount++;
+    if(chainHead != nullptr) {
         if(this->mFreeListHead == nullptr) {
-            this->mFreeListHead = allocationBlock;
-            this->mFreeListTail = allocationBlock;
+            this->mFreeListHead = chainHead;
         } else {
-            this->mFreeListTail->next = allocationBlock;
-            this->mFreeListTail = this->mFreeListTail->next;
+            this->mFreeListTail->next = chainHead;
         }
+        this->mFreeListTail = chainTail;
     }
 
-    return allocatedCount;
+    slab->blockCount = blockCount;
+    slab->freeCount = 0;
+    slab->isReserved = isReserved;
+    slab->next = this->mSlabs;
+    this->mSlabs = slab;
+
+    this->mTotalBlocks += blockCount;
+    this->mfreeBlocks += blockCount;
+
+    return blockCount;
 }
 
-int32_t MemoryPool::makeAllocation(int32_t blockCount) {
+// Add a Slab of mGrowthBlockCount blocks, without crossing the ceiling.
+// Note: Must be called with mMemoryPoolMutex held.
+int32_t MemoryPool::grow() {
+    int32_t blockCount = std::min(this->mGrowthBlockCount, this->mMaxBlocks - this->mTotalBlocks);
+    if(blockCount <= 0) {
+        return 0;
+    }
+
+    blockCount = this->addNodesToFreeList(blockCount, false);
+    if(blockCount > 0) {
+        LOGD("URM_MEMORY_POOL", "Pool of block size: " + std::to_string(this->mBlockSize) +
+             " grown to: " + std::to_string(this->mTotalBlocks) + " blocks");
+    }
+
+    return blockCount;
+}
+
+// Note: Must be called with mMemoryPoolMutex held.
+MemorySlab* MemoryPool::findSlab(void* block) {
+    char* address = static_cast<char*>(block);
+    for(MemorySlab* slab = this->mSlabs; slab != nullptr; slab = slab->next) {
+        if(address >= slab->base && address < slab->base + (size_t)slab->blockCount * this->mBlockSize) {
+            return slab;
+        }
+    }
+    return nullptr;
+}
+
+int32_t MemoryPool::makeAllocation(int32_t blockCount, int32_t maxBlockCount) {
     int32_t blocksAllocated = 0;
     try {
         const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
 
-        blocksAllocated = this->addNodesToFreeList(blockCount);
-        this->mfreeBlocks += blockCount;
+        blocksAllocated = this->addNodesToFreeList(blockCount, true);
+        if(maxBlockCount > this->mMaxBlocks) {
+            this->mMaxBlocks = maxBlockCount;
+            this->mGrowthBlockCount = blockCount;
+        }
         return blocksAllocated;
 
     } catch(const std::bad_alloc& e) {
@@ -68,36 +130,161 @@ int32_t MemoryPool::makeAllocation(int32_t blockCount) {
     return blocksAllocated;
 }
 
-void* MemoryPool::getBlock() {
+int32_t MemoryPool::releaseIdleSlabs() {
+    int32_t releasedCount = 0;
+
     try {
         const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
 
-        if(this->mfreeBlocks == 0) {
-            TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, this->mBlockSize);
-            throw std::bad_alloc();
+        for(MemorySlab* slab = this->mSlabs; slab != nullptr; slab = slab->next) {
+            slab->freeCount = 0;
         }
 
-        // Get a free block from the free list
-        MemoryNode* memNode = this->mFreeListHead;
-        this->mFreeListHead = this->mFreeListHead->next;
-        memNode->next = nullptr;
+        for(MemoryNode* node = this->mFreeListHead; node != nullptr; node = node->next) {
+            MemorySlab* slab = this->findSlab(node);
+            if(slab != nullptr) {
+                slab->freeCount++;
+            }
+        }
 
-        if(this->mFreeListHead == nullptr) {
-            this->mFreeListTail = nullptr;
+        // A grown Slab is released only if it is fully free, and the peak usage
+        // since the last pass could have been served without it.
+        int32_t retainedBlocks = this->mTotalBlocks;
+        for(MemorySlab* slab = this->mSlabs; slab != nullptr; slab = slab->next) {
+            if(slab->isReserved || slab->freeCount != slab->blockCount) {
+                slab->freeCount = -1;
+                continue;
+            }
+
+            if(this->mPeakInUse > retainedBlocks - slab->blockCount) {
+                slab->freeCount = -1;
+                continue;
+            }
+
+            retainedBlocks -= slab->blockCount;
+        }
+
+        if(retainedBlocks < this->mTotalBlocks) {
+            // Unlink the nodes of the released Slabs from the free list
+            MemoryNode* prevNode = nullptr;
+            MemoryNode* node = this->mFreeListHead;
+            while(node != nullptr) {
+                MemoryNode* nextNode = node->next;
+                MemorySlab* slab = this->findSlab(node);
+
+                if(slab != nullptr && slab->freeCount != -1) {
+                    if(prevNode == nullptr) {
+                        this->mFreeListHead = nextNode;
+                    } else {
+                        prevNode->next = nextNode;
+                    }
+                } else {
+                    prevNode = node;
+                }
+                node = nextNode;
+            }
+            this->mFreeListTail = prevNode;
+
+            MemorySlab** link = &this->mSlabs;
+            while(*link != nullptr) {
+                MemorySlab* slab = *link;
+                if(slab->freeCount != -1) {
+                    *link = slab->next;
+                    releasedCount += slab->blockCount;
+                    delete[] slab->base;
+                    delete slab;
+                } else {
+                    link = &slab->next;
+                }
+            }
+
+            this->mTotalBlocks -= releasedCount;
+            this->mfreeBlocks -= releasedCount;
         }
 
-        void* freeBlock = memNode->block;
-        memNode->block = nullptr;
+        this->mPeakInUse = this->mTotalBlocks - this->mfreeBlocks;
 
-        if(this->mAllocatedListHead == nullptr) {
-            this->mAllocatedListHead = memNode;
-            this->mAllocatedListHead->next = nullptr;
-        } else {
-            memNode->next = this->mAllocatedListHead;
-            this->mAllocatedListHead = memNode;
+    } catch(const std::system_error& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+    }
+
+    return releasedCount;
+}
+
+int32_t MemoryPool::getTotalBlockCount() {
+    const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+    return this->mTotalBlocks;
+}
+
+// Note: Must be called with mMemoryPoolMutex held.
+// Returns nullptr if the free list is empty.
+void* MemoryPool::popFreeBlock() {
+    if(this->mfreeBlocks == 0) {
+        return nullptr;
+    }
+
+    // Get a free block from the free list
+    MemoryNode* memNode = this->mFreeListHead;
+    this->mFreeListHead = this->mFreeListHead->next;
+
+    if(this->mFreeListHead == nullptr) {
+        this->mFreeListTail = nullptr;
+    }
+
+    void* freeBlock = static_cast<void*>(memNode);
+
+    this->mfreeBlocks--;
+
+    int32_t inUse = this->mTotalBlocks - this->mfreeBlocks;
+    if(inUse > this->mPeakInUse) {
+        this->mPeakInUse = inUse;
+    }
+
+    return freeBlock;
+}
+
+// Note: Must be called with mMemoryPoolMutex held.
+int8_t MemoryPool::pushFreeBlock(void* block) {
+    if(this->mfreeBlocks >= this->mTotalBlocks) {
+        // Edge Cases, which will be hit if
+        // 1. Client tries to free some block of memory which was not Allocated by the Memory Pool
+        // 2. Client acquires "n" block of memory of certain size, and tries to free m (> n) blocks of that size
+
+        // Under normal operations, these conditions should not be hit
+        // As a General Rule, Perform as many Allocations as possible from the Memory Pool and not
+        // via the Memory Allocation APIs
+        return false;
+    }
+
+    MemoryNode* memNode = new(block) MemoryNode;
+    memNode->next = nullptr;
+
+    if(this->mFreeListHead == nullptr) {
+        this->mFreeListHead = memNode;
+        this->mFreeListTail = memNode;
+    } else {
+        this->mFreeListTail->next = memNode;
+        this->mFreeListTail = this->mFreeListTail->next;
+    }
+
+    this->mfreeBlocks++;
+    return true;
+}
+
+void* MemoryPool::getBlock() {
+    try {
+        const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+
+        void* freeBlock = this->popFreeBlock();
+        if(freeBlock == nullptr && this->grow() > 0) {
+            freeBlock = this->popFreeBlock();
+        }
+
+        if(freeBlock == nullptr) {
+            TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, this->mBlockSize);
+            throw std::bad_alloc();
         }
 
-        this->mfreeBlocks--;
         return freeBlock;
 
     } catch(const std::system_error& e){
@@ -117,163 +304,265 @@ void MemoryPool::freeBlock(void* block) {
 
     try {
         const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+        this->pushFreeBlock(block);
 
-        if(this->mAllocatedListHead == nullptr) {
-            // Edge Cases, which will be hit if
-            // 1. Client tries to free some block of memory which was not Allocated by the Memory Pool
-            // 2. Client acquires "n" block of memory of certain size, and tries to free m (> n) blocks of that size
+    } catch(const std::system_error& e){
+        TYPELOGV(MEMORY_POOL_INVALID_BLOCK_SIZE, this->mBlockSize);
 
-            // Under normal operations, these conditions should not be hit
-            // As a General Rule, Perform as many Allocations as possible from the Memory Pool and not
-            // via the Memory Allocation APIs
-            return;
-        }
+    } catch(const std::bad_alloc& e) {
+        TYPELOGV(MEMORY_POOL_INVALID_BLOCK_SIZE, this->mBlockSize);
+    }
+}
 
-        MemoryNode* memNode = this->mAllocatedListHead;
-        this->mAllocatedListHead = this->mAllocatedListHead->next;
-        memNode->block = block;
-        memNode->next = nullptr;
+int32_t MemoryPool::fetchBlocks(void** blocks, int32_t blockCount) {
+    int32_t fetchedCount = 0;
 
-        if(this->mFreeListHead == nullptr) {
-            this->mFreeListHead = memNode;
-            this->mFreeListTail = memNode;
-        } else {
-            this->mFreeListTail->next = memNode;
-            this->mFreeListTail = this->mFreeListTail->next;
+    try {
+        const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+
+        while(fetchedCount < blockCount) {
+            void* freeBlock = this->popFreeBlock();
+            if(freeBlock == nullptr) break;
+
+            blocks[fetchedCount++] = freeBlock;
         }
 
-        this->mfreeBlocks++;
+    } catch(const std::system_error& e) {
+        TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, this->mBlockSize);
+    }
 
-    } catch(const std::system_error& e){
-        TYPELOGV(MEMORY_POOL_INVALID_BLOCK_SIZE, this->mBlockSize);
+    return fetchedCount;
+}
 
-    } catch(const std::bad_alloc& e) {
+void MemoryPool::returnBlocks(void** blocks, int32_t blockCount) {
+    try {
+        const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+
+        for(int32_t i = 0; i < blockCount; i++) {
+            this->pushFreeBlock(blocks[i]);
+        }
+
+    } catch(const std::system_error& e) {
         TYPELOGV(MEMORY_POOL_INVALID_BLOCK_SIZE, this->mBlockSize);
     }
 }
 
-MemoryPool::~MemoryPool() {
+// Move the blocks cached by the Magazines back to the free list.
+// Magazines which are currently in use by their owner are skipped, since the owner
+// might be waiting on mMemoryPoolMutex (to refill or flush) while holding its Magazine.
+// Note: Must be called with mMemoryPoolMutex held.
+void MemoryPool::reclaimMagazines() {
+    for(MagazineCache* magazine = this->mMagazines; magazine != nullptr; magazine = magazine->mNext) {
+        if(magazine->mInUse.exchange(true, std::memory_order_acquire)) {
+            continue;
+        }
+
+        for(int32_t i = 0; i < magazine->mCount; i++) {
+            this->pushFreeBlock(magazine->mBlocks[i]);
+        }
+        magazine->mCount = 0;
+
+        magazine->mInUse.store(false, std::memory_order_release);
+    }
+}
+
+void* MemoryPool::getBlockSlowPath() {
     try {
-        MemoryNode* curNode = this->mFreeListHead;
-        while(curNode != nullptr) {
-            MemoryNode* nextNode = curNode->next;
-            if(curNode->block != nullptr) {
-                delete[] static_cast<char*> (curNode->block);
-                curNode->block = nullptr;
-            }
-            delete curNode;
-            curNode = nextNode;
+        const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+
+        void* freeBlock = this->popFreeBlock();
+        if(freeBlock == nullptr) {
+            this->reclaimMagazines();
+            freeBlock = this->popFreeBlock();
         }
 
-        curNode = this->mAllocatedListHead;
-        while(curNode != nullptr) {
-            MemoryNode* nextNode = curNode->next;
-            if(curNode->block != nullptr) {
-                delete[] static_cast<char*> (curNode->block);
-                curNode->block = nullptr;
-            }
+        if(freeBlock == nullptr && this->grow() > 0) {
+            freeBlock = this->popFreeBlock();
+        }
 
-            delete curNode;
-            curNode = nextNode;
+        if(freeBlock == nullptr) {
+            TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, this->mBlockSize);
+            throw std::bad_alloc();
         }
 
-    } catch(const std::bad_alloc& e) {}
+        return freeBlock;
+
+    } catch(const std::system_error& e) {
+        TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, this->mBlockSize);
+    }
+
+    throw std::bad_alloc();
 }
 
-MemoryPool* PoolWrapper::getMemoryPool(std::type_index typeIndex) {
-    if(this->mMemoryPoolRefs.find(typeIndex) == this->mMemoryPoolRefs.end()) {
-        return nullptr;
+void MemoryPool::registerMagazine(MagazineCache* magazine) {
+    const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+    magazine->mNext = this->mMagazines;
+    this->mMagazines = magazine;
+}
+
+void MemoryPool::unregisterMagazine(MagazineCache* magazine) {
+    const std::lock_guard<std::mutex> lock(this->mMemoryPoolMutex);
+    MagazineCache** link = &this->mMagazines;
+    while(*link != nullptr) {
+        if(*link == magazine) {
+            *link = magazine->mNext;
+            break;
+        }
+        link = &(*link)->mNext;
     }
-    return this->mMemoryPoolRefs[typeIndex];
+    magazine->mNext = nullptr;
 }
 
-int32_t PoolWrapper::makeAllocation(int32_t blockCount, int32_t blockSize, std::type_index typeIndex) {
-    // Sanity Checks
-    if(blockCount <= 0) return 0;
+// The free list is held in the blocks, hence only the Slabs need to be freed.
+MemoryPool::~MemoryPool() {
+    try {
+        MemorySlab* slab = this->mSlabs;
+        while(slab != nullptr) {
+            MemorySlab* nextSlab = slab->next;
+            delete[] slab->base;
+            delete slab;
+            slab = nextSlab;
+        }
+
+    } catch(const std::bad_alloc& e) {}
+}
 
+// Invoked on the first makeAllocation call for a type. The slot is checked again
+// under the lock, since multiple threads could be racing to create the pool.
+MemoryPool* PoolWrapper::createMemoryPool(int32_t blockSize, std::atomic<MemoryPool*>& slot) {
     try {
         const std::lock_guard<std::mutex> lock(this->mPoolWrapperMutex);
-        MemoryPool* memoryPool = getMemoryPool(typeIndex);
 
-        if(memoryPool == nullptr) {
-            memoryPool = new MemoryPool(blockSize);
-            this->mMemoryPoolRefs[typeIndex] = memoryPool;
+        MemoryPool* memoryPool = slot.load(std::memory_order_acquire);
+        if(memoryPool != nullptr) {
+            return memoryPool;
         }
 
+        memoryPool = new MemoryPool(blockSize);
+        this->mMemoryPools.push_back({memoryPool, &slot});
+        slot.store(memoryPool, std::memory_order_release);
+        return memoryPool;
+
     } catch(const std::bad_alloc& e) {
-        TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, blockSize, blockCount, 0);
-        return 0;
+        return nullptr;
 
     } catch(const std::system_error& e) {
-        TYPELOGV(MEMORY_POOL_ALLOCATION_FAILURE, blockSize, blockCount, 0);
-        return 0;
+        return nullptr;
     }
+}
 
-    // Now make the Actual Allocation
-    return this->mMemoryPoolRefs[typeIndex]->makeAllocation(blockCount);
+// Propagate the Exception to the Client, indicating Memory Block
+// Could not be retrieved.
+// Since the block of Memory returned by the pool will be directly
+// Used in combination with the Placement-New Operator, Hence simply returning
+// A Null Pointer will not work here.
+void* PoolWrapper::reportMissingPool(int32_t blockSize) {
+    TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, blockSize);
+    throw std::bad_alloc();
 }
 
-void* PoolWrapper::getBlock(int32_t blockSize, std::type_index typeIndex) {
-     MemoryPool* memoryPool = nullptr;
+int32_t PoolWrapper::releaseIdleSlabs() {
+    std::vector<MemoryPool*> memoryPools;
 
     try {
         const std::lock_guard<std::mutex> lock(this->mPoolWrapperMutex);
-        memoryPool = getMemoryPool(typeIndex);
-
-        // Propagate the Exception to the Client, indicating Memory Block
-        // Could not be retrieved.
-        // Since the block of Memory returned by the pool will be directly
-        // Used in combination with the Placement-New Operator, Hence simply returning
-        // A Null Pointer will not work here.
-        if(memoryPool == nullptr) {
-            TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, blockSize);
-            throw std::bad_alloc();
+        for(auto& entry: this->mMemoryPools) {
+            memoryPools.push_back(entry.first);
         }
 
     } catch(const std::system_error& e) {
-        TYPELOGV(MEMORY_POOL_BLOCK_RETRIEVAL_FAILURE, blockSize);
-        throw std::bad_alloc();
+        return 0;
+    }
+
+    int32_t releasedCount = 0;
+    for(MemoryPool* memoryPool: memoryPools) {
+        releasedCount += memoryPool->releaseIdleSlabs();
     }
 
-    return memoryPool->getBlock();
+    return releasedCount;
 }
 
-void PoolWrapper::freeBlock(std::type_index typeIndex, void* block) {
-    if(block == nullptr) return;
-    MemoryPool* memoryPool = nullptr;
+PoolWrapper::~PoolWrapper() {
+    for(auto& entry: this->mMemoryPools) {
+        entry.second->store(nullptr);
+        delete entry.first;
+    }
+    this->mMemoryPools.clear();
+}
 
-    try {
-        const std::lock_guard<std::mutex> lock(this->mPoolWrapperMutex);
-        memoryPool = getMemoryPool(typeIndex);
-
-        // Edge Case
-        // This will be hit if the Client tries to free some block of Memory
-        // which was never allocated through the MemoryManager
-        // In such cases, simply ignore the freeBlock call.
-        if(memoryPool == nullptr) {
-            return;
-        }
+MagazineCache::MagazineCache() {
+    this->mCount = 0;
+    this->mInUse.store(false);
+    this->mPool = nullptr;
+    this->mNext = nullptr;
+}
 
-    } catch(const std::system_error& e) {
-        return;
+// Invoked on thread exit, return all the cached blocks to the shared pool.
+MagazineCache::~MagazineCache() {
+    if(this->mPool == nullptr) return;
+
+    this->acquire();
+    this->mPool->returnBlocks(this->mBlocks, this->mCount);
+    this->mCount = 0;
+    this->release();
+
+    this->mPool->unregisterMagazine(this);
+    this->mPool = nullptr;
+}
+
+// The flag is only contended when another thread is reclaiming the blocks of this Magazine.
+void MagazineCache::acquire() {
+    while(this->mInUse.exchange(true, std::memory_order_acquire)) {
+        std::this_thread::yield();
     }
+}
 
-    if(memoryPool != nullptr) {
-        memoryPool->freeBlock(block);
+void MagazineCache::release() {
+    this->mInUse.store(false, std::memory_order_release);
+}
+
+void MagazineCache::attach(MemoryPool* pool) {
+    this->mPool = pool;
+    pool->registerMagazine(this);
+}
+
+void* MagazineCache::getBlock() {
+    this->acquire();
+
+    if(this->mCount == 0) {
+        this->mCount = this->mPool->fetchBlocks(this->mBlocks, MAGAZINE_BATCH_SIZE);
+    }
+
+    if(this->mCount > 0) {
+        void* block = this->mBlocks[--this->mCount];
+        this->release();
+        return block;
     }
+
+    // Shared pool is empty as well, release the Magazine before reclaiming
+    // the blocks cached by the other threads.
+    this->release();
+    return this->mPool->getBlockSlowPath();
 }
 
-PoolWrapper::~PoolWrapper() {
-    for(std::pair<std::type_index, MemoryPool*> entry: this->mMemoryPoolRefs) {
-        if(entry.second != nullptr) {
-            delete entry.second;
-            entry.second = nullptr;
+void MagazineCache::freeBlock(void* block) {
+    this->acquire();
+
+    if(this->mCount == MAGAZINE_CAPACITY) {
+        // Flush the older half, the recently freed blocks are more likely to be cache-hot.
+        this->mPool->returnBlocks(this->mBlocks, MAGAZINE_BATCH_SIZE);
+        for(int32_t i = MAGAZINE_BATCH_SIZE; i < MAGAZINE_CAPACITY; i++) {
+            this->mBlocks[i - MAGAZINE_BATCH_SIZE] = this->mBlocks[i];
         }
+        this->mCount -= MAGAZINE_BATCH_SIZE;
     }
+
+    this->mBlocks[this->mCount++] = block;
+    this->release();
 }
 
 static std::shared_ptr<PoolWrapper> poolWrapperInstance(new PoolWrapper());
 
-std::shared_ptr<PoolWrapper> getPoolWrapper() {
+const std::shared_ptr<PoolWrapper>& getPoolWrapper() {
     return poolWrapperInstance;
 }
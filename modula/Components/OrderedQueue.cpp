@@ -1,19 +1,125 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <thread>
+
 #include "OrderedQueue.h"
 
-OrderedQueue::OrderedQueue() {
-    this->mElementCount = 0;
+IngestRing::IngestRing(uint32_t capacity) {
+    this->mCells = new IngestCell[capacity];
+    this->mMask = capacity - 1;
+    this->mTail.store(0);
+    this->mHead = 0;
+
+    for(uint32_t i = 0; i < capacity; i++) {
+        this->mCells[i].mSequence.store(i, std::memory_order_relaxed);
+        this->mCells[i].mData = nullptr;
+    }
+}
+
+int8_t IngestRing::push(Message* message) {
+    IngestCell* cell = nullptr;
+    uint32_t pos = this->mTail.load(std::memory_order_relaxed);
+
+    while(true) {
+        cell = &this->mCells[pos & this->mMask];
+        uint32_t sequence = cell->mSequence.load(std::memory_order_acquire);
+        int32_t diff = (int32_t)(sequence - pos);
+
+        if(diff == 0) {
+            // Cell is free, try to claim it.
+            if(this->mTail.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed)) {
+                break;
+            }
+        } else if(diff < 0) {
+            // Cell still holds a Message which is yet to be read, i.e. the Ring is full.
+            return false;
+        } else {
+            // Cell was claimed by another producer
+            pos = this->mTail.load(std::memory_order_relaxed);
+        }
+    }
+
+    cell->mData = message;
+    cell->mSequence.store(pos + 1, std::memory_order_release);
+    return true;
+}
+
+Message* IngestRing::pop() {
+    IngestCell* cell = &this->mCells[this->mHead & this->mMask];
+    uint32_t sequence = cell->mSequence.load(std::memory_order_acquire);
+
+    if((int32_t)(sequence - (this->mHead + 1)) < 0) {
+        // Not yet published
+        return nullptr;
+    }
+
+    Message* message = cell->mData;
+    cell->mSequence.store(this->mHead + this->mMask + 1, std::memory_order_release);
+    this->mHead++;
+
+    return message;
+}
+
+IngestRing::~IngestRing() {
+    delete[] this->mCells;
+}
+
+OrderedQueue::OrderedQueue(OrderedQueueMode queueMode) {
+    this->mElementCount.store(0);
+    this->mOverflowCount.store(0);
+    this->mConsumerSleeping.store(false);
+    this->mQueueMode = queueMode;
+    this->mLastBatchSize.store(0);
+    this->mBatchCount.store(0);
+    this->mBatchedMessageCount.store(0);
+
+    for(int32_t i = 0; i < INGEST_RING_CLASSES; i++) {
+        this->mIngestRings[i] = nullptr;
+    }
+
+    if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+        for(int32_t i = 0; i < INGEST_RING_CLASSES; i++) {
+            this->mIngestRings[i] = new IngestRing(INGEST_RING_CAPACITY);
+        }
+    }
 }
 
 int8_t OrderedQueue::addAndWakeup(Message* queueItem) {
+    if(queueItem == nullptr) return false;
+    if(queueItem->getPriority() < SERVER_CLEANUP_TRIGGER_PRIORITY) return false;
+
+    if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+        int32_t priorityClass = queueItem->getPriority() - SERVER_CLEANUP_TRIGGER_PRIORITY;
+        if(priorityClass >= INGEST_RING_CLASSES) {
+            priorityClass = INGEST_RING_CLASSES - 1;
+        }
+
+        try {
+            if(!this->mIngestRings[priorityClass]->push(queueItem)) {
+                const std::lock_guard<std::mutex> lock(this->mOverflowMutex);
+                this->mOverflow.push_back(queueItem);
+                this->mOverflowCount.fetch_add(1);
+            }
+
+            this->mElementCount.fetch_add(1);
+
+            // Only a sleeping consumer needs to be woken up.
+            if(this->mConsumerSleeping.load()) {
+                const std::lock_guard<std::mutex> lock(this->mOrderedQueueMutex);
+                this->mOrderedQueueCondition.notify_one();
+            }
+            return true;
+
+        } catch(const std::exception& e) {
+            TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+            return false;
+        }
+    }
+
     try {
         const std::unique_lock<std::mutex> lock(this->mOrderedQueueMutex);
 
-        if(queueItem == nullptr) return false;
-        if(queueItem->getPriority() < SERVER_CLEANUP_TRIGGER_PRIORITY) return false;
-
         this->mOrderedQueue.push(queueItem);
         this->mElementCount++;
 
@@ -32,6 +138,22 @@ void OrderedQueue::wait() {
     try {
         std::unique_lock<std::mutex> lock(this->mOrderedQueueMutex);
 
+        if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+            // Producers check this flag after updating the element count,
+            // hence either the consumer observes the new count, or the producer
+            // observes the flag and issues the notification.
+            this->mConsumerSleeping.store(true);
+            while(this->mElementCount.load() == 0) {
+                this->mOrderedQueueCondition.wait(lock);
+            }
+            this->mConsumerSleeping.store(false);
+
+            // The Queue lock is not needed to consume from the Ingest Rings.
+            lock.unlock();
+            this->orderedQueueConsumerHook();
+            return;
+        }
+
         while(this->mElementCount == 0) {
             this->mOrderedQueueCondition.wait(lock);
         }
@@ -47,18 +169,114 @@ void OrderedQueue::wait() {
     }
 }
 
+int32_t OrderedQueue::waitForBatch(int32_t maxBatchSize) {
+    std::vector<Message*> batch;
+
+    try {
+        if(maxBatchSize < 1) {
+            maxBatchSize = 1;
+        }
+        batch.reserve(maxBatchSize);
+
+        std::unique_lock<std::mutex> lock(this->mOrderedQueueMutex);
+
+        if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+            this->mConsumerSleeping.store(true);
+        }
+
+        while(this->mElementCount.load() == 0) {
+            this->mOrderedQueueCondition.wait(lock);
+        }
+        this->mConsumerSleeping.store(false);
+
+        if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+            // Ingest Rings can be drained without the Queue lock.
+            lock.unlock();
+        }
+
+        while((int32_t)batch.size() < maxBatchSize && this->hasPendingTasks()) {
+            Message* message = this->pop();
+            if(message != nullptr) {
+                batch.push_back(message);
+            }
+        }
+
+        if(lock.owns_lock()) {
+            lock.unlock();
+        }
+
+    } catch(const std::exception& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+    }
+
+    if(batch.empty()) {
+        return 0;
+    }
+
+    int32_t batchSize = batch.size();
+    this->mLastBatchSize.store(batchSize);
+    this->mBatchCount.fetch_add(1);
+    this->mBatchedMessageCount.fetch_add(batchSize);
+
+    this->orderedQueueBatchHook(batch);
+    return batchSize;
+}
+
+int32_t OrderedQueue::getLastBatchSize() {
+    return this->mLastBatchSize.load();
+}
+
+double OrderedQueue::getAverageBatchSize() {
+    int64_t batchCount = this->mBatchCount.load();
+    if(batchCount == 0) {
+        return 0.0;
+    }
+
+    return (double)this->mBatchedMessageCount.load() / batchCount;
+}
+
 int8_t OrderedQueue::hasPendingTasks() {
     return (this->mElementCount > 0);
 }
 
+// Move all the published Messages from the Ingest Rings (and the overflow list)
+// to the consumer's private Ordered Structure.
+void OrderedQueue::drainIngestRings() {
+    for(int32_t i = 0; i < INGEST_RING_CLASSES; i++) {
+        Message* message = nullptr;
+        while((message = this->mIngestRings[i]->pop()) != nullptr) {
+            this->mOrderedQueue.push(message);
+        }
+    }
+
+    if(this->mOverflowCount.load() > 0) {
+        const std::lock_guard<std::mutex> lock(this->mOverflowMutex);
+        for(Message* message: this->mOverflow) {
+            this->mOrderedQueue.push(message);
+        }
+        this->mOverflow.clear();
+        this->mOverflowCount.store(0);
+    }
+}
+
 Message* OrderedQueue::pop() {
     if(this->mElementCount == 0) {
         return nullptr;
     }
 
+    if(this->mQueueMode == ORDERED_QUEUE_INGEST_RING) {
+        this->drainIngestRings();
+
+        // The element count is updated after publishing, hence the Message is guaranteed
+        // to show up, it might only be waiting behind a producer which is mid-publish.
+        while(this->mOrderedQueue.empty()) {
+            std::this_thread::yield();
+            this->drainIngestRings();
+        }
+    }
+
     // No need to acquire lock. Consumer should call the "pop" routine
     // while holding the lock acquired as part of "wait" routine.
-
     Message* queueItem = this->mOrderedQueue.top();
     this->mOrderedQueue.pop();
     this->mElementCount--;
@@ -78,4 +296,15 @@ void OrderedQueue::forcefulAwake() {
     this->addAndWakeup(message);
 }
 
-OrderedQueue::~OrderedQueue() {}
+OrderedQueueMode OrderedQueue::getQueueMode() {
+    return this->mQueueMode;
+}
+
+OrderedQueue::~OrderedQueue() {
+    for(int32_t i = 0; i < INGEST_RING_CLASSES; i++) {
+        if(this->mIngestRings[i] != nullptr) {
+            delete this->mIngestRings[i];
+            this->mIngestRings[i] = nullptr;
+        }
+    }
+}
@@ -0,0 +1,313 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <poll.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <cstdio>
+#include <cstring>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <sys/eventfd.h>
+
+#include "Logger.h"
+#include "SharedRing.h"
+
+#define SQ_OFFSET (sizeof(SharedRingHeader))
+#define CQ_OFFSET (SQ_OFFSET + (size_t)SHARED_RING_ENTRIES * REQ_BUFFER_SIZE)
+#define RING_SIZE (CQ_OFFSET + (size_t)SHARED_RING_ENTRIES * sizeof(int64_t))
+
+SharedRing::SharedRing() {
+    this->mMemFd = -1;
+    this->mSqEventFd = -1;
+    this->mCqEventFd = -1;
+    this->mSize = 0;
+    this->mHeader = nullptr;
+    this->mSqEntries = nullptr;
+    this->mCqEntries = nullptr;
+}
+
+int8_t SharedRing::map() {
+    void* base = mmap(nullptr, RING_SIZE, PROT_READ | PROT_WRITE, MAP_SHARED, this->mMemFd, 0);
+    if(base == MAP_FAILED) {
+        TYPELOGV(ERRNO_LOG, "mmap", strerror(errno));
+        return false;
+    }
+
+    this->mSize = RING_SIZE;
+    this->mHeader = (SharedRingHeader*)base;
+    this->mSqEntries = (char*)base + SQ_OFFSET;
+    this->mCqEntries = (int64_t*)((char*)base + CQ_OFFSET);
+    return true;
+}
+
+int32_t SharedRing::create(int32_t cqEventFd) {
+    this->mMemFd = memfd_create("urm_ring", MFD_CLOEXEC | MFD_ALLOW_SEALING);
+    if(this->mMemFd < 0) {
+        TYPELOGV(ERRNO_LOG, "memfd_create", strerror(errno));
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    if(ftruncate(this->mMemFd, RING_SIZE) < 0) {
+        TYPELOGV(ERRNO_LOG, "ftruncate", strerror(errno));
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    // The size is sealed, so that the Server can safely access the complete mapping.
+    if(fcntl(this->mMemFd, F_ADD_SEALS, F_SEAL_SHRINK | F_SEAL_GROW | F_SEAL_SEAL) < 0) {
+        TYPELOGV(ERRNO_LOG, "fcntl", strerror(errno));
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    this->mSqEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    if(cqEventFd >= 0) {
+        this->mCqEventFd = fcntl(cqEventFd, F_DUPFD_CLOEXEC, 0);
+    } else {
+        this->mCqEventFd = eventfd(0, EFD_CLOEXEC | EFD_NONBLOCK);
+    }
+    if(this->mSqEventFd < 0 || this->mCqEventFd < 0) {
+        TYPELOGV(ERRNO_LOG, "eventfd", strerror(errno));
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    if(!this->map()) {
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    // A freshly truncated memfd is zero filled, hence only the constants need to be set.
+    this->mHeader->mMagic = SHARED_RING_MAGIC;
+    this->mHeader->mEntries = SHARED_RING_ENTRIES;
+    return RC_SUCCESS;
+}
+
+// The doorbells passed by the client are read and written by the Server threads, hence they
+// must be eventfds, and must not block. The file status flags are shared with the client,
+// non-blocking mode is forced on them (the client's doorbells are non-blocking anyway).
+static int8_t isValidDoorbell(int32_t fd) {
+    char procPath[64];
+    char target[64];
+    std::snprintf(procPath, sizeof(procPath), "/proc/self/fd/%d", fd);
+
+    ssize_t length = readlink(procPath, target, sizeof(target) - 1);
+    if(length < 0) {
+        TYPELOGV(ERRNO_LOG, "readlink", strerror(errno));
+        return false;
+    }
+    target[length] = '\0';
+
+    if(std::strcmp(target, "anon_inode:[eventfd]") != 0) {
+        return false;
+    }
+
+    int32_t flags = fcntl(fd, F_GETFL);
+    if(flags < 0) {
+        return false;
+    }
+
+    if(!(flags & O_NONBLOCK) && fcntl(fd, F_SETFL, flags | O_NONBLOCK) < 0) {
+        TYPELOGV(ERRNO_LOG, "fcntl", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+int32_t SharedRing::attach(int32_t memFd, int32_t sqEventFd, int32_t cqEventFd) {
+    this->mMemFd = memFd;
+    this->mSqEventFd = sqEventFd;
+    this->mCqEventFd = cqEventFd;
+
+    struct stat memStat;
+    if(fstat(this->mMemFd, &memStat) < 0 || (size_t)memStat.st_size != RING_SIZE) {
+        LOGE("URM_SHARED_RING", "Shared Ring rejected, unexpected region size");
+        return RC_BAD_ARG;
+    }
+
+    int32_t seals = fcntl(this->mMemFd, F_GET_SEALS);
+    if(seals < 0 || !(seals & F_SEAL_SHRINK)) {
+        LOGE("URM_SHARED_RING", "Shared Ring rejected, region size is not sealed");
+        return RC_BAD_ARG;
+    }
+
+    if(!isValidDoorbell(this->mSqEventFd) || !isValidDoorbell(this->mCqEventFd)) {
+        LOGE("URM_SHARED_RING", "Shared Ring rejected, doorbells must be eventfds");
+        return RC_BAD_ARG;
+    }
+
+    if(!this->map()) {
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    if(this->mHeader->mMagic != SHARED_RING_MAGIC || this->mHeader->mEntries != SHARED_RING_ENTRIES) {
+        LOGE("URM_SHARED_RING", "Shared Ring rejected, invalid header");
+        return RC_BAD_ARG;
+    }
+
+    return RC_SUCCESS;
+}
+
+void SharedRing::ringDoorbell(int32_t eventFd) {
+    uint64_t count = 1;
+    if(write(eventFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+    }
+}
+
+int8_t SharedRing::submit(const char* buf, size_t bufSize) {
+    if(bufSize > REQ_BUFFER_SIZE) {
+        return false;
+    }
+
+    uint32_t tail = this->mHeader->mSqTail.load(std::memory_order_relaxed);
+    uint32_t head = this->mHeader->mSqHead.load(std::memory_order_acquire);
+    if(tail - head >= SHARED_RING_ENTRIES) {
+        return false;
+    }
+
+    std::memcpy(this->mSqEntries + (size_t)(tail & SHARED_RING_MASK) * REQ_BUFFER_SIZE, buf, bufSize);
+    this->mHeader->mSqTail.store(tail + 1, std::memory_order_release);
+
+    // Pairs with the fence in prepareSqWait: either the Server observes the new tail,
+    // or the client observes the NeedWakeup flag.
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(this->mHeader->mSqNeedWakeup.load(std::memory_order_relaxed) &&
+       this->mHeader->mSqNeedWakeup.exchange(0)) {
+        this->ringDoorbell(this->mSqEventFd);
+    }
+
+    return true;
+}
+
+int8_t SharedRing::consume(char* buf) {
+    uint32_t head = this->mHeader->mSqHead.load(std::memory_order_relaxed);
+    uint32_t tail = this->mHeader->mSqTail.load(std::memory_order_acquire);
+    if(head == tail) {
+        return 0;
+    }
+
+    if(tail - head > SHARED_RING_ENTRIES) {
+        return -1;
+    }
+
+    std::memcpy(buf, this->mSqEntries + (size_t)(head & SHARED_RING_MASK) * REQ_BUFFER_SIZE, REQ_BUFFER_SIZE);
+    this->mHeader->mSqHead.store(head + 1, std::memory_order_release);
+    return 1;
+}
+
+int8_t SharedRing::prepareSqWait() {
+    this->mHeader->mSqNeedWakeup.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint32_t head = this->mHeader->mSqHead.load(std::memory_order_relaxed);
+    if(this->mHeader->mSqTail.load(std::memory_order_acquire) != head) {
+        this->mHeader->mSqNeedWakeup.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void SharedRing::drainSqDoorbell() {
+    uint64_t count = 0;
+    if(read(this->mSqEventFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        TYPELOGV(ERRNO_LOG, "read", strerror(errno));
+    }
+}
+
+int8_t SharedRing::complete(int64_t result) {
+    uint32_t tail = this->mHeader->mCqTail.load(std::memory_order_relaxed);
+    uint32_t head = this->mHeader->mCqHead.load(std::memory_order_acquire);
+    if(tail - head >= SHARED_RING_ENTRIES) {
+        return false;
+    }
+
+    this->mCqEntries[tail & SHARED_RING_MASK] = result;
+    this->mHeader->mCqTail.store(tail + 1, std::memory_order_release);
+
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    if(this->mHeader->mCqNeedWakeup.load(std::memory_order_relaxed) &&
+       this->mHeader->mCqNeedWakeup.exchange(0)) {
+        this->ringDoorbell(this->mCqEventFd);
+    }
+
+    return true;
+}
+
+int8_t SharedRing::tryReap(int64_t& result) {
+    uint32_t head = this->mHeader->mCqHead.load(std::memory_order_relaxed);
+    if(this->mHeader->mCqTail.load(std::memory_order_acquire) == head) {
+        return false;
+    }
+
+    result = this->mCqEntries[head & SHARED_RING_MASK];
+    this->mHeader->mCqHead.store(head + 1, std::memory_order_release);
+    return true;
+}
+
+int8_t SharedRing::prepareCqWait() {
+    this->mHeader->mCqNeedWakeup.store(1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+
+    uint32_t head = this->mHeader->mCqHead.load(std::memory_order_relaxed);
+    if(this->mHeader->mCqTail.load(std::memory_order_acquire) != head) {
+        this->mHeader->mCqNeedWakeup.store(0, std::memory_order_relaxed);
+        return false;
+    }
+
+    return true;
+}
+
+void SharedRing::drainCqDoorbell() {
+    uint64_t count = 0;
+    if(read(this->mCqEventFd, &count, sizeof(count)) < 0 && errno != EAGAIN) {
+        TYPELOGV(ERRNO_LOG, "read", strerror(errno));
+    }
+}
+
+int8_t SharedRing::reap(int64_t& result, int32_t timeout) {
+    while(true) {
+        if(this->tryReap(result)) {
+            return true;
+        }
+
+        if(!this->prepareCqWait()) {
+            continue;
+        }
+
+        struct pollfd pollInfo;
+        pollInfo.fd = this->mCqEventFd;
+        pollInfo.events = POLLIN;
+        if(poll(&pollInfo, 1, timeout) <= 0) {
+            this->mHeader->mCqNeedWakeup.store(0, std::memory_order_relaxed);
+            return false;
+        }
+
+        this->drainCqDoorbell();
+    }
+}
+
+int32_t SharedRing::getMemFd() {
+    return this->mMemFd;
+}
+
+int32_t SharedRing::getSqEventFd() {
+    return this->mSqEventFd;
+}
+
+int32_t SharedRing::getCqEventFd() {
+    return this->mCqEventFd;
+}
+
+SharedRing::~SharedRing() {
+    if(this->mHeader != nullptr) {
+        munmap(this->mHeader, this->mSize);
+        this->mHeader = nullptr;
+    }
+
+    int32_t fds[] = {this->mMemFd, this->mSqEventFd, this->mCqEventFd};
+    for(int32_t fd: fds) {
+        if(fd >= 0) {
+            close(fd);
+        }
+    }
+}
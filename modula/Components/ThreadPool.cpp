@@ -2,6 +2,12 @@
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include "ThreadPool.h"
+#include "AuxRoutines.h"
+
+// Identifies the Pool (and the Deque) owned by the current thread, if it is a
+// Work Stealing worker. Used to keep the tasks submitted by a worker local to it.
+static thread_local ThreadPool* tCurrentPool = nullptr;
+static thread_local int32_t tWorkerSlot = -1;
 
 TaskNode::TaskNode() {
     this->taskCallback = nullptr;
@@ -70,6 +76,155 @@ TaskQueue::~TaskQueue() {
     } catch(const std::exception& e) {}
 }
 
+TaskDeque::TaskDeque() {
+    this->mTop.store(0);
+    this->mBottom.store(0);
+    for(int32_t i = 0; i < TASK_DEQUE_CAPACITY; i++) {
+        this->mBuffer[i].store(nullptr, std::memory_order_relaxed);
+    }
+}
+
+int8_t TaskDeque::push(TaskNode* taskNode) {
+    int64_t bottom = this->mBottom.load(std::memory_order_relaxed);
+    int64_t top = this->mTop.load(std::memory_order_acquire);
+
+    if(bottom - top >= TASK_DEQUE_CAPACITY) {
+        return false;
+    }
+
+    this->mBuffer[bottom & (TASK_DEQUE_CAPACITY - 1)].store(taskNode, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    this->mBottom.store(bottom + 1, std::memory_order_relaxed);
+
+    return true;
+}
+
+TaskNode* TaskDeque::take() {
+    int64_t bottom = this->mBottom.load(std::memory_order_relaxed) - 1;
+    this->mBottom.store(bottom, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t top = this->mTop.load(std::memory_order_relaxed);
+
+    if(top > bottom) {
+        // Deque is empty
+        this->mBottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    TaskNode* taskNode = this->mBuffer[bottom & (TASK_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+    if(top == bottom) {
+        // Last Task, race against the thieves for it.
+        if(!this->mTop.compare_exchange_strong(top, top + 1,
+                                               std::memory_order_seq_cst,
+                                               std::memory_order_relaxed)) {
+            taskNode = nullptr;
+        }
+        this->mBottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+
+    return taskNode;
+}
+
+TaskNode* TaskDeque::steal() {
+    int64_t top = this->mTop.load(std::memory_order_acquire);
+    std::atomic_thread_fence(std::memory_order_seq_cst);
+    int64_t bottom = this->mBottom.load(std::memory_order_acquire);
+
+    if(top >= bottom) {
+        return nullptr;
+    }
+
+    TaskNode* taskNode = this->mBuffer[top & (TASK_DEQUE_CAPACITY - 1)].load(std::memory_order_relaxed);
+    if(!this->mTop.compare_exchange_strong(top, top + 1,
+                                           std::memory_order_seq_cst,
+                                           std::memory_order_relaxed)) {
+        // Lost the race to the owner or another thief
+        return nullptr;
+    }
+
+    return taskNode;
+}
+
+TaskLanes::TaskLanes() {
+    this->mSize = 0;
+    this->mPolicy = TASK_LANE_STRICT;
+
+    for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+        this->mWeights[lane] = 1;
+        this->mCredits[lane] = 1;
+    }
+}
+
+void TaskLanes::setPolicy(TaskLanePolicy policy, const int32_t weights[TOTAL_TASK_LANES]) {
+    this->mPolicy = policy;
+
+    for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+        this->mWeights[lane] = 1;
+        if(weights != nullptr && weights[lane] > 0) {
+            this->mWeights[lane] = weights[lane];
+        }
+        this->mCredits[lane] = this->mWeights[lane];
+    }
+}
+
+void TaskLanes::add(TaskNode* taskNode, int32_t lane) {
+    if(taskNode == nullptr) return;
+
+    if(lane < 0 || lane >= TOTAL_TASK_LANES) {
+        lane = TASK_LANE_NORMAL;
+    }
+
+    this->mLanes[lane].add(taskNode);
+    this->mSize++;
+}
+
+TaskNode* TaskLanes::poll() {
+    if(this->mSize == 0) {
+        return nullptr;
+    }
+
+    if(this->mPolicy == TASK_LANE_STRICT) {
+        for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+            if(!this->mLanes[lane].isEmpty()) {
+                this->mSize--;
+                return this->mLanes[lane].poll();
+            }
+        }
+        return nullptr;
+    }
+
+    // Weighted: Serve the highest non-empty Lane which still has credits left.
+    // If none of the non-empty Lanes have credits left, replenish and retry.
+    for(int32_t pass = 0; pass < 2; pass++) {
+        for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+            if(!this->mLanes[lane].isEmpty() && this->mCredits[lane] > 0) {
+                this->mCredits[lane]--;
+                this->mSize--;
+                return this->mLanes[lane].poll();
+            }
+        }
+
+        for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+            this->mCredits[lane] = this->mWeights[lane];
+        }
+    }
+
+    return nullptr;
+}
+
+int8_t TaskLanes::isEmpty() {
+    return this->mSize == 0;
+}
+
+int32_t TaskLanes::getSize() {
+    return this->mSize;
+}
+
+int32_t TaskLanes::getLaneSize(int32_t lane) {
+    if(lane < 0 || lane >= TOTAL_TASK_LANES) return 0;
+    return this->mLanes[lane].getSize();
+}
+
 int8_t ThreadPool::threadRoutineHelper(int8_t isCoreThread) {
     try {
         std::unique_lock<std::mutex> threadPoolUniqueLock(this->mThreadPoolMutex);
@@ -148,8 +303,32 @@ int8_t ThreadPool::addNewThread(int8_t isCoreThread) {
 
     thNode->next = nullptr;
 
+    // In Work Stealing mode, each worker is assigned a Deque.
+    int32_t workerSlot = -1;
+    if(this->mPoolMode == THREAD_POOL_WORK_STEALING) {
+        if(this->mFreeWorkerSlots.empty()) {
+            FreeBlock<ThreadNode>(static_cast<void*>(thNode));
+            return false;
+        }
+        workerSlot = this->mFreeWorkerSlots.back();
+        this->mFreeWorkerSlots.pop_back();
+    }
+
     try {
-        auto threadStartRoutine = ([this](int8_t isCoreThread) {
+        auto threadStartRoutine = ([this](int8_t isCoreThread, int32_t workerSlot) {
+            AuxRoutines::applyThreadConfig(THREAD_CLASS_WORKER);
+
+            if(this->mPoolMode == THREAD_POOL_WORK_STEALING) {
+                tCurrentPool = this;
+                tWorkerSlot = workerSlot;
+
+                while(true) {
+                    if(workStealingRoutineHelper(isCoreThread, workerSlot)) {
+                        return;
+                    }
+                }
+            }
+
             while(true) {
                 if(threadRoutineHelper(isCoreThread)) {
                     return;
@@ -158,14 +337,20 @@ int8_t ThreadPool::addNewThread(int8_t isCoreThread) {
         });
 
         try {
-            thNode->th = new std::thread(threadStartRoutine, isCoreThread);
+            thNode->th = new std::thread(threadStartRoutine, isCoreThread, workerSlot);
 
         } catch(const std::system_error& e) {
             FreeBlock<ThreadNode>(static_cast<void*>(thNode));
+            if(workerSlot != -1) {
+                this->mFreeWorkerSlots.push_back(workerSlot);
+            }
             throw;
 
         } catch(const std::bad_alloc& e) {
             FreeBlock<ThreadNode>(static_cast<void*>(thNode));
+            if(workerSlot != -1) {
+                this->mFreeWorkerSlots.push_back(workerSlot);
+            }
             throw;
         }
 
@@ -187,8 +372,12 @@ int8_t ThreadPool::addNewThread(int8_t isCoreThread) {
     return false;
 }
 
-ThreadPool::ThreadPool(int32_t desiredCapacity, int32_t maxCapacity) {
+ThreadPool::ThreadPool(int32_t desiredCapacity, int32_t maxCapacity, ThreadPoolMode poolMode) {
     this->mThreadQueueHead = this->mThreadQueueTail = nullptr;
+    this->mPoolMode = poolMode;
+    this->mPendingTasksCount.store(0);
+    this->mSharedTasksCount.store(0);
+    this->mIdleWorkersCount.store(0);
 
     this->mDesiredPoolCapacity = desiredCapacity;
     this->mCurrentThreadsCount = 0;
@@ -200,21 +389,38 @@ ThreadPool::ThreadPool(int32_t desiredCapacity, int32_t maxCapacity) {
 
     this->mTotalTasksCount = 0;
     this->mTerminatePool = false;
+    this->mCurrentTasks = nullptr;
 
     try {
-        this->mCurrentTasks = new TaskQueue;
+        this->mCurrentTasks = new TaskLanes;
+
+        if(this->mPoolMode == THREAD_POOL_WORK_STEALING) {
+            this->mWorkerDeques.reserve(this->mMaxPoolCapacity);
+            this->mFreeWorkerSlots.reserve(this->mMaxPoolCapacity);
+
+            for(int32_t i = 0; i < this->mMaxPoolCapacity; i++) {
+                this->mWorkerDeques.push_back(new TaskDeque);
+            }
+
+            // Lower slots are handed out first
+            for(int32_t i = this->mMaxPoolCapacity - 1; i >= 0; i--) {
+                this->mFreeWorkerSlots.push_back(i);
+            }
+        }
 
     } catch(const std::bad_alloc& e) {
         TYPELOGV(THREAD_POOL_INIT_FAILURE, e.what());
 
         if(this->mCurrentTasks != nullptr) {
             delete this->mCurrentTasks;
+            this->mCurrentTasks = nullptr;
         }
     }
 
     MakeAlloc<ThreadNode>(this->mMaxPoolCapacity + 1);
-    MakeAlloc<TaskNode>((this->mMaxPoolCapacity + 1) * maxLoadPerThread);
-    MakeAlloc<std::function<void(void*)>>((this->mMaxPoolCapacity + 1) * maxLoadPerThread);
+    // Additional maxLoadPerThread blocks are reserved as the Critical Lane headroom
+    MakeAlloc<TaskNode>((this->mMaxPoolCapacity + 2) * maxLoadPerThread);
+    MakeAlloc<std::function<void(void*)>>((this->mMaxPoolCapacity + 2) * maxLoadPerThread);
 
     // Add desired number of Threads to the Pool
     for(int32_t i = 0; i < this->mDesiredPoolCapacity; i++) {
@@ -257,7 +463,187 @@ TaskNode* ThreadPool::createTaskNode(std::function<void(void*)> callback, void*
     return taskNode;
 }
 
-int8_t ThreadPool::enqueueTask(std::function<void(void*)> taskCallback, void* args) {
+// Pick up the next Task for the worker: its own Deque is checked first, followed by
+// the shared Task Queue, and finally the other workers' Deques.
+TaskNode* ThreadPool::findTask(int32_t workerSlot) {
+    TaskNode* taskNode = this->mWorkerDeques[workerSlot]->take();
+    if(taskNode != nullptr) {
+        return taskNode;
+    }
+
+    if(this->mSharedTasksCount.load() > 0) {
+        const std::lock_guard<std::mutex> lock(this->mThreadPoolMutex);
+        taskNode = this->mCurrentTasks->poll();
+        if(taskNode != nullptr) {
+            this->mSharedTasksCount.fetch_sub(1);
+            return taskNode;
+        }
+    }
+
+    int32_t workerCount = this->mWorkerDeques.size();
+    for(int32_t i = 1; i < workerCount; i++) {
+        taskNode = this->mWorkerDeques[(workerSlot + i) % workerCount]->steal();
+        if(taskNode != nullptr) {
+            return taskNode;
+        }
+    }
+
+    return nullptr;
+}
+
+int8_t ThreadPool::workStealingRoutineHelper(int8_t isCoreThread, int32_t workerSlot) {
+    try {
+        // Check if the pool has been terminated. If so, exit the thread.
+        if(this->mTerminatePool.load()) {
+            return true;
+        }
+
+        TaskNode* taskNode = this->findTask(workerSlot);
+        if(taskNode != nullptr) {
+            this->mPendingTasksCount.fetch_sub(1);
+
+            if(taskNode->taskCallback != nullptr && *taskNode->taskCallback != nullptr) {
+                (*taskNode->taskCallback)(taskNode->args);
+            }
+
+            // Free the TaskNode, before proceeding to the next task
+            try {
+                FreeBlock<TaskNode>(SafeStaticCast(taskNode, void*));
+            } catch(const std::invalid_argument& e) {}
+
+            return false;
+        }
+
+        // No Task found, go to sleep until a new Task is submitted.
+        // The submitters check the idle count after updating the pending count, hence
+        // either the predicate observes the new Task, or the submitter issues a notification.
+        std::unique_lock<std::mutex> threadPoolUniqueLock(this->mThreadPoolMutex);
+        this->mIdleWorkersCount.fetch_add(1);
+
+        auto taskAvailable = [this]{return this->mPendingTasksCount.load() > 0 ||
+                                           this->mTerminatePool.load();};
+
+        if(isCoreThread) {
+            this->mThreadPoolCond.wait(threadPoolUniqueLock, taskAvailable);
+        } else {
+            // Expandable Thread
+            if(!this->mThreadPoolCond.wait_for(threadPoolUniqueLock,
+                                               std::chrono::seconds(10 * 60),
+                                               taskAvailable)) {
+                // Thread has been idle for the last 10 mins, proceed with Thread Termination.
+                // Its Deque is empty, since only the owner can push to it.
+                this->mIdleWorkersCount.fetch_sub(1);
+                this->mCurrentThreadsCount--;
+                this->mFreeWorkerSlots.push_back(workerSlot);
+                return true;
+            }
+        }
+
+        this->mIdleWorkersCount.fetch_sub(1);
+        return false;
+
+    } catch(const std::system_error& e) {
+        TYPELOGV(THREAD_POOL_THREAD_TERMINATED, e.what());
+        return true;
+
+    } catch(const std::exception& e) {
+        TYPELOGV(THREAD_POOL_THREAD_TERMINATED, e.what());
+        return true;
+    }
+}
+
+// Tasks in the Critical Lane can be admitted beyond the regular load limit, so that
+// they are not dropped when the Pool is saturated with lower priority tasks.
+int32_t ThreadPool::getLaneHeadroom(int32_t lane) {
+    if(lane == TASK_LANE_CRITICAL) {
+        return maxLoadPerThread;
+    }
+    return 0;
+}
+
+void ThreadPool::setLanePolicy(TaskLanePolicy policy, const int32_t weights[TOTAL_TASK_LANES]) {
+    try {
+        const std::lock_guard<std::mutex> lock(this->mThreadPoolMutex);
+        this->mCurrentTasks->setPolicy(policy, weights);
+    } catch(const std::system_error& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+    }
+}
+
+int8_t ThreadPool::enqueueWorkStealing(std::function<void(void*)> taskCallback, void* args, int32_t lane) {
+    try {
+        if(taskCallback == nullptr) return false;
+
+        // Admission follows the same load limits as the shared queue mode, i.e. upto
+        // maxLoadPerThread pending tasks per thread, beyond which the Pool is expanded.
+        int8_t taskAccepted = false;
+        if(this->mPendingTasksCount.load() <= maxLoadPerThread * this->mCurrentThreadsCount.load()) {
+            taskAccepted = true;
+        } else {
+            const std::lock_guard<std::mutex> lock(this->mThreadPoolMutex);
+            if(this->mCurrentThreadsCount < this->mMaxPoolCapacity) {
+                if(this->addNewThread(false)) {
+                    this->mCurrentThreadsCount++;
+                }
+                taskAccepted = true;
+            } else if(this->mPendingTasksCount.load() <=
+                      maxLoadPerThread * this->mCurrentThreadsCount + this->getLaneHeadroom(lane)) {
+                taskAccepted = true;
+            }
+        }
+
+        if(!taskAccepted) {
+            TYPELOGD(THREAD_POOL_FULL_ALERT);
+            return false;
+        }
+
+        TaskNode* taskNode = createTaskNode(taskCallback, args);
+        if(taskNode == nullptr) {
+            throw std::bad_alloc();
+        }
+
+        // Tasks submitted by a worker stay local to it, unless its Deque is full.
+        if(tCurrentPool == this && this->mWorkerDeques[tWorkerSlot]->push(taskNode)) {
+            this->mPendingTasksCount.fetch_add(1);
+
+            // Wake up an idle worker, so that it can steal the task.
+            if(this->mIdleWorkersCount.load() > 0) {
+                const std::lock_guard<std::mutex> lock(this->mThreadPoolMutex);
+                this->mThreadPoolCond.notify_one();
+            }
+            return true;
+        }
+
+        const std::lock_guard<std::mutex> lock(this->mThreadPoolMutex);
+        this->mCurrentTasks->add(taskNode, lane);
+        this->mSharedTasksCount.fetch_add(1);
+        this->mPendingTasksCount.fetch_add(1);
+
+        if(this->mIdleWorkersCount.load() > 0) {
+            this->mThreadPoolCond.notify_one();
+        }
+
+        return true;
+
+    } catch(const std::bad_alloc& e) {
+        TYPELOGV(THREAD_POOL_ENQUEUE_TASK_FAILURE, e.what());
+        return false;
+
+    } catch(const std::system_error& e) {
+        TYPELOGV(THREAD_POOL_ENQUEUE_TASK_FAILURE, e.what());
+        return false;
+    }
+}
+
+ThreadPoolMode ThreadPool::getPoolMode() {
+    return this->mPoolMode;
+}
+
+int8_t ThreadPool::enqueueTask(std::function<void(void*)> taskCallback, void* args, int32_t lane) {
+    if(this->mPoolMode == THREAD_POOL_WORK_STEALING) {
+        return this->enqueueWorkStealing(taskCallback, args, lane);
+    }
+
     try {
         if(taskCallback == nullptr) return false;
 
@@ -273,7 +659,7 @@ int8_t ThreadPool::enqueueTask(std::function<void(void*)> taskCallback, void* ar
                 throw std::bad_alloc();
             }
 
-            this->mCurrentTasks->add(taskNode);
+            this->mCurrentTasks->add(taskNode, lane);
             taskAccepted = true;
         }
 
@@ -289,7 +675,19 @@ int8_t ThreadPool::enqueueTask(std::function<void(void*)> taskCallback, void* ar
                 this->mCurrentThreadsCount++;
             }
 
-            this->mCurrentTasks->add(taskNode);
+            this->mCurrentTasks->add(taskNode, lane);
+            taskAccepted = true;
+        }
+
+        // Finally, check if the Lane has any reserved headroom left
+        if(!taskAccepted &&
+           this->mCurrentTasks->getSize() <= maxLoadPerThread * this->mCurrentThreadsCount + this->getLaneHeadroom(lane)) {
+            TaskNode* taskNode = createTaskNode(taskCallback, args);
+            if(taskNode == nullptr) {
+                throw std::bad_alloc();
+            }
+
+            this->mCurrentTasks->add(taskNode, lane);
             taskAccepted = true;
         }
 
@@ -347,6 +745,16 @@ ThreadPool::~ThreadPool() {
             thNode = nextNode;
         }
 
+        // Free up any Tasks which were never picked up
+        for(TaskDeque* taskDeque: this->mWorkerDeques) {
+            TaskNode* taskNode = nullptr;
+            while((taskNode = taskDeque->take()) != nullptr) {
+                FreeBlock<TaskNode>(SafeStaticCast(taskNode, void*));
+            }
+            delete taskDeque;
+        }
+        this->mWorkerDeques.clear();
+
         delete this->mCurrentTasks;
 
     } catch(const std::exception& e) {}
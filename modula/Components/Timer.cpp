@@ -3,30 +3,15 @@
 
 #include "Timer.h"
 
-ThreadPool* Timer::mTimerThreadPool = nullptr;
-
 Timer::Timer(std::function<void(void*)>callBack, int8_t isRecurring) {
     this->mTimerStop.store(false);
     this->mIsRecurring = isRecurring;
     this->mCallback = callBack;
-}
-
-void Timer::implementTimer() {
-    try {
-        do {
-            std::unique_lock<std::mutex> lock(this->mTimerMutex);
-            this->mTimerCond.wait_for(lock, std::chrono::milliseconds(this->mDuration),
-                                     [this]{return mTimerStop.load();});
-            lock.unlock();
-            if(!this->mTimerStop.load()) {
-                if(this->mCallback) {
-                    this->mCallback(nullptr);
-                }
-            }
-        } while(this->mIsRecurring && !this->mTimerStop.load());
-    } catch(const std::exception& e) {
-        LOGE("RESTUNE_TIMER", "Timer Could not be started, Error: " + std::string(e.what()));
-    }
+    this->mDuration = 0;
+    this->mExpiryTick = 0;
+    this->mWheelLevel = 0;
+    this->mWheelSlot = nullptr;
+    this->mWheelNode.mData = this;
 }
 
 int8_t Timer::startTimer(int64_t duration) {
@@ -38,13 +23,13 @@ int8_t Timer::startTimer(int64_t duration) {
         return false;
     }
 
-    this->mDuration = duration;
-
-    if(mTimerThreadPool == nullptr) {
+    std::shared_ptr<TimerWheel> timerWheel = TimerWheel::getInstance();
+    if(timerWheel == nullptr) {
         return false;
     }
 
-    if(!mTimerThreadPool->enqueueTask(std::bind(&Timer::implementTimer, this), nullptr)) {
+    this->mTimerStop.store(false);
+    if(!timerWheel->arm(this, duration)) {
         return false;
     }
 
@@ -55,7 +40,20 @@ int8_t Timer::startTimer(int64_t duration) {
 void Timer::killTimer() {
     LOGD("RESTUNE_TIMER", "Killing timer");
     this->mTimerStop.store(true);
-    this->mTimerCond.notify_all();
+
+    // Always go through the Wheel: the expiry thread may have unlinked the Timer to
+    // relink it (cascade or recurring re-arm), which is only visible under the Wheel lock.
+    // cancel() is a no-op for a Timer which is not linked.
+    std::shared_ptr<TimerWheel> timerWheel = TimerWheel::getExistingInstance();
+    if(timerWheel != nullptr) {
+        timerWheel->cancel(this);
+    }
+}
+
+int8_t Timer::isArmed() {
+    std::shared_ptr<TimerWheel> timerWheel = TimerWheel::getExistingInstance();
+    if(timerWheel == nullptr) return false;
+    return timerWheel->isArmed(this);
 }
 
 Timer::~Timer() {
@@ -0,0 +1,324 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "Timer.h"
+#include "TimerWheel.h"
+#include "AuxRoutines.h"
+
+// Number of ticks spanned by a single slot of the given level.
+#define LEVEL_GRANULARITY(level) ((int64_t)1 << (TIMER_WHEEL_SLOT_BITS * (level)))
+
+// Number of ticks covered by the complete Wheel. Timers with a longer duration are
+// parked in the farthest slot and re-inserted when that slot is cascaded.
+#define WHEEL_RANGE LEVEL_GRANULARITY(TIMER_WHEEL_LEVELS)
+
+std::shared_ptr<TimerWheel> TimerWheel::mTimerWheelInstance = nullptr;
+std::mutex TimerWheel::instanceProtectionLock {};
+
+TimerWheel::TimerWheel() {
+    this->mStartPoint = std::chrono::steady_clock::now();
+    this->mCurrentTick = 0;
+    this->mNextWakeTick = INT64_MAX;
+    this->mArmedCount = 0;
+    this->mTerminate = false;
+
+    for(int32_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        this->mLevelCount[level] = 0;
+        for(int32_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            this->mSlots[level][slot] = new DLManager(0);
+        }
+    }
+
+    this->mExpiryThread = std::thread(&TimerWheel::expiryThreadRoutine, this);
+}
+
+int64_t TimerWheel::getElapsedTicks() {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(
+                std::chrono::steady_clock::now() - this->mStartPoint).count();
+}
+
+// Link the Timer into the slot corresponding to its expiry tick.
+// The level is selected based on how far the expiry is from the current tick.
+// Note: Must be called with mTimerWheelMutex held.
+void TimerWheel::link(Timer* timer) {
+    int64_t expiry = timer->mExpiryTick;
+    if(expiry < this->mCurrentTick) {
+        expiry = this->mCurrentTick;
+    }
+
+    int64_t delta = expiry - this->mCurrentTick;
+    if(delta >= WHEEL_RANGE) {
+        expiry = this->mCurrentTick + WHEEL_RANGE - 1;
+        delta = WHEEL_RANGE - 1;
+    }
+
+    int32_t level = 0;
+    while(level < TIMER_WHEEL_LEVELS - 1 && delta >= LEVEL_GRANULARITY(level + 1)) {
+        level++;
+    }
+
+    int32_t slot = (expiry >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+
+    timer->mWheelLevel = level;
+    timer->mWheelSlot = this->mSlots[level][slot];
+    timer->mWheelSlot->insert(&timer->mWheelNode);
+
+    this->mLevelCount[level]++;
+    this->mArmedCount++;
+}
+
+// Note: Must be called with mTimerWheelMutex held.
+void TimerWheel::unlink(Timer* timer) {
+    if(timer->mWheelSlot == nullptr) return;
+
+    timer->mWheelSlot->deleteNode(&timer->mWheelNode);
+    timer->mWheelSlot = nullptr;
+
+    this->mLevelCount[timer->mWheelLevel]--;
+    this->mArmedCount--;
+}
+
+// Move all the Timers in the current slot of the given level to the lower levels.
+// Returns the index of the slot which was cascaded, this is used by the caller
+// to determine whether the next level needs to be cascaded as well.
+int32_t TimerWheel::cascade(int32_t level) {
+    int32_t slot = (this->mCurrentTick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+    DLManager* dlm = this->mSlots[level][slot];
+
+    DLRootNode* node = dlm->mHead;
+    while(node != nullptr) {
+        DLRootNode* nextNode = node->getNextPtr(dlm->mLinkerInUse);
+        Timer* timer = ((Iterable<Timer*>*)node)->mData;
+
+        this->unlink(timer);
+        this->link(timer);
+
+        node = nextNode;
+    }
+
+    return slot;
+}
+
+// Process mCurrentTick: perform any pending cascades, then expire all the Timers
+// in the current level 0 slot. The callbacks of the expired Timers are collected,
+// so that they can be invoked once the Wheel lock is released.
+// Note: Must be called with mTimerWheelMutex held.
+void TimerWheel::processTick(std::vector<std::function<void(void*)>>& expired) {
+    int32_t slot = this->mCurrentTick & TIMER_WHEEL_SLOT_MASK;
+
+    if(slot == 0) {
+        for(int32_t level = 1; level < TIMER_WHEEL_LEVELS; level++) {
+            if(this->cascade(level) != 0) {
+                break;
+            }
+        }
+    }
+
+    DLManager* dlm = this->mSlots[0][slot];
+    DLRootNode* node = dlm->mHead;
+    while(node != nullptr) {
+        DLRootNode* nextNode = node->getNextPtr(dlm->mLinkerInUse);
+        Timer* timer = ((Iterable<Timer*>*)node)->mData;
+
+        this->unlink(timer);
+        if(!timer->mTimerStop.load()) {
+            if(timer->mCallback) {
+                expired.push_back(timer->mCallback);
+            }
+
+            if(timer->mIsRecurring) {
+                // Re-arm relative to the previous expiry, to prevent drift.
+                timer->mExpiryTick += timer->mDuration;
+                if(timer->mExpiryTick <= this->mCurrentTick) {
+                    timer->mExpiryTick = this->mCurrentTick + 1;
+                }
+                this->link(timer);
+            }
+        }
+
+        node = nextNode;
+    }
+
+    this->mCurrentTick++;
+}
+
+// Process all the ticks upto (and including) uptoTick.
+// Ranges of ticks during which no Timer can expire or cascade are skipped.
+// Note: Must be called with mTimerWheelMutex held.
+void TimerWheel::advance(int64_t uptoTick, std::vector<std::function<void(void*)>>& expired) {
+    while(this->mCurrentTick <= uptoTick) {
+        if(this->mArmedCount == 0) {
+            this->mCurrentTick = uptoTick + 1;
+            break;
+        }
+
+        // Find the lowest level with linked Timers, nothing can happen
+        // before the next slot boundary of that level.
+        int32_t level = 0;
+        while(level < TIMER_WHEEL_LEVELS - 1 && this->mLevelCount[level] == 0) {
+            level++;
+        }
+
+        int64_t granularity = LEVEL_GRANULARITY(level);
+        if((this->mCurrentTick & (granularity - 1)) != 0) {
+            int64_t boundary = (this->mCurrentTick | (granularity - 1)) + 1;
+            this->mCurrentTick = std::min(boundary, uptoTick + 1);
+            continue;
+        }
+
+        this->processTick(expired);
+    }
+}
+
+// Compute the earliest tick at which either a Timer expires or a non-empty slot is cascaded.
+// Note: Must be called with mTimerWheelMutex held.
+int64_t TimerWheel::getNextEventTick() {
+    if(this->mArmedCount == 0) {
+        return INT64_MAX;
+    }
+
+    int64_t nextTick = INT64_MAX;
+    for(int32_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        if(this->mLevelCount[level] == 0) continue;
+
+        int64_t granularity = LEVEL_GRANULARITY(level);
+        // First slot boundary of this level, at or after the current tick
+        int64_t base = (this->mCurrentTick + granularity - 1) & ~(granularity - 1);
+        int32_t baseSlot = (base >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+
+        for(int32_t step = 0; step < TIMER_WHEEL_SLOTS; step++) {
+            int32_t slot = (baseSlot + step) & TIMER_WHEEL_SLOT_MASK;
+            if(this->mSlots[level][slot]->mHead != nullptr) {
+                nextTick = std::min(nextTick, base + step * granularity);
+                break;
+            }
+        }
+    }
+
+    return nextTick;
+}
+
+void TimerWheel::expiryThreadRoutine() {
+    std::vector<std::function<void(void*)>> expired;
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_TIMER);
+
+    while(true) {
+        try {
+            std::unique_lock<std::mutex> lock(this->mTimerWheelMutex);
+            if(this->mTerminate) {
+                return;
+            }
+
+            this->advance(this->getElapsedTicks(), expired);
+
+            if(expired.empty()) {
+                this->mNextWakeTick = this->getNextEventTick();
+                if(this->mNextWakeTick == INT64_MAX) {
+                    this->mTimerWheelCond.wait(lock);
+                } else {
+                    this->mTimerWheelCond.wait_until(lock,
+                        this->mStartPoint + std::chrono::milliseconds(this->mNextWakeTick));
+                }
+                this->mNextWakeTick = INT64_MAX;
+                continue;
+            }
+
+            lock.unlock();
+
+            for(std::function<void(void*)>& callback: expired) {
+                callback(nullptr);
+            }
+            expired.clear();
+
+        } catch(const std::exception& e) {
+            expired.clear();
+            LOGE("RESTUNE_TIMER", "Timer Expiry failed, Error: " + std::string(e.what()));
+        }
+    }
+}
+
+int8_t TimerWheel::arm(Timer* timer, int64_t duration) {
+    if(timer == nullptr || duration <= 0) {
+        return false;
+    }
+
+    try {
+        const std::lock_guard<std::mutex> lock(this->mTimerWheelMutex);
+        if(this->mTerminate) {
+            return false;
+        }
+
+        this->unlink(timer);
+
+        int64_t now = this->getElapsedTicks();
+        if(this->mArmedCount == 0 && this->mCurrentTick < now) {
+            // Wheel is idle, no need to process the elapsed ticks.
+            this->mCurrentTick = now;
+        }
+
+        timer->mDuration = duration;
+        timer->mExpiryTick = now + duration;
+        this->link(timer);
+
+        // Wake up the expiry thread only if this Timer expires before its scheduled wake up.
+        if(timer->mExpiryTick < this->mNextWakeTick) {
+            this->mNextWakeTick = timer->mExpiryTick;
+            this->mTimerWheelCond.notify_one();
+        }
+
+    } catch(const std::system_error& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+        return false;
+    }
+
+    return true;
+}
+
+void TimerWheel::cancel(Timer* timer) {
+    if(timer == nullptr) return;
+
+    try {
+        const std::lock_guard<std::mutex> lock(this->mTimerWheelMutex);
+        this->unlink(timer);
+
+    } catch(const std::system_error& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+    }
+}
+
+int8_t TimerWheel::isArmed(Timer* timer) {
+    if(timer == nullptr) return false;
+
+    const std::lock_guard<std::mutex> lock(this->mTimerWheelMutex);
+    return timer->mWheelSlot != nullptr;
+}
+
+int32_t TimerWheel::getArmedCount() {
+    const std::lock_guard<std::mutex> lock(this->mTimerWheelMutex);
+    return this->mArmedCount;
+}
+
+void TimerWheel::stop() {
+    try {
+        this->mTimerWheelMutex.lock();
+        this->mTerminate = true;
+        this->mTimerWheelCond.notify_all();
+        this->mTimerWheelMutex.unlock();
+
+        if(this->mExpiryThread.joinable()) {
+            this->mExpiryThread.join();
+        }
+    } catch(const std::system_error& e) {}
+}
+
+// Timers are owned by their clients, hence only the slots are freed here.
+TimerWheel::~TimerWheel() {
+    this->stop();
+
+    for(int32_t level = 0; level < TIMER_WHEEL_LEVELS; level++) {
+        for(int32_t slot = 0; slot < TIMER_WHEEL_SLOTS; slot++) {
+            delete this->mSlots[level][slot];
+            this->mSlots[level][slot] = nullptr;
+        }
+    }
+}
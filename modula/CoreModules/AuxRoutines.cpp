@@ -1,7 +1,30 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <sys/resource.h>
+#include <sys/syscall.h>
+
 #include "AuxRoutines.h"
+#include "MemoryPool.h"
+
+#define SCHED_FLAG_KEEP_POLICY 0x08
+#define SCHED_FLAG_KEEP_PARAMS 0x10
+#define SCHED_FLAG_UTIL_CLAMP_MIN 0x20
+#define SCHED_FLAG_UTIL_CLAMP_MAX 0x40
+
+// Layout expected by the sched_setattr syscall, not exported by all libc versions.
+typedef struct {
+    uint32_t size;
+    uint32_t sched_policy;
+    uint64_t sched_flags;
+    int32_t sched_nice;
+    uint32_t sched_priority;
+    uint64_t sched_runtime;
+    uint64_t sched_deadline;
+    uint64_t sched_period;
+    uint32_t sched_util_min;
+    uint32_t sched_util_max;
+} SchedAttr;
 
 std::mutex AuxRoutines::handleGenLock {};
 
@@ -155,12 +178,67 @@ FlatBuffEncoder::FlatBuffEncoder() {
     this->mBuffer = nullptr;
     this->mCurPtr = nullptr;
     this->mRunningIndex = 0;
+    this->mCapacity = REQ_BUFFER_SIZE;
+    this->mStorage = nullptr;
+    this->mReserved = 0;
 }
 
 void FlatBuffEncoder::setBuf(char* buffer) {
     this->mBuffer = buffer;
     this->mCurPtr = buffer;
     this->mRunningIndex = 0;
+    this->mCapacity = REQ_BUFFER_SIZE;
+    this->mStorage = nullptr;
+    this->mReserved = 0;
+}
+
+void FlatBuffEncoder::setStorage(std::vector<char>* storage, size_t reserved) {
+    this->mStorage = storage;
+    this->mReserved = reserved;
+    this->mRunningIndex = 0;
+    this->mCapacity = MAX_FRAME_PAYLOAD_SIZE;
+    this->mBuffer = nullptr;
+    this->mCurPtr = nullptr;
+
+    if(storage == nullptr) return;
+
+    try {
+        // The storage is reused across messages, hence it is only ever grown.
+        if(storage->size() < reserved + REQ_BUFFER_SIZE) {
+            storage->resize(reserved + REQ_BUFFER_SIZE);
+        }
+        this->mBuffer = storage->data() + reserved;
+        this->mCurPtr = this->mBuffer;
+
+    } catch(const std::bad_alloc& e) {
+        this->mRunningIndex = -1;
+    }
+}
+
+// Check if count more bytes can be encoded, growing the storage if required.
+int8_t FlatBuffEncoder::ensureSpace(size_t count) {
+    if(this->mRunningIndex + count >= (size_t)this->mCapacity) {
+        return false;
+    }
+
+    if(this->mStorage == nullptr) {
+        return true;
+    }
+
+    size_t required = this->mReserved + this->mRunningIndex + count;
+    if(required <= this->mStorage->size()) {
+        return true;
+    }
+
+    try {
+        this->mStorage->resize(std::max(required, 2 * this->mStorage->size()));
+    } catch(const std::bad_alloc& e) {
+        return false;
+    }
+
+    this->mBuffer = this->mStorage->data() + this->mReserved;
+    this->mCurPtr = this->mBuffer + this->mRunningIndex;
+    return true;
 }
 
 FlatBuffEncoder FlatBuffEncoder::appendString(const char* valStr) {
@@ -169,10 +247,9 @@ FlatBuffEncoder FlatBuffEncoder::appendString(const char* valStr) {
     }
 
     const char* charIterator = valStr;
-    char* charPointer = reinterpret_cast<char*>(this->mCurPtr);
-
     while(*charIterator != '\0') {
-        if(this->mRunningIndex != -1 && this->mRunningIndex + 1 < REQ_BUFFER_SIZE) {
+        if(this->mRunningIndex != -1 && this->ensureSpace(1)) {
+            char* charPointer = reinterpret_cast<char*>(this->mCurPtr);
             try {
                 ASSIGN_AND_INCR(charPointer, *charIterator);
                 this->mRunningIndex++;
@@ -184,14 +261,14 @@ FlatBuffEncoder FlatBuffEncoder::appendString(const char* valStr) {
             }
         } else {
             // Prevent further updates on the current buffer
-            this->mRunningIndex = REQ_BUFFER_SIZE;
+            this->mRunningIndex = this->mCapacity;
             break;
         }
 
         charIterator++;
     }
 
-    if(this->mRunningIndex >= 0 && this->mRunningIndex < REQ_BUFFER_SIZE) {
+    if(this->mRunningIndex >= 0 && this->mRunningIndex < this->mCapacity) {
         return this->append<char>('\0');
     }
 
@@ -199,21 +276,30 @@ FlatBuffEncoder FlatBuffEncoder::appendString(const char* valStr) {
 }
 
 int8_t FlatBuffEncoder::isBufSane() {
-    if(this->mRunningIndex >= REQ_BUFFER_SIZE || this->mBuffer == nullptr) {
+    if(this->mRunningIndex < 0 || this->mRunningIndex >= this->mCapacity || this->mBuffer == nullptr) {
         return false;
     }
     return true;
 }
 
-int64_t AuxRoutines::generateUniqueHandle() {
+int32_t FlatBuffEncoder::getSize() {
+    return this->mRunningIndex;
+}
+
+int64_t AuxRoutines::generateUniqueHandle(int32_t count) {
+    if(count <= 0) {
+        return -1;
+    }
+
     const std::lock_guard<std::mutex> lock(handleGenLock);
 
     static int64_t handleGenerator = 0;
     OperationStatus opStatus;
-    int64_t nextHandle = Add(handleGenerator, (int64_t)1, opStatus);
+    int64_t lastHandle = Add(handleGenerator, (int64_t)count, opStatus);
     if(opStatus == SUCCESS) {
-        handleGenerator = nextHandle;
-        return nextHandle;
+        int64_t firstHandle = handleGenerator + 1;
+        handleGenerator = lastHandle;
+        return firstHandle;
     }
 
     return -1;
@@ -229,6 +315,102 @@ void AuxRoutines::toLowerCase(std::string& str) {
                    [](unsigned char c) { return std::tolower(c); });
 }
 
+void AuxRoutines::applyThreadConfig(int32_t threadClass) {
+    if(threadClass < 0 || threadClass >= TOTAL_THREAD_CLASSES) return;
+
+    ThreadConfigInfo* config = &UrmSettings::threadConfigs[threadClass];
+    if(!config->mConfigured) return;
+
+    pid_t tid = (pid_t)syscall(SYS_gettid);
+
+    if(config->mHasCpuSet) {
+        if(sched_setaffinity(tid, sizeof(cpu_set_t), &config->mCpuSet) == -1) {
+            TYPELOGV(ERRNO_LOG, "sched_setaffinity", strerror(errno));
+        }
+    }
+
+    if(config->mSchedPolicy != -1) {
+        struct sched_param param {};
+        param.sched_priority = config->mSchedPriority;
+        if(sched_setscheduler(tid, config->mSchedPolicy, &param) == -1) {
+            TYPELOGV(ERRNO_LOG, "sched_setscheduler", strerror(errno));
+        }
+    }
+
+    if(config->mHasNice) {
+        if(setpriority(PRIO_PROCESS, tid, config->mNice) == -1) {
+            TYPELOGV(ERRNO_LOG, "setpriority", strerror(errno));
+        }
+    }
+
+    if(config->mUclampMin != -1 || config->mUclampMax != -1) {
+        SchedAttr attr {};
+        attr.size = sizeof(SchedAttr);
+        attr.sched_flags = SCHED_FLAG_KEEP_POLICY | SCHED_FLAG_KEEP_PARAMS;
+        if(config->mUclampMin != -1) {
+            attr.sched_flags |= SCHED_FLAG_UTIL_CLAMP_MIN;
+            attr.sched_util_min = config->mUclampMin;
+        }
+        if(config->mUclampMax != -1) {
+            attr.sched_flags |= SCHED_FLAG_UTIL_CLAMP_MAX;
+            attr.sched_util_max = config->mUclampMax;
+        }
+
+        if(syscall(SYS_sched_setattr, tid, &attr, 0) == -1) {
+            TYPELOGV(ERRNO_LOG, "sched_setattr", strerror(errno));
+        }
+    }
+}
+
+MsgForwardInfo* AuxRoutines::allocMsgForwardInfo(uint64_t bufSize) {
+    MsgForwardInfo* info = nullptr;
+    char* reqBuf = nullptr;
+
+    try {
+        info = new (GetBlock<MsgForwardInfo>()) MsgForwardInfo;
+        if(bufSize <= REQ_BUFFER_SIZE) {
+            reqBuf = new (GetBlock<char[REQ_BUFFER_SIZE]>()) char[REQ_BUFFER_SIZE];
+        } else {
+            reqBuf = new char[bufSize];
+        }
+
+        info->mBuffer = reqBuf;
+        info->mBufferSize = bufSize;
+
+    } catch(const std::bad_alloc& e) {
+        FreeBlock<MsgForwardInfo>(info);
+        return nullptr;
+    }
+
+    return info;
+}
+
+MsgForwardInfo* AuxRoutines::cloneMsgForwardInfo(const MsgForwardInfo* info) {
+    MsgForwardInfo* clone = allocMsgForwardInfo(info->mBufferSize);
+    if(clone == nullptr) {
+        return nullptr;
+    }
+
+    std::memcpy(clone->mBuffer, info->mBuffer, info->mBufferSize);
+    clone->mModuleID = info->mModuleID;
+    clone->mRequestType = info->mRequestType;
+    clone->mHandle = info->mHandle;
+    return clone;
+}
+
+void AuxRoutines::freeMsgForwardInfo(MsgForwardInfo* info) {
+    if(info == nullptr) return;
+
+    if(info->mBufferSize <= REQ_BUFFER_SIZE) {
+        FreeBlock<char[REQ_BUFFER_SIZE]>(info->mBuffer);
+    } else {
+        delete[] info->mBuffer;
+    }
+    info->mBuffer = nullptr;
+
+    FreeBlock<MsgForwardInfo>(info);
+}
+
 MinLRUCache::MinLRUCache(int32_t maxSize) {
     this->mMaxSize = maxSize;
     this->mDataSet.reserve(this->mMaxSize);
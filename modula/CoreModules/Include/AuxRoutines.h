@@ -14,6 +14,7 @@
 #include <unistd.h>
 #include <getopt.h>
 #include <dirent.h>
+#include <vector>
 #include <algorithm>
 #include <unordered_set>
 
@@ -21,6 +22,7 @@
 #include "ClientEndpoint.h"
 #include "UrmSettings.h"
 #include "SafeOps.h"
+#include "Utils.h"
 
 class AuxRoutines {
 private:
@@ -39,17 +41,54 @@ public:
 	static pid_t fetchPid(const std::string& processName);
     static int32_t fetchComm(pid_t pid, std::string &comm);
 
-    static int64_t generateUniqueHandle();
+    /**
+     * @brief Reserve count consecutive Request handles.
+     * @return int64_t: the first of the reserved handles, or -1 on failure.
+     */
+    static int64_t generateUniqueHandle(int32_t count = 1);
     static int64_t getCurrentTimeInMilliseconds();
     static void toLowerCase(std::string& str);
+
+    /**
+     * @brief Apply the CPU set and scheduling attributes configured for the given
+     *        Thread Class (via InitConfig.yaml) to the calling thread.
+     * @details Attributes which are not configured are left unchanged. Failures are
+     *          logged and the thread continues with its current attributes.
+     * @param threadClass One of the ThreadClass values.
+     */
+    static void applyThreadConfig(int32_t threadClass);
+
+    /**
+     * @brief Allocate a MsgForwardInfo, along with a buffer for a message payload of the given size.
+     * @details Payloads which fit a legacy fixed size message (REQ_BUFFER_SIZE) are served by the
+     *          Memory Pool, larger (framed) payloads are allocated from the heap.
+     * @return MsgForwardInfo*: the allocated MsgForwardInfo, or nullptr on failure.
+     */
+    static MsgForwardInfo* allocMsgForwardInfo(uint64_t bufSize);
+
+    /**
+     * @brief Copy a message (typically, one borrowed from the listener) into a newly allocated
+     *        MsgForwardInfo, so that it can be handed off to another thread.
+     * @return MsgForwardInfo*: the copy, or nullptr on failure.
+     */
+    static MsgForwardInfo* cloneMsgForwardInfo(const MsgForwardInfo* info);
+    static void freeMsgForwardInfo(MsgForwardInfo* info);
 };
 
 // Following are some client-lib centric utilities
+// The encoder either writes to a fixed buffer of size REQ_BUFFER_SIZE (setBuf), or to a
+// growable storage (setStorage), which is bounded by MAX_FRAME_PAYLOAD_SIZE. In the latter
+// case, the storage can reserve some leading bytes for the frame header.
 class FlatBuffEncoder {
 private:
     char* mBuffer;
     void* mCurPtr;
     int32_t mRunningIndex;
+    int32_t mCapacity;
+    std::vector<char>* mStorage;
+    size_t mReserved;
+
+    int8_t ensureSpace(size_t count);
 
 public:
     FlatBuffEncoder();
@@ -60,7 +99,7 @@ public:
             return *this;
         }
 
-        if(this->mRunningIndex + sizeof(T) < REQ_BUFFER_SIZE) {
+        if(this->ensureSpace(sizeof(T))) {
             T* tPtr = (T*)(this->mCurPtr);
             try {
                 ASSIGN_AND_INCR(tPtr, val);
@@ -72,7 +111,7 @@ public:
             }
         } else {
             // Prevent further updates on the current buffer
-            this->mRunningIndex = REQ_BUFFER_SIZE;
+            this->mRunningIndex = this->mCapacity;
         }
 
         return *this;
@@ -81,19 +120,34 @@ public:
     FlatBuffEncoder appendString(const char* valStr);
 
     void setBuf(char* buffer);
+    void setStorage(std::vector<char>* storage, size_t reserved);
     int8_t isBufSane();
+
+    // Number of bytes encoded so far (excluding the reserved bytes).
+    int32_t getSize();
 };
 
 class ConnectionManager {
 private:
     std::shared_ptr<ClientEndpoint> connection;
+    const int8_t* mKeepAlive;
 
 public:
-    ConnectionManager(std::shared_ptr<ClientEndpoint> connection) {
+    /**
+     * @param connection Connection to be closed when the ConnectionManager goes out of scope.
+     * @param keepAlive Optional flag, if it is set at the time of destruction, the
+     *                  connection is left open (for example a persistent session).
+     */
+    ConnectionManager(std::shared_ptr<ClientEndpoint> connection, const int8_t* keepAlive = nullptr) {
         this->connection = connection;
+        this->mKeepAlive = keepAlive;
     }
 
     ~ConnectionManager() {
+        if(this->mKeepAlive != nullptr && *this->mKeepAlive) {
+            return;
+        }
+
         if(this->connection != nullptr) {
             this->connection->closeConnection();
         }
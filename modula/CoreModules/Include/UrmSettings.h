@@ -4,6 +4,7 @@
 #ifndef URM_SETTINGS_H
 #define URM_SETTINGS_H
 
+#include <sched.h>
 #include <unordered_map>
 
 #include "ErrCodes.h"
@@ -12,6 +13,20 @@
 #define URM_IDENTIFIER "urm"
 #define REQ_BUFFER_SIZE 580
 
+// Framed (variable length) wire protocol. A framed message starts with a version byte,
+// followed by the uint32_t payload length, and the payload itself, encoded exactly as a
+// legacy fixed size (REQ_BUFFER_SIZE) message. Legacy messages start with the Module ID,
+// which never has the top bit set, hence the two formats can be told apart by the first byte.
+#define WIRE_PROTOCOL_VERSION 2
+#define WIRE_VERSION_BYTE(version) ((uint8_t)(0x80 | (version)))
+#define IS_WIRE_VERSION_BYTE(byte) (((uint8_t)(byte) & 0x80) != 0)
+#define WIRE_VERSION_OF(byte) ((uint8_t)(byte) & 0x7F)
+#define WIRE_FRAME_HEADER_SIZE (sizeof(uint8_t) + sizeof(uint32_t))
+#define MAX_FRAME_PAYLOAD_SIZE (64 * 1024)
+
+// Max number of Tune Requests, which can be carried by a single REQ_RESOURCE_TUNING_BATCH message.
+#define MAX_TUNE_BATCH_SIZE 64
+
 // Operational Tunable Parameters for Resource Tuner
 typedef struct {
     uint32_t mMaxConcurrentRequests;
@@ -27,6 +42,20 @@ typedef struct {
     double mRewardFactor;
     uint32_t mPluginCount;
     uint32_t mAcceptMode;
+    int8_t mExpiryBatching;
+    uint32_t mRequestQueueMode;
+    uint32_t mConsumerBatchSize;
+    uint32_t mThreadPoolMode;
+    uint32_t mLanePolicy;
+    int32_t mLaneWeights[TOTAL_TASK_LANES];
+    uint32_t mPoolBootShare;
+    uint32_t mPoolCeilingFactor;
+    uint32_t mPoolIdleRelease;
+    uint32_t mListenerThreadCount;
+    uint32_t mListenerBackend;
+    uint32_t mApplierShardCount;
+    int8_t mWritePlan;
+    uint32_t mNodeShadowValidity;
 } MetaConfigs;
 
 typedef struct {
@@ -39,6 +68,21 @@ typedef struct {
     int8_t currMode;
 } TargetConfigs;
 
+// CPU placement and scheduling attributes for a class of daemon-internal threads.
+// Fields which are not configured are left unchanged when the config is applied.
+typedef struct {
+    int32_t mThreadClass;
+    int8_t mConfigured;
+    int8_t mHasCpuSet;
+    cpu_set_t mCpuSet;
+    int32_t mSchedPolicy; // -1 if not configured
+    int32_t mSchedPriority;
+    int8_t mHasNice;
+    int32_t mNice;
+    int32_t mUclampMin; // -1 if not configured
+    int32_t mUclampMax; // -1 if not configured
+} ThreadConfigInfo;
+
 class UrmSettings {
 private:
     static int32_t serverOnlineStatus;
@@ -82,6 +126,7 @@ public:
     // Target Information Stores
     static MetaConfigs metaConfigs;
     static TargetConfigs targetConfigs;
+    static ThreadConfigInfo threadConfigs[TOTAL_THREAD_CLASSES];
 
     static int32_t isServerOnline();
     static void setServerOnlineStatus(int32_t isOnline);
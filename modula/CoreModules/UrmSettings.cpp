@@ -6,6 +6,7 @@
 int32_t UrmSettings::serverOnlineStatus = false;
 MetaConfigs UrmSettings::metaConfigs{};
 TargetConfigs UrmSettings::targetConfigs{};
+ThreadConfigInfo UrmSettings::threadConfigs[TOTAL_THREAD_CLASSES]{};
 
 const std::string UrmSettings::mTargetConfDir = "/etc/urm/target/";
 
@@ -0,0 +1,123 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "ApplierShards.h"
+#include "AuxRoutines.h"
+
+ApplierShards::ApplierShards(uint32_t shardCount) {
+    this->mTerminate.store(false);
+    this->mDispatchedCount.store(0);
+
+    if(shardCount > maxApplierShards) {
+        shardCount = maxApplierShards;
+    }
+
+    // A single shard is equivalent to applying inline, no threads are needed.
+    if(shardCount <= 1) return;
+
+    for(uint32_t i = 0; i < shardCount; i++) {
+        Shard* shard = nullptr;
+        try {
+            shard = new Shard;
+            shard->mBusy = false;
+            shard->mThread = std::thread(&ApplierShards::shardRoutine, this, shard);
+        } catch(const std::exception& e) {
+            TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "resource-applier", e.what());
+            delete shard;
+            // Fall back to applying inline
+            this->stop();
+            return;
+        }
+        this->mShards.push_back(shard);
+    }
+}
+
+// Tasks are executed in place, i.e. while still at the front of the queue. This is safe,
+// since producers only append to the queue, which does not invalidate references to the
+// existing elements of a std::deque.
+void ApplierShards::shardRoutine(Shard* shard) {
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_CONSUMER);
+
+    std::unique_lock<std::mutex> lock(shard->mShardLock);
+    while(true) {
+        shard->mShardCond.wait(lock, [&] {
+            return !shard->mTasks.empty() || this->mTerminate.load();
+        });
+
+        if(shard->mTasks.empty()) {
+            // Terminating, and all the pending Tasks have been executed.
+            return;
+        }
+
+        ApplyTask& task = shard->mTasks.front();
+        shard->mBusy = true;
+        lock.unlock();
+
+        task.mCallback(&task.mResource);
+
+        lock.lock();
+        shard->mTasks.pop_front();
+        shard->mBusy = false;
+        if(shard->mTasks.empty()) {
+            // Wake up any thread waiting for the shard to drain.
+            shard->mShardCond.notify_all();
+        }
+    }
+}
+
+void ApplierShards::dispatch(int32_t shardKey, ResourceLifecycleCallback callback, Resource* resource) {
+    if(callback == nullptr || resource == nullptr) return;
+
+    if(this->mShards.empty() || shardKey < 0) {
+        callback(resource);
+        return;
+    }
+
+    Shard* shard = this->mShards[shardKey % this->mShards.size()];
+    try {
+        const std::lock_guard<std::mutex> lock(shard->mShardLock);
+        shard->mTasks.emplace_back(callback, *resource);
+    } catch(const std::bad_alloc& e) {
+        // Preserve the per Resource ordering, before applying inline.
+        this->drain();
+        callback(resource);
+        return;
+    }
+
+    this->mDispatchedCount.fetch_add(1);
+    shard->mShardCond.notify_all();
+}
+
+void ApplierShards::drain() {
+    for(Shard* shard: this->mShards) {
+        std::unique_lock<std::mutex> lock(shard->mShardLock);
+        shard->mShardCond.wait(lock, [&] {
+            return shard->mTasks.empty() && !shard->mBusy;
+        });
+    }
+}
+
+void ApplierShards::stop() {
+    this->mTerminate.store(true);
+
+    for(Shard* shard: this->mShards) {
+        {
+            const std::lock_guard<std::mutex> lock(shard->mShardLock);
+            shard->mShardCond.notify_all();
+        }
+
+        if(shard->mThread.joinable()) {
+            shard->mThread.join();
+        }
+        delete shard;
+    }
+    this->mShards.clear();
+}
+
+int64_t ApplierShards::getDispatchedCount() {
+    return this->mDispatchedCount.load();
+}
+
+ApplierShards::~ApplierShards() {
+    this->stop();
+}
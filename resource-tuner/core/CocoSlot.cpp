@@ -0,0 +1,115 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "CocoSlot.h"
+
+// For multi-valued Resources, the second value is the one being compared.
+static int32_t getPolicyValue(Resource* resource) {
+    if(resource->getValuesCount() == 1) {
+        return resource->getValueAt(0);
+    }
+    return resource->getValueAt(1);
+}
+
+CocoSlot::CocoSlot(enum Policy policy) {
+    this->mPolicy = policy;
+    this->mNextSeq = 0;
+    this->mRank = 0;
+}
+
+// Lower key wins, equal keys are ordered by insertion.
+int8_t CocoSlot::isBefore(ResIterable* first, ResIterable* second) {
+    if(first->mSlotKey != second->mSlotKey) {
+        return first->mSlotKey < second->mSlotKey;
+    }
+    return first->mSlotSeq < second->mSlotSeq;
+}
+
+void CocoSlot::place(ResIterable* node, int32_t pos) {
+    this->mHeap[pos] = node;
+    node->mSlotPos = pos;
+}
+
+void CocoSlot::siftUp(int32_t pos) {
+    ResIterable* node = this->mHeap[pos];
+    while(pos > 0) {
+        int32_t parent = (pos - 1) / 2;
+        if(!this->isBefore(node, this->mHeap[parent])) break;
+        this->place(this->mHeap[parent], pos);
+        pos = parent;
+    }
+    this->place(node, pos);
+}
+
+void CocoSlot::siftDown(int32_t pos) {
+    int32_t size = (int32_t)this->mHeap.size();
+    ResIterable* node = this->mHeap[pos];
+    while(true) {
+        int32_t child = 2 * pos + 1;
+        if(child >= size) break;
+        if(child + 1 < size && this->isBefore(this->mHeap[child + 1], this->mHeap[child])) {
+            child++;
+        }
+        if(!this->isBefore(this->mHeap[child], node)) break;
+        this->place(this->mHeap[child], pos);
+        pos = child;
+    }
+    this->place(node, pos);
+}
+
+int8_t CocoSlot::insert(ResIterable* node) {
+    if(node == nullptr || node->mData == nullptr) return false;
+
+    node->mSlotSeq = this->mNextSeq++;
+    switch(this->mPolicy) {
+        case INSTANT_APPLY:
+            // Latest Request is honoured
+            node->mSlotKey = -(int64_t)node->mSlotSeq;
+            break;
+        case HIGHER_BETTER:
+            node->mSlotKey = -(int64_t)getPolicyValue(node->mData);
+            break;
+        case LOWER_BETTER:
+            node->mSlotKey = (int64_t)getPolicyValue(node->mData);
+            break;
+        default:
+            // LAZY_APPLY, first-in-first-out
+            node->mSlotKey = 0;
+            break;
+    }
+
+    try {
+        this->mHeap.push_back(node);
+    } catch(const std::bad_alloc& e) {
+        node->mSlotPos = -1;
+        return false;
+    }
+
+    this->siftUp((int32_t)this->mHeap.size() - 1);
+    return node->mSlotPos == 0;
+}
+
+int8_t CocoSlot::remove(ResIterable* node) {
+    if(node == nullptr) return false;
+
+    int32_t pos = node->mSlotPos;
+    if(pos < 0 || pos >= (int32_t)this->mHeap.size() || this->mHeap[pos] != node) {
+        return false;
+    }
+
+    node->mSlotPos = -1;
+    ResIterable* last = this->mHeap.back();
+    this->mHeap.pop_back();
+
+    if(last != node) {
+        // Fill the hole with the last node, and restore the heap order around it.
+        this->place(last, pos);
+        if(pos > 0 && this->isBefore(last, this->mHeap[(pos - 1) / 2])) {
+            this->siftUp(pos);
+        } else {
+            this->siftDown(pos);
+        }
+    }
+
+    return pos == 0;
+}
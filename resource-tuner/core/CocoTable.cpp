@@ -3,58 +3,16 @@
 
 #include "CocoTable.h"
 
-static int8_t comparHBetter(DLRootNode* newNode, DLRootNode* targetNode) {
-    Resource* first = (Resource*)((ResIterable*)newNode)->mData;
-    Resource* second = (Resource*)((ResIterable*)targetNode)->mData;
-
-    int32_t newValue;
-    int32_t targetValue;
-
-    if(first->getValuesCount() == 1) {
-        newValue = first->getValueAt(0);
-    } else {
-        newValue = first->getValueAt(1);
-    }
-
-    if(second->getValuesCount() == 1) {
-        targetValue = second->getValueAt(0);
-    } else {
-        targetValue = second->getValueAt(1);
-    }
-
-    return newValue > targetValue;
-}
-
-static int8_t comparLBetter(DLRootNode* newNode, DLRootNode* targetNode) {
-    Resource* first = (Resource*)((ResIterable*)newNode)->mData;
-    Resource* second = (Resource*)((ResIterable*)targetNode)->mData;
-
-    int32_t newValue;
-    int32_t targetValue;
-
-    if(first->getValuesCount() == 1) {
-        newValue = first->getValueAt(0);
-    } else {
-        newValue = first->getValueAt(1);
-    }
-
-    if(second->getValuesCount() == 1) {
-        targetValue = second->getValueAt(0);
-    } else {
-        targetValue = second->getValueAt(1);
-    }
-
-    return newValue < targetValue;
-}
-
 std::shared_ptr<CocoTable> CocoTable::mCocoTableInstance = nullptr;
 std::mutex CocoTable::instanceProtectionLock {};
 
 CocoTable::CocoTable() {
     this->mResourceRegistry = ResourceRegistry::getInstance();
-    int32_t totalResources = this->mResourceRegistry->getTotalResourcesCount();
-
-    this->mCurrentlyAppliedPriority.resize(totalResources, -1);
+    this->mApplierShards = new ApplierShards(UrmSettings::metaConfigs.mApplierShardCount);
+    this->mWritePlanOpen = false;
+    this->mExpiryTriggerQueued = false;
+    this->mCoalescedWriteCount.store(0);
+    this->mPlanSuppressedWriteCount.store(0);
 
     std::vector<int32_t> clusterIDs;
     TargetRegistry::getInstance()->getClusterIDs(clusterIDs);
@@ -126,11 +84,31 @@ CocoTable::CocoTable() {
             vectorSize = TOTAL_PRIORITIES;
         }
 
-        std::vector<DLManager*> innerVec(vectorSize, nullptr);
+        std::vector<CocoSlot*> innerVec(vectorSize, nullptr);
         for(size_t i = 0; i < vectorSize; i++) {
-            innerVec[i] = new DLManager(COCO_TABLE_DL_NR);
+            innerVec[i] = new CocoSlot(resourceConfig->mPolicy);
         }
         this->mCocoTable.push_back(innerVec);
+
+        // Applied priority is tracked per Resource instance (core / cluster / cgroup)
+        this->mCurrentlyAppliedPriority.push_back(std::vector<int32_t>(vectorSize / TOTAL_PRIORITIES, -1));
+        this->mWritePlanPosition.push_back(std::vector<int32_t>(vectorSize / TOTAL_PRIORITIES, -1));
+        this->mShardKeys.push_back((int32_t)this->mShardKeys.size());
+    }
+
+    // Custom callbacks are not required to be thread-safe, hence all the Resources with
+    // a custom Applier or Tear callback share a single shard, and are written in order.
+    std::vector<std::pair<uint32_t, ResourceLifecycleCallback>> customCallbacks =
+        Extensions::getResourceApplierCallbacks();
+    std::vector<std::pair<uint32_t, ResourceLifecycleCallback>> customTearCallbacks =
+        Extensions::getResourceTearCallbacks();
+    customCallbacks.insert(customCallbacks.end(), customTearCallbacks.begin(), customTearCallbacks.end());
+
+    for(std::pair<uint32_t, ResourceLifecycleCallback>& customCallback: customCallbacks) {
+        int32_t primaryIndex = this->mResourceRegistry->getResourceTableIndex(customCallback.first);
+        if(primaryIndex >= 0 && primaryIndex < (int32_t)this->mShardKeys.size()) {
+            this->mShardKeys[primaryIndex] = 0;
+        }
     }
 }
 
@@ -140,56 +118,172 @@ int8_t CocoTable::needsAllocation(Resource* res) {
            (rConf->mPolicy != Policy::PASS_THROUGH_APPEND);
 }
 
-void CocoTable::applyAction(ResIterable* currNode, int32_t index, int8_t priority) {
+void CocoTable::applyAction(ResIterable* currNode, int32_t primaryIndex, int32_t instanceIndex, int8_t priority) {
     if(currNode == nullptr || currNode->mData == nullptr) return;
 
     Resource* resource = (Resource*) currNode->mData;
+    int32_t& appliedPriority = this->mCurrentlyAppliedPriority[primaryIndex][instanceIndex];
 
-    if(this->mCurrentlyAppliedPriority[index] >= priority ||
-       this->mCurrentlyAppliedPriority[index] == -1) {
+    if(appliedPriority >= priority || appliedPriority == -1) {
         ResConfInfo* resourceConfig = this->mResourceRegistry->getResConf(resource->getResCode());
         if(resourceConfig->mModes & UrmSettings::targetConfigs.currMode) {
             // Check if a custom Applier (Callback) has been provided for this Resource, if yes, then call it
             // Note for resources with multiple values, the BU will need to provide a custom applier, which provides
             // the aggregation / selection logic.
             if(resourceConfig->mResourceApplierCallback != nullptr) {
-                resourceConfig->mResourceApplierCallback(resource);
+                this->issueWrite(primaryIndex, instanceIndex, resourceConfig->mResourceApplierCallback, resource, false);
             }
-            this->mCurrentlyAppliedPriority[index] = priority;
+            appliedPriority = priority;
         } else {
             TYPELOGV(NOTIFY_RESMODE_REJECT, resource->getResCode(), UrmSettings::targetConfigs.currMode);
         }
     }
 }
 
-void CocoTable::fastPathApply(Resource* resource) {
+void CocoTable::fastPathApply(int32_t primaryIndex, Resource* resource) {
     ResConfInfo* rConf = this->mResourceRegistry->getResConf(resource->getResCode());
     if(rConf->mModes & UrmSettings::targetConfigs.currMode) {
         // Check if a custom Applier (Callback) has been provided for this Resource, if yes, then call it
         // Note for resources with multiple values, the BU will need to provide a custom applier, which provides
         // the aggregation / selection logic.
         if(rConf->mResourceApplierCallback != nullptr) {
-            rConf->mResourceApplierCallback(resource);
+            this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], rConf->mResourceApplierCallback, resource);
         }
     }
 }
 
-void CocoTable::removeAction(int32_t index, Resource* resource) {
+void CocoTable::removeAction(int32_t primaryIndex, int32_t instanceIndex, Resource* resource) {
     if(resource == nullptr) return;
     ResConfInfo* resConfInfo = this->mResourceRegistry->getResConf(resource->getResCode());
     if(resConfInfo != nullptr) {
         if(resConfInfo->mResourceTearCallback != nullptr) {
-            resConfInfo->mResourceTearCallback(resource);
+            this->issueWrite(primaryIndex, instanceIndex, resConfInfo->mResourceTearCallback, resource, true);
         }
-        this->mCurrentlyAppliedPriority[index] = -1;
+        this->mCurrentlyAppliedPriority[primaryIndex][instanceIndex] = -1;
     }
 }
 
-void CocoTable::fastPathReset(Resource* resource) {
+void CocoTable::fastPathReset(int32_t primaryIndex, Resource* resource) {
     ResConfInfo* rConf = this->mResourceRegistry->getResConf(resource->getResCode());
     if(rConf->mResourceApplierCallback != nullptr) {
-        rConf->mResourceTearCallback(resource);
+        this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], rConf->mResourceTearCallback, resource);
+    }
+}
+
+// Two writes are equivalent if they invoke the same callback with the same configuration.
+// A Tear callback resets the Resource instance to its default value, irrespective of the
+// Request being removed, hence two Tears of the same instance are always equivalent.
+static int8_t isSameWrite(const CocoWrite& first, const CocoWrite& second) {
+    if(first.mCallback == nullptr || first.mCallback != second.mCallback) return false;
+    if(first.mIsTear != second.mIsTear) return false;
+    if(first.mIsTear) return true;
+
+    const Resource* firstRes = first.mResource;
+    const Resource* secondRes = second.mResource;
+    if(firstRes == nullptr || secondRes == nullptr) return false;
+
+    if(firstRes->getResCode() != secondRes->getResCode() ||
+       firstRes->getResInfo() != secondRes->getResInfo() ||
+       firstRes->getOptionalInfo() != secondRes->getOptionalInfo() ||
+       firstRes->getValuesCount() != secondRes->getValuesCount()) {
+        return false;
+    }
+
+    for(int32_t i = 0; i < firstRes->getValuesCount(); i++) {
+        if(firstRes->getValueAt(i) != secondRes->getValueAt(i)) return false;
+    }
+    return true;
+}
+
+// Record the write in the Write Plan, replacing any write planned earlier for the same
+// Resource instance. Takes ownership of the Resource copy held by the write.
+// Only writes are compared, and never the state of the Resource Node, which may have been
+// modified since (or not written at all, if the write failed). Hence a write is dropped only
+// if it duplicates the one already planned, which is issued on commit in any case.
+void CocoTable::planWrite(int32_t primaryIndex, int32_t instanceIndex, CocoWrite& write) {
+    int32_t& position = this->mWritePlanPosition[primaryIndex][instanceIndex];
+    if(position >= 0) {
+        CocoWrite& plannedWrite = this->mWritePlan[position].mWrite;
+        if(isSameWrite(write, plannedWrite)) {
+            delete write.mResource;
+            this->mPlanSuppressedWriteCount.fetch_add(1);
+            return;
+        }
+
+        delete plannedWrite.mResource;
+        plannedWrite = write;
+        this->mCoalescedWriteCount.fetch_add(1);
+        return;
+    }
+
+    try {
+        this->mWritePlan.push_back({primaryIndex, instanceIndex, write});
+    } catch(const std::bad_alloc& e) {
+        // Nothing is planned for this instance yet, hence the write can be issued right away.
+        this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], write.mCallback, write.mResource);
+        delete write.mResource;
+        return;
     }
+    position = (int32_t)this->mWritePlan.size() - 1;
+}
+
+void CocoTable::issueWrite(int32_t primaryIndex, int32_t instanceIndex,
+                           ResourceLifecycleCallback callback, Resource* resource, int8_t isTear) {
+    if(!this->mWritePlanOpen) {
+        this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], callback, resource);
+        return;
+    }
+
+    CocoWrite write = {callback, nullptr, isTear};
+    try {
+        write.mResource = new Resource(*resource);
+    } catch(const std::bad_alloc& e) {
+        // Issue the write right away, and cancel any planned write for this instance,
+        // since it would otherwise overwrite this one.
+        int32_t position = this->mWritePlanPosition[primaryIndex][instanceIndex];
+        if(position >= 0) {
+            this->mWritePlan[position].mWrite.mCallback = nullptr;
+        }
+
+        this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], callback, resource);
+        return;
+    }
+
+    this->planWrite(primaryIndex, instanceIndex, write);
+}
+
+void CocoTable::beginWritePlan() {
+    if(!UrmSettings::metaConfigs.mWritePlan) return;
+    this->mWritePlanOpen = true;
+}
+
+void CocoTable::commitWritePlan() {
+    if(!this->mWritePlanOpen) return;
+    this->mWritePlanOpen = false;
+
+    for(CocoPlannedWrite& plannedWrite: this->mWritePlan) {
+        int32_t primaryIndex = plannedWrite.mPrimaryIndex;
+        int32_t instanceIndex = plannedWrite.mInstanceIndex;
+        CocoWrite& write = plannedWrite.mWrite;
+
+        this->mWritePlanPosition[primaryIndex][instanceIndex] = -1;
+
+        // The callback is reset if the write was cancelled.
+        if(write.mCallback != nullptr) {
+            this->mApplierShards->dispatch(this->mShardKeys[primaryIndex], write.mCallback, write.mResource);
+        }
+        delete write.mResource;
+    }
+
+    this->mWritePlan.clear();
+}
+
+int64_t CocoTable::getCoalescedWriteCount() {
+    return this->mCoalescedWriteCount.load();
+}
+
+int64_t CocoTable::getPlanSuppressedWriteCount() {
+    return this->mPlanSuppressedWriteCount.load();
 }
 
 int32_t CocoTable::getCocoTablePrimaryIndex(uint32_t opId) {
@@ -231,8 +325,8 @@ int32_t CocoTable::getCocoTableSecondaryIndex(Resource* resource, int8_t priorit
     return -1;
 }
 
-// Resource Level DLLs manipulation logic
-// The request with the highest priority at the head of the linked list is applied.
+// Resource Level slot manipulation logic
+// The winning configuration (as per the Resource Policy) of the highest priority slot is applied.
 int8_t CocoTable::insertInCocoTable(ResIterable* newNode, int8_t priority) {
     if(newNode == nullptr) return false;
     Resource* resource = (Resource*) newNode->mData;
@@ -249,60 +343,32 @@ int8_t CocoTable::insertInCocoTable(ResIterable* newNode, int8_t priority) {
         return false;
     }
 
-    enum Policy policy = this->mResourceRegistry->getResConf(resource->getResCode())->mPolicy;
-    DLManager* dlm = this->mCocoTable[primaryIndex][secondaryIndex];
+    CocoSlot* slot = this->mCocoTable[primaryIndex][secondaryIndex];
 
     // Unlikely
-    if(dlm == nullptr) {
+    if(slot == nullptr) {
         return false;
     }
 
     if(!this->needsAllocation(resource)) {
         if(rConf->mPolicy == Policy::PASS_THROUGH) {
             // Special handling for resources with policy: "pass_through"
-            dlm->mRank++;
+            slot->mRank++;
         }
         // straightaway apply the action
-        this->fastPathApply(resource);
+        this->fastPathApply(primaryIndex, resource);
         return true;
     }
 
-    switch(policy) {
-        case INSTANT_APPLY: {
-            // Insert this Request at the head of the linked list and apply it.
-            if(RC_IS_OK(dlm->insert(newNode, DLOptions::INSERT_START))) {
-                if(dlm->isNodeNth(0, newNode)) {
-                    this->applyAction(newNode, primaryIndex, priority);
-                }
-            }
-            break;
-        }
-        case HIGHER_BETTER: {
-            // Insert the request in accordance with higher_is_better policy
-            // If the request ends up at the head of the resource DLL, apply it
-            if(RC_IS_OK(dlm->insertWithPolicy(newNode, comparHBetter))) {
-                if(dlm->isNodeNth(0, newNode)) {
-                    this->applyAction(newNode, primaryIndex, priority);
-                }
-            }
-            break;
-        }
-        case LOWER_BETTER: {
-            // Insert the request in accordance with lower_is_better policy
-            // If the request ends up at the head of the resource DLL, apply it
-            if(RC_IS_OK(dlm->insertWithPolicy(newNode, comparLBetter))) {
-                if(dlm->isNodeNth(0, newNode)) {
-                    this->applyAction(newNode, primaryIndex, priority);
-                }
-            }
-            break;
-        }
+    switch(rConf->mPolicy) {
+        case INSTANT_APPLY:
+        case HIGHER_BETTER:
+        case LOWER_BETTER:
         case LAZY_APPLY: {
-            // Insert the request at the end of the Resource DLL.
-            if(RC_IS_OK(dlm->insert(newNode))) {
-                if(dlm->isNodeNth(0, newNode)) {
-                    this->applyAction(newNode, primaryIndex, priority);
-                }
+            // The slot orders the Request in accordance with the Resource Policy,
+            // if it ends up as the winning configuration of the slot, apply it.
+            if(slot->insert(newNode)) {
+                this->applyAction(newNode, primaryIndex, secondaryIndex / TOTAL_PRIORITIES, priority);
             }
             break;
         }
@@ -405,112 +471,193 @@ int8_t CocoTable::updateRequest(Request* req, int64_t duration) {
 
 // Methods for Request Cleanup
 // Phase 1:
-// Iterate over all the resources part of the request and un-configure them
-// If the resource[i] is applied (i.e. at the head of its Resource's DLL), then check if there
-// is any pending configurations (waiting behind it), if found apply it.
-// If the resource[i] is somewhere in the middle (or end) of the DLL, then simply remove it and
-// adjust the prev and next pointers accordingly.
+// Iterate over all the resources part of the request(s) and remove them from their Resource slots.
+// If the resource[i] is applied (i.e. the winning configuration of its slot), then the corresponding
+// Resource instance is marked for re-evaluation.
+// Else, simply remove it from the slot.
 // Phase 2:
+// Re-evaluate each marked Resource instance exactly once, i.e. check if there is any pending
+// configuration (waiting behind the removed ones), if found apply it, else reset the Resource Node.
+// Phase 3:
 // Actually freeing up the Request and its associated memory resources. This is not handled by
 // CocoTable, instead RequestQueue is responsible for freeing up the Request and untracking it
 // from the RequestManager.
-int8_t CocoTable::removeRequest(Request* request) {
-    TYPELOGV(NOTIFY_COCO_TABLE_REMOVAL_START, request->getHandle());
+void CocoTable::detachNode(ResIterable* resIter, int8_t priority, std::vector<CocoReevalInfo>& reevalList) {
+    Resource* resource = (Resource*) resIter->mData;
 
-    if(request == nullptr || request->getResDlMgr() == nullptr) {
-        // nothing to do
-        return 0;
+    int32_t primaryIndex = this->getCocoTablePrimaryIndex(resource->getResCode());
+    int32_t secondaryIndex = this->getCocoTableSecondaryIndex(resource, priority);
+
+    if(primaryIndex < 0 || secondaryIndex < 0 ||
+       primaryIndex >= (int32_t)this->mCocoTable.size() ||
+       secondaryIndex >= (int32_t)this->mCocoTable[primaryIndex].size()) {
+        return;
     }
 
-    DL_ITERATE(request->getResDlMgr()) {
-        if(iter == nullptr) continue;
+    CocoSlot* slot = this->mCocoTable[primaryIndex][secondaryIndex];
+    if(slot == nullptr) return;
 
-        ResIterable* resIter = (ResIterable*) iter;
-        if(resIter == nullptr || resIter->mData == nullptr) continue;
+    ResConfInfo* resourceConfig = this->mResourceRegistry->getResConf(resource->getResCode());
+    if(!this->needsAllocation(resource)) {
+        if(resourceConfig->mPolicy == Policy::PASS_THROUGH) {
+            if(--slot->mRank == 0) {
+                this->fastPathReset(primaryIndex, resource);
+            }
+        } else {
+            this->fastPathReset(primaryIndex, resource);
+        }
+        return;
+    }
 
-        Resource* resource = (Resource*) resIter->mData;
+    // Proceed with removal of the node from CocoTable, noting if it was the
+    // winning (i.e. currently applied) configuration of its slot.
+    int8_t nodeIsHead = slot->remove(resIter);
 
-        int8_t priority = request->getPriority();
-        int32_t primaryIndex = this->getCocoTablePrimaryIndex(resource->getResCode());
-        int32_t secondaryIndex = this->getCocoTableSecondaryIndex(resource, priority);
+    // If node is not head, it implies some other Request is already applied
+    // for this Resource, hence no action is needed here.
+    if(!nodeIsHead) return;
 
-        if(primaryIndex < 0 || secondaryIndex < 0 ||
-           primaryIndex >= (int32_t)this->mCocoTable.size() ||
-           secondaryIndex >= (int32_t)this->mCocoTable[primaryIndex].size()) {
-            continue;
+    // The secondary index of the highest priority list, for this core / cluster / cgroup
+    int32_t secondaryBase = secondaryIndex - priority;
+    for(CocoReevalInfo& reevalInfo: reevalList) {
+        if(reevalInfo.mPrimaryIndex == primaryIndex && reevalInfo.mSecondaryBase == secondaryBase) {
+            if(priority < reevalInfo.mRemovedHeadPriority) {
+                reevalInfo.mRemovedHeadPriority = priority;
+            }
+            return;
         }
+    }
 
-        DLManager* dlm = this->mCocoTable[primaryIndex][secondaryIndex];
-        if(dlm == nullptr) continue;
+    reevalList.push_back({primaryIndex, secondaryBase, priority, resource});
+}
 
-        ResConfInfo* resourceConfig = this->mResourceRegistry->getResConf(resource->getResCode());
-        if(!this->needsAllocation(resource)) {
-            if(resourceConfig->mPolicy == Policy::PASS_THROUGH) {
-                if(--dlm->mRank == 0) {
-                    this->fastPathReset(resource);
-                }
-            } else {
-                this->fastPathReset(resource);
-            }
+// Reset the Resource Node value or if there are pending Requests for this Resource
+// then apply those Requests in the order determined by Resource Policy and Priority Level.
+// Start from the highest priority and look for available requests.
+// If all lists are empty, apply default action.
+void CocoTable::reevaluate(CocoReevalInfo& reevalInfo) {
+    int32_t primaryIndex = reevalInfo.mPrimaryIndex;
+    int32_t instanceIndex = reevalInfo.mSecondaryBase / TOTAL_PRIORITIES;
+
+    for(int32_t prioLevel = 0; prioLevel < TOTAL_PRIORITIES; prioLevel++) {
+        ResIterable* winner = this->mCocoTable[primaryIndex][reevalInfo.mSecondaryBase + prioLevel]->peek();
+        if(winner == nullptr) continue;
+
+        // A Request with a higher priority than the removed ones is
+        // already applied for this Resource instance, no action is needed.
+        if(prioLevel < reevalInfo.mRemovedHeadPriority) return;
+
+        this->mCurrentlyAppliedPriority[primaryIndex][instanceIndex] = prioLevel;
+        this->applyAction(winner, primaryIndex, instanceIndex, prioLevel);
+        return;
+    }
+
+    this->removeAction(primaryIndex, instanceIndex, reevalInfo.mResource);
+}
+
+int8_t CocoTable::removeRequests(const std::vector<Request*>& requests) {
+    std::vector<CocoReevalInfo> reevalList;
+
+    for(Request* request: requests) {
+        if(request == nullptr || request->getResDlMgr() == nullptr) {
+            // nothing to do
             continue;
         }
 
-        // Check if the node is currently at the head of it's resource DLL.
-        int8_t nodeIsHead = dlm->isNodeNth(0, iter);
+        TYPELOGV(NOTIFY_COCO_TABLE_REMOVAL_START, request->getHandle());
 
-        // Proceed with removal of the node from CocoTable
-        dlm->deleteNode(iter);
+        DL_ITERATE(request->getResDlMgr()) {
+            if(iter == nullptr) continue;
 
-        // Reset the Resource Node value or if there are pending Requests for this Resource
-        // then apply those Requests in the order determined by Resource Policy and Priority Level.
+            ResIterable* resIter = (ResIterable*) iter;
+            if(resIter == nullptr || resIter->mData == nullptr) continue;
 
-        // If the current list becomes empty, start from the highest priority
-        // and look for available requests.
-        // If all lists are empty, apply default action.
-        if(dlm->mHead == nullptr) {
-            int8_t allListsEmpty = true;
-            int32_t reIndexIncrement = 0;
+            this->detachNode(resIter, request->getPriority(), reevalList);
+        }
+    }
 
-            if(resourceConfig->mApplyType == ResourceApplyType::APPLY_CORE ||
-                resourceConfig->mApplyType == ResourceApplyType::APPLY_CLUSTER ||
-                resourceConfig->mApplyType == ResourceApplyType::APPLY_CGROUP) {
-                reIndexIncrement = this->getCocoTableSecondaryIndex(resource, SYSTEM_HIGH);
-                if(reIndexIncrement == -1) continue;
-            }
+    // Each affected Resource instance is written at most once.
+    for(CocoReevalInfo& reevalInfo: reevalList) {
+        this->reevaluate(reevalInfo);
+    }
 
-            for(int32_t prioLevel = 0; prioLevel < TOTAL_PRIORITIES; prioLevel++) {
-                if(this->mCocoTable[primaryIndex][prioLevel + reIndexIncrement]->mHead != nullptr) {
-                    this->mCurrentlyAppliedPriority[primaryIndex] = prioLevel;
-                    this->applyAction(
-                        static_cast<ResIterable*>(this->mCocoTable[primaryIndex][prioLevel + reIndexIncrement]->mHead),
-                        primaryIndex,
-                        prioLevel
-                    );
-                    allListsEmpty = false;
-                    break;
-                }
-            }
-            if(allListsEmpty == true) {
-                this->removeAction(primaryIndex, resource);
-            }
+    return true;
+}
 
-        } else {
-            // Current list is not empty.
-            // Check if current node is at the head
-            if(nodeIsHead) {
-                // If it is head, Apply the next node (i.e. the next Request)
-                this->applyAction(static_cast<ResIterable*>(dlm->mHead), primaryIndex, priority);
-            }
-            // If node is not head, it implies some other Request is already applied
-            // for this Resource, hence no action is needed here.
+int8_t CocoTable::removeRequest(Request* request) {
+    if(request == nullptr) return false;
+    return this->removeRequests(std::vector<Request*>{request});
+}
+
+int8_t CocoTable::fetchExpiredHandles(std::vector<int64_t>& handles, std::vector<Request*>& requests) {
+    try {
+        const std::lock_guard<std::mutex> lock(this->mExpiryBatchLock);
+
+        // The trigger has been consumed, a Request expiring from here on queues a new one.
+        this->mExpiryTriggerQueued = false;
+
+        // Reserve before taking the handles, so that they stay in the batch if this fails.
+        requests.reserve(this->mExpiredHandles.size());
+        handles.swap(this->mExpiredHandles);
+        this->mExpiredHandles.clear();
+
+    } catch(const std::exception& e) {
+        TYPELOGV(GENERIC_CALL_FAILURE_LOG, e.what());
+        return false;
+    }
+
+    return true;
+}
+
+// Accumulate the expired handle, and wake up the RequestQueue consumer only if no trigger
+// is queued for the batch yet. Any other Request expiring before the consumer picks up
+// the batch is simply added to it.
+void CocoTable::submitExpiryBatch(int64_t handle) {
+    int8_t triggerQueued = false;
+    try {
+        const std::lock_guard<std::mutex> lock(this->mExpiryBatchLock);
+        this->mExpiredHandles.push_back(handle);
+        triggerQueued = this->mExpiryTriggerQueued;
+        this->mExpiryTriggerQueued = true;
+
+    } catch(const std::exception& e) {
+        TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE_HANDLE, handle, e.what());
+        return;
+    }
+
+    if(triggerQueued) return;
+
+    Message* expiryTrigger = nullptr;
+    try {
+        expiryTrigger = MPLACED(Message);
+    } catch(const std::bad_alloc& e) {
+        TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE_HANDLE, handle, e.what());
+    }
+
+    if(expiryTrigger != nullptr) {
+        expiryTrigger->setRequestType(REQ_RESOURCE_UNTUNING);
+        expiryTrigger->setHandle(handle);
+        expiryTrigger->setPriority(SYSTEM_HIGH);
+        if(RequestQueue::getInstance()->addAndWakeup(expiryTrigger)) {
+            return;
         }
+        FreeBlock<Message>(static_cast<void*>(expiryTrigger));
     }
-    return 0;
+
+    // No trigger could be queued. The handle stays in the batch, and the next
+    // expiry retries queueing the trigger for it.
+    const std::lock_guard<std::mutex> lock(this->mExpiryBatchLock);
+    this->mExpiryTriggerQueued = false;
 }
 
 void CocoTable::timerExpired(Request* request) {
     TYPELOGV(NOTIFY_COCO_TABLE_REQUEST_EXPIRY, request->getHandle());
 
+    if(UrmSettings::metaConfigs.mExpiryBatching) {
+        this->submitExpiryBatch(request->getHandle());
+        return;
+    }
+
     Request* untuneRequest = nullptr;
     try {
         untuneRequest = MPLACED(Request);
@@ -527,7 +674,18 @@ void CocoTable::timerExpired(Request* request) {
 
 // CocoNodes allocated for the Request will be freed up as part of Request Cleanup,
 // Use the Request::cleanUpRequest method, for freeing up these nodes.
+void CocoTable::stopAppliers() {
+    this->mApplierShards->stop();
+}
+
 CocoTable::~CocoTable() {
+    delete this->mApplierShards;
+    this->mApplierShards = nullptr;
+
+    for(CocoPlannedWrite& plannedWrite: this->mWritePlan) {
+        delete plannedWrite.mWrite.mResource;
+    }
+
     for(int32_t i = 0; i < (int32_t)this->mCocoTable.size(); i++) {
         for(int32_t j = 0; j < (int32_t)this->mCocoTable[i].size(); j++) {
             delete(this->mCocoTable[i][j]);
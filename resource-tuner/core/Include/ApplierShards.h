@@ -0,0 +1,91 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef APPLIER_SHARDS_H
+#define APPLIER_SHARDS_H
+
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include <atomic>
+#include <condition_variable>
+
+#include "Resource.h"
+#include "Extensions.h"
+#include "Logger.h"
+
+// Upper bound on the number of Applier Shards.
+static const uint32_t maxApplierShards = 16;
+
+/**
+ * @brief ApplierShards
+ * @details Executes the Resource Applier and Tear callbacks issued by the CocoTable, off the
+ *          RequestQueue consumer thread.\n
+ *          Resources are partitioned into shards by their CocoTable (primary) index, each shard
+ *          being served by a dedicated thread, in FIFO order. Hence all the writes to a given
+ *          Resource are performed in the order in which the CocoTable issued them, while writes to
+ *          Resources in different shards proceed in parallel. A slow write (for example, a cgroup
+ *          migration) only delays the Resources sharing its shard, and never the consumer.
+ *          However, writes to Resources in different shards are not ordered with respect to
+ *          each other, hence sharding is only enabled if configured (more than 1 shard).\n
+ *          The callbacks operate on a copy of the Resource, since the Request owning the original
+ *          may be cleaned up before the write is performed.\n
+ *          With a single shard (or if the shard threads could not be started), the callbacks are
+ *          invoked inline, on the calling thread.
+ */
+class ApplierShards {
+private:
+    typedef struct _applyTask {
+        ResourceLifecycleCallback mCallback;
+        Resource mResource;
+
+        _applyTask(ResourceLifecycleCallback callback, const Resource& resource)
+            : mCallback(callback), mResource(resource) {}
+    } ApplyTask;
+
+    typedef struct {
+        std::deque<ApplyTask> mTasks;
+        std::mutex mShardLock;
+        std::condition_variable mShardCond;
+        int8_t mBusy; //!< Set while a Task of this shard is being executed.
+        std::thread mThread;
+    } Shard;
+
+    std::vector<Shard*> mShards;
+    std::atomic<int8_t> mTerminate;
+    std::atomic<int64_t> mDispatchedCount;
+
+    void shardRoutine(Shard* shard);
+
+public:
+    ApplierShards(uint32_t shardCount);
+    ~ApplierShards();
+
+    /**
+     * @brief Issue a Resource Applier or Tear callback.
+     * @param shardKey Key (the CocoTable primary index) selecting the shard, all the callbacks
+     *                 issued for a given key are executed in order.
+     * @param callback The callback to be invoked.
+     * @param resource The Resource passed to the callback, it is copied if the callback is deferred.
+     */
+    void dispatch(int32_t shardKey, ResourceLifecycleCallback callback, Resource* resource);
+
+    /**
+     * @brief Wait until all the callbacks issued so far have been executed.
+     */
+    void drain();
+
+    /**
+     * @brief Execute the pending callbacks and stop the shard threads.
+     * @details Any callback issued afterwards is invoked inline.
+     */
+    void stop();
+
+    /**
+     * @brief Get the number of callbacks which were deferred to the shard threads.
+     */
+    int64_t getDispatchedCount();
+};
+
+#endif
@@ -0,0 +1,70 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef COCO_SLOT_H
+#define COCO_SLOT_H
+
+#include <vector>
+
+#include "Resource.h"
+#include "Utils.h"
+
+/**
+ * @brief CocoSlot
+ * @details Holds the pending Resource configurations of a single CocoTable slot, i.e. a
+ *          Resource instance (resource x core / cluster / cgroup) at a given priority level.\n
+ *          The slot is an indexed binary heap, ordered as per the Resource Policy:\n
+ *          - INSTANT_APPLY: The most recently inserted configuration wins.\n
+ *          - HIGHER_BETTER / LOWER_BETTER: The configuration with the highest / lowest value wins,
+ *            ties are broken in favour of the earlier insertion.\n
+ *          - LAZY_APPLY: The earliest inserted configuration wins.\n
+ *          Each node records its position in the heap, hence insertion and removal of any node
+ *          are O(log n), and the winning configuration is always available at the top in O(1).
+ *          This keeps contended Resources (with hundreds of concurrent holders) cheap to update.
+ *          Note, the slot does not perform any allocations for the nodes, they are owned by the Request.
+ */
+class CocoSlot {
+private:
+    std::vector<ResIterable*> mHeap;
+    uint64_t mNextSeq;
+    enum Policy mPolicy;
+
+    int8_t isBefore(ResIterable* first, ResIterable* second);
+    void place(ResIterable* node, int32_t pos);
+    void siftUp(int32_t pos);
+    void siftDown(int32_t pos);
+
+public:
+    int32_t mRank; //!< Number of active configurations, only used for "pass_through" Resources.
+
+    CocoSlot(enum Policy policy);
+
+    /**
+     * @brief Insert a Resource configuration into the slot.
+     * @return int8_t:\n
+     *            - 1: If the node was inserted, and is now the winning configuration of the slot.\n
+     *            - 0: Otherwise.
+     */
+    int8_t insert(ResIterable* node);
+
+    /**
+     * @brief Remove a previously inserted Resource configuration from the slot.
+     * @return int8_t:\n
+     *            - 1: If the node was the winning configuration of the slot.\n
+     *            - 0: Otherwise (including if the node is not part of this slot).
+     */
+    int8_t remove(ResIterable* node);
+
+    /**
+     * @brief Get the winning configuration of the slot, nullptr if the slot is empty.
+     */
+    ResIterable* peek() {
+        return this->mHeap.empty() ? nullptr : this->mHeap[0];
+    }
+
+    int32_t getSize() {
+        return (int32_t)this->mHeap.size();
+    }
+};
+
+#endif
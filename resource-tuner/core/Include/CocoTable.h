@@ -17,6 +17,8 @@
 #include "TargetRegistry.h"
 #include "Request.h"
 #include "RequestQueue.h"
+#include "CocoSlot.h"
+#include "ApplierShards.h"
 #include "UrmSettings.h"
 #include "MemoryPool.h"
 #include "Logger.h"
@@ -52,17 +54,18 @@
  *
  * The Concurrency Coordinator needs to honor both, the policy of the resource and the priority of the requests while taking decisions.
  *
- * Algorithm: Create 4 (number of currently supported priorities) doubly linked lists for each resource
+ * Algorithm: Create 4 (number of currently supported priorities) slots for each resource
  * (or for each core in each resource if core level conflict exists).
- * Behavior of each linked list would depend on the policy specified in the resource table.
+ * Each slot is an indexed binary heap (CocoSlot), ordered as per the policy specified in the resource table.
+ * Hence a request can be inserted or removed in O(log n), irrespective of the number of competing requests.
  *
  * Request Flow:\n\n
  * **Tune Request**:\n
  * -# Associate a timer with the requested duration with the request.\n
  * -# Create a CocoNode for each of the Resource part of the Request it requires\n
- * -# Insert each of the CocoNodes to the doubly-linked list corresponding to the Resource and the Priority\n
+ * -# Insert each of the CocoNodes to the slot corresponding to the Resource and the Priority\n
  * -# The Node will be inserted in accordance to the Resource Policy\n
- * -# When the node reaches the head of the Linked List it will be applied, i.e. the value\n
+ * -# When the node becomes the winning configuration of the slot it will be applied, i.e. the value\n
  *    specified by the Tune Request will take effect on that Resource Node.\n
  * -# When the Request Expires, the timer will trigger a Callback and an Untune Request will be issued for
  *    this handle, to clean up the Tune Request and Reset the Resource Nodes.
@@ -80,6 +83,35 @@
  */
 
 
+/**
+ * @brief Tracks a Resource instance (i.e. resource x core / cluster / cgroup), whose applied
+ *        Request was removed from the CocoTable and hence needs to be re-evaluated.
+ */
+typedef struct {
+    int32_t mPrimaryIndex; //!< Index of the Resource in the CocoTable.
+    int32_t mSecondaryBase; //!< Secondary Index of the highest priority list for this instance.
+    int8_t mRemovedHeadPriority; //!< Highest priority level, from which an applied node was removed.
+    Resource* mResource; //!< One of the removed Resources, used for resetting the instance.
+} CocoReevalInfo;
+
+/**
+ * @brief A Resource write (Applier or Tear callback invocation) issued by the CocoTable.
+ */
+typedef struct {
+    ResourceLifecycleCallback mCallback; //!< Callback to be invoked, nullptr if cancelled.
+    Resource* mResource; //!< Copy of the Resource passed to the callback, owned by the CocoTable.
+    int8_t mIsTear; //!< Set if the write resets the Resource instance to its default value.
+} CocoWrite;
+
+/**
+ * @brief A write recorded in the Write Plan, for a given Resource instance.
+ */
+typedef struct {
+    int32_t mPrimaryIndex; //!< Index of the Resource in the CocoTable.
+    int32_t mInstanceIndex; //!< Index of the core / cluster / cgroup instance.
+    CocoWrite mWrite;
+} CocoPlannedWrite;
+
 /**
  * @brief CocoTable
  * @details Concurrency Coordinator, synchronizes and orders the different requests for
@@ -98,22 +130,66 @@ private:
 
     std::shared_ptr<ResourceRegistry> mResourceRegistry;
 
+    /**
+     * @brief Executes the Applier and Tear callbacks, the Resources are sharded by their
+     *        index in the CocoTable, so that the writes to a Resource are performed in order.
+     */
+    ApplierShards* mApplierShards;
+
+    /**
+     * @brief Shard key of each Resource, indexed by the CocoTable (primary) index. The Resources
+     *        with custom (Extension) callbacks all share the same key.
+     */
+    std::vector<int32_t> mShardKeys;
+
     /**
      * @brief The main data structure which is a 2D vector. It stores entries for each resource and each entry stores a priority vector.
-     *        For each resource, for each priority, you store a head (second) and tail (first) pointers to store a linked list in memory.
+     *        For each resource, for each priority, a CocoSlot holds the pending configurations.
+     */
+    std::vector<std::vector<CocoSlot*>> mCocoTable;
+
+    /**
+     * @brief Data structure storing the currently applied priority for each resource instance,
+     *        i.e. indexed by the resource and then by the core / cluster / cgroup (same order as the
+     *        CocoTable entries). Hence a Request only affects the instance it acts on, -1 if none applied.
+     */
+    std::vector<std::vector<int32_t>> mCurrentlyAppliedPriority;
+
+    /**
+     * @brief Write Plan, holding the net write for each Resource instance touched
+     *        while the plan is open, in the order in which the instances were first touched.
+     */
+    int8_t mWritePlanOpen;
+    std::vector<CocoPlannedWrite> mWritePlan;
+
+    /**
+     * @brief Position of the planned write for each Resource instance in the Write Plan,
+     *        -1 if the instance has not been touched. Same layout as mCurrentlyAppliedPriority.
      */
-    std::vector<std::vector<DLManager*>> mCocoTable;
+    std::vector<std::vector<int32_t>> mWritePlanPosition;
+
+    std::atomic<int64_t> mCoalescedWriteCount;
+    std::atomic<int64_t> mPlanSuppressedWriteCount;
 
     /**
-     * @brief Data structure storing the currently applied priority for each resource.
+     * @brief Handles of the Requests which have expired, but are yet to be removed
+     *        by the RequestQueue consumer. Used in Expiry Batching mode.
      */
-    std::vector<int32_t> mCurrentlyAppliedPriority;
+    std::vector<int64_t> mExpiredHandles;
+    int8_t mExpiryTriggerQueued; //!< Set while a trigger for the batch is in the RequestQueue.
+    std::mutex mExpiryBatchLock;
 
     CocoTable();
 
     void timerExpired(Request* req);
-    void applyAction(ResIterable* currNode, int32_t index, int8_t priority);
-    void removeAction(int32_t index, Resource* resource);
+    void submitExpiryBatch(int64_t handle);
+    void detachNode(ResIterable* resIter, int8_t priority, std::vector<CocoReevalInfo>& reevalList);
+    void reevaluate(CocoReevalInfo& reevalInfo);
+    void applyAction(ResIterable* currNode, int32_t primaryIndex, int32_t instanceIndex, int8_t priority);
+    void removeAction(int32_t primaryIndex, int32_t instanceIndex, Resource* resource);
+    void issueWrite(int32_t primaryIndex, int32_t instanceIndex,
+                    ResourceLifecycleCallback callback, Resource* resource, int8_t isTear);
+    void planWrite(int32_t primaryIndex, int32_t instanceIndex, CocoWrite& write);
 
     int32_t getCocoTablePrimaryIndex(uint32_t resCode);
     int32_t getCocoTableSecondaryIndex(Resource* resource, int8_t priority);
@@ -124,8 +200,8 @@ private:
 
     int8_t insertInCocoTable(ResIterable* currNode, int8_t priority);
 
-    void fastPathApply(Resource* resource);
-    void fastPathReset(Resource* resource);
+    void fastPathApply(int32_t primaryIndex, Resource* resource);
+    void fastPathReset(int32_t primaryIndex, Resource* resource);
     int8_t needsAllocation(Resource* res);
 
 public:
@@ -136,7 +212,7 @@ public:
      *        to the desired Resource Nodes.
      * @details As part of this routine, CocoNodes are allocated for each Resource part of
      *          the Request, as well as creating and starting the timer, and finally inserting
-     *          the request to the appropriate Resource level Linked Lists.
+     *          the request to the appropriate Resource level slots.
      * @param req A pointer to the Request to be inserted
      * @return int8_t:\n
      *            - 1: If the Request was inserted successfully into the CocoTable
@@ -148,7 +224,7 @@ public:
      * @brief Used to untune a previously issued Tune Request.
      * @details This routine is invoked when an untune request is received, as part of
      *          the routine, the Request Timer for the corresponding Tune Request will be killed,
-     *          and subsequently the Tune request will be cleaned up from the Resource Level Linked Lists.
+     *          and subsequently the Tune request will be cleaned up from the Resource Level slots.
      *
      * @param req A pointer to the Request to be removed
      * @return int8_t:\n
@@ -157,6 +233,35 @@ public:
      */
     int8_t removeRequest(Request* req);
 
+    /**
+     * @brief Used to remove a batch of Requests in a single pass.
+     * @details The CocoNodes of all the Requests are first removed from the Resource level
+     *          slots, following which each affected Resource instance is re-evaluated
+     *          exactly once. Hence a Resource Node is written at most once per batch, irrespective
+     *          of the number of Requests in the batch which were acting on it.
+     * @param requests Requests to be removed
+     * @return int8_t:\n
+     *            - 1: If the Requests were Removed successfully from the CocoTable
+     *            - 0: Otherwise
+     */
+    int8_t removeRequests(const std::vector<Request*>& requests);
+
+    /**
+     * @brief Used by the RequestQueue consumer to collect the handles of all the Requests
+     *        which have expired since the last call.
+     * @details Only applicable if Expiry Batching is enabled, in which case Request expiry
+     *          does not generate an Untune Request per Request, instead the expired handles are
+     *          accumulated here and a single wakeup is issued to the RequestQueue.
+     *          Room for one Request per handle is reserved in the requests vector before the
+     *          handles are taken, if that fails the handles are left in the batch.
+     * @param handles Vector to be populated with the expired handles.
+     * @param requests Vector which will hold the matching Requests.
+     * @return int8_t:\n
+     *            - 1: If the handles were fetched.\n
+     *            - 0: Otherwise, the handles are fetched along with the next batch.
+     */
+    int8_t fetchExpiredHandles(std::vector<int64_t>& handles, std::vector<Request*>& requests);
+
     /**
      * @brief Used to update the duration of an Active Request
      * @details This routine is invoked when a retune request is received, to modify the
@@ -170,6 +275,40 @@ public:
      */
     int8_t updateRequest(Request* req, int64_t duration);
 
+    /**
+     * @brief Open a Write Plan, spanning a batch of Requests processed by the RequestQueue consumer.
+     * @details While the plan is open, the Applier and Tear callbacks for the CocoTable managed
+     *          Resources are not invoked, instead only the latest write for each Resource instance
+     *          is recorded. Has no effect if Write Plans are disabled.
+     */
+    void beginWritePlan();
+
+    /**
+     * @brief Close the Write Plan, and issue the recorded writes.
+     * @details Exactly one write is issued per Resource instance touched by the batch, in the
+     *          order in which the instances were first touched.
+     */
+    void commitWritePlan();
+
+    /**
+     * @brief Get the number of planned writes which were overwritten by a later (different) write
+     *        of the same Write Plan.
+     */
+    int64_t getCoalescedWriteCount();
+
+    /**
+     * @brief Get the number of writes which were dropped, since they were identical to the write
+     *        already planned for the Resource instance.
+     */
+    int64_t getPlanSuppressedWriteCount();
+
+    /**
+     * @brief Complete the pending Resource writes, and stop the Applier Shards.
+     * @details Must be invoked once the RequestQueue consumer has exited, and before the
+     *          Resources are restored to their default values. Any later write is performed inline.
+     */
+    void stopAppliers();
+
     static std::shared_ptr<CocoTable> getInstance() {
         if(mCocoTableInstance == nullptr) {
             instanceProtectionLock.lock();
@@ -0,0 +1,105 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef NODE_SHADOW_CACHE_H
+#define NODE_SHADOW_CACHE_H
+
+#include <mutex>
+#include <array>
+#include <atomic>
+#include <memory>
+#include <string>
+#include <unordered_map>
+
+#include "AuxRoutines.h"
+#include "UrmSettings.h"
+
+/**
+ * @brief NodeShadowCache
+ * @details Shadows the value last successfully written to each Resource Node by the default
+ *          Applier and Tear callbacks, so that a write of the value the node already holds
+ *          (for example, re-applying a configuration once a higher priority Request with the
+ *          same value leaves) can be skipped, saving the open, write and close, as well as the
+ *          kernel side update.\n
+ *          Since the kernel (or a custom callback) may modify a node underneath, an entry is only
+ *          trusted for the configured validity interval after the write. Failed writes drop the
+ *          entry, and entries can also be invalidated explicitly, per node or altogether.\n
+ *          The cache is accessed by the Applier Shards in parallel, hence it is internally locked.
+ *          Writers must also hold the node's lock (see getNodeLock) across the check, the write
+ *          and the update, else a concurrent write to the same node can leave a stale entry.
+ */
+class NodeShadowCache {
+private:
+    static std::shared_ptr<NodeShadowCache> mNodeShadowCacheInstance;
+    static std::mutex instanceProtectionLock;
+
+    typedef struct {
+        std::string mValue;
+        int64_t mWrittenAt; //!< Timestamp (in milliseconds) of the write.
+    } ShadowEntry;
+
+    std::unordered_map<std::string, ShadowEntry> mShadowEntries;
+    std::mutex mShadowLock;
+
+    // Nodes are hashed onto a fixed set of locks, which serialize the writes to each node.
+    static constexpr size_t NODE_LOCK_COUNT = 32;
+    std::array<std::mutex, NODE_LOCK_COUNT> mNodeLocks;
+
+    std::atomic<int64_t> mIssuedWriteCount;
+    std::atomic<int64_t> mSuppressedWriteCount;
+
+    NodeShadowCache();
+
+public:
+    /**
+     * @brief Get the lock serializing the writes to the node.
+     * @details Held by the writer across isWriteRedundant, the write itself and the following
+     *          update or invalidate, so that the entry always matches the last write performed.
+     */
+    std::mutex& getNodeLock(const std::string& nodePath);
+
+    /**
+     * @brief Check if the node is known to already hold the given value.
+     * @details The write is counted as suppressed if so, else as issued.
+     * @return int8_t:\n
+     *            - 1: If the node holds the value, i.e. the write can be skipped.\n
+     *            - 0: Otherwise, or if the cache is disabled.
+     */
+    int8_t isWriteRedundant(const std::string& nodePath, const std::string& value);
+
+    /**
+     * @brief Record the value successfully written to the node.
+     */
+    void update(const std::string& nodePath, const std::string& value);
+
+    /**
+     * @brief Drop the shadowed value for the node, the next write to it will always be performed.
+     */
+    void invalidate(const std::string& nodePath);
+
+    /**
+     * @brief Drop the shadowed values for all the nodes.
+     */
+    void invalidateAll();
+
+    int64_t getIssuedWriteCount();
+    int64_t getSuppressedWriteCount();
+
+    static std::shared_ptr<NodeShadowCache> getInstance() {
+        if(mNodeShadowCacheInstance == nullptr) {
+            instanceProtectionLock.lock();
+            if(mNodeShadowCacheInstance == nullptr) {
+                try {
+                    mNodeShadowCacheInstance = std::shared_ptr<NodeShadowCache> (new NodeShadowCache());
+                } catch(const std::bad_alloc& e) {
+                    instanceProtectionLock.unlock();
+                    return nullptr;
+                }
+            }
+            instanceProtectionLock.unlock();
+        }
+        return mNodeShadowCacheInstance;
+    }
+};
+
+#endif
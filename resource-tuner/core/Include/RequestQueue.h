@@ -22,10 +22,15 @@ private:
 
     RequestQueue();
 
+    void processExpiryBatch();
+    void discardMessage(Message* message);
+    int8_t processMessage(Message* message);
+
 public:
     ~RequestQueue();
 
     void orderedQueueConsumerHook();
+    void orderedQueueBatchHook(std::vector<Message*>& batch);
 
     static std::shared_ptr<RequestQueue> getInstance() {
         if(mRequestQueueInstance == nullptr) {
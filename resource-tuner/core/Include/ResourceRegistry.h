@@ -7,6 +7,7 @@
 #include <vector>
 #include <memory>
 #include <unordered_map>
+#include <mutex>
 
 #include "Utils.h"
 #include "Logger.h"
@@ -102,6 +103,7 @@ private:
     std::vector<ResConfInfo*> mResourceConfigs;
     std::unordered_map<uint32_t, int32_t> mSILMap;
     std::unordered_map<std::string, std::string> mDefaultValueStore;
+    std::mutex mDefaultValueLock; //!< The store is updated by the Resource callbacks, which may run in parallel.
 
     ResourceRegistry();
 
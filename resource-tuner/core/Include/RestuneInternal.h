@@ -20,14 +20,30 @@
 #include "ResourceRegistry.h"
 #include "PropertiesRegistry.h"
 
+/**
+ * @brief Decode a Resource Provisioning Request message into a Memory Pool allocated Request.
+ * @details The message is parsed (and bounds checked) in place, hence its buffer need not outlive
+ *          the call. The handle carried by a Tune Request is replaced with the one assigned to
+ *          the message (info->mHandle).
+ * @param info The message, as received from the client.
+ * @return Request*: The decoded Request, or nullptr if the message is malformed.
+ */
+Request* decodeResProvisionReqMsg(MsgForwardInfo* info);
+
 /**
  * @brief Submit a Resource Provisioning Request from a Client for processing.
- * @details Note: This API acts an interface for other Resource Tuner components like Signals
- *          to submit a Resource Provisioning Request to the Resource Tuner Server, and
- *          subsequently provision the desired Resources.
- * @param request A buffer holding the Request.
+ * @details Meant to be run as a ThreadPool task, the Request is owned by the task.
+ * @param request A Request, as returned by decodeResProvisionReqMsg.
+ */
+void submitDecodedResProvisionReq(void* request);
+
+/**
+ * @brief Submit the Tune Requests carried by a REQ_RESOURCE_TUNING_BATCH message for processing.
+ * @details The Requests are assigned consecutive handles, starting at the handle of the message.
+ *          The message layout must have been validated by the caller.
+ * @param request A buffer holding the batch.
  */
-void submitResProvisionReqMsg(void* request);
+void submitResProvisionBatchMsg(void* request);
 
 void submitResProvisionRequest(Request* request, int8_t isVerified);
 
@@ -114,6 +114,9 @@ public:
 
     void addCacheInfoMapping(CacheInfo* cacheInfo);
 
+    // Method for adding daemon Thread configs from InitConfig.yaml
+    void addThreadConfigMapping(ThreadConfigInfo* threadConfigInfo);
+
     void getClusterIDs(std::vector<int32_t>& clusterIDs);
 
     /**
@@ -226,6 +229,25 @@ public:
     CacheInfo* build();
 };
 
+class ThreadConfigInfoBuilder {
+private:
+    ThreadConfigInfo* mThreadConfigInfo;
+
+public:
+    ThreadConfigInfoBuilder();
+
+    ErrCode setName(const std::string& threadClassName);
+    ErrCode setCpuSet(const std::string& cpuSet);
+    ErrCode setSchedPolicy(const std::string& policy);
+    ErrCode setPriority(const std::string& priority);
+    ErrCode setNice(const std::string& nice);
+    ErrCode setUclampMin(const std::string& uclampMin);
+    ErrCode setUclampMax(const std::string& uclampMax);
+    ErrCode validate();
+
+    ThreadConfigInfo* build();
+};
+
 // Utility to fetch target-specific information
 uint64_t GET_TARGET_INFO(int32_t option,
                          int32_t numArgs,
@@ -0,0 +1,74 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include "NodeShadowCache.h"
+
+std::shared_ptr<NodeShadowCache> NodeShadowCache::mNodeShadowCacheInstance = nullptr;
+std::mutex NodeShadowCache::instanceProtectionLock {};
+
+NodeShadowCache::NodeShadowCache() {
+    this->mIssuedWriteCount.store(0);
+    this->mSuppressedWriteCount.store(0);
+}
+
+std::mutex& NodeShadowCache::getNodeLock(const std::string& nodePath) {
+    return this->mNodeLocks[std::hash<std::string>{}(nodePath) % NODE_LOCK_COUNT];
+}
+
+int8_t NodeShadowCache::isWriteRedundant(const std::string& nodePath, const std::string& value) {
+    // A validity interval of 0 disables the cache
+    int64_t validity = UrmSettings::metaConfigs.mNodeShadowValidity;
+    if(validity == 0) {
+        this->mIssuedWriteCount.fetch_add(1);
+        return false;
+    }
+
+    int8_t redundant = false;
+    {
+        const std::lock_guard<std::mutex> lock(this->mShadowLock);
+        auto entry = this->mShadowEntries.find(nodePath);
+        if(entry != this->mShadowEntries.end() && entry->second.mValue == value) {
+            int64_t age = AuxRoutines::getCurrentTimeInMilliseconds() - entry->second.mWrittenAt;
+            redundant = (age >= 0 && age < validity);
+        }
+    }
+
+    if(redundant) {
+        this->mSuppressedWriteCount.fetch_add(1);
+    } else {
+        this->mIssuedWriteCount.fetch_add(1);
+    }
+    return redundant;
+}
+
+void NodeShadowCache::update(const std::string& nodePath, const std::string& value) {
+    if(UrmSettings::metaConfigs.mNodeShadowValidity == 0) return;
+
+    try {
+        const std::lock_guard<std::mutex> lock(this->mShadowLock);
+        ShadowEntry& entry = this->mShadowEntries[nodePath];
+        entry.mValue = value;
+        entry.mWrittenAt = AuxRoutines::getCurrentTimeInMilliseconds();
+    } catch(const std::bad_alloc& e) {
+        // Not shadowed, the next write to the node will simply be performed.
+        this->invalidate(nodePath);
+    }
+}
+
+void NodeShadowCache::invalidate(const std::string& nodePath) {
+    const std::lock_guard<std::mutex> lock(this->mShadowLock);
+    this->mShadowEntries.erase(nodePath);
+}
+
+void NodeShadowCache::invalidateAll() {
+    const std::lock_guard<std::mutex> lock(this->mShadowLock);
+    this->mShadowEntries.clear();
+}
+
+int64_t NodeShadowCache::getIssuedWriteCount() {
+    return this->mIssuedWriteCount.load();
+}
+
+int64_t NodeShadowCache::getSuppressedWriteCount() {
+    return this->mSuppressedWriteCount.load();
+}
@@ -350,33 +350,67 @@ void submitResProvisionRequest(Request* request, int8_t isValidated) {
     processIncomingRequest(request, isValidated);
 }
 
-void submitResProvisionReqMsg(void* msg) {
-    if(msg == nullptr) return;
+Request* decodeResProvisionReqMsg(MsgForwardInfo* info) {
+    if(info == nullptr) return nullptr;
 
-    MsgForwardInfo* info = (MsgForwardInfo*) msg;
     Request* request = nullptr;
-
-    if(info == nullptr) return;
-
     try {
         request = MPLACED(Request);
-        if(RC_IS_NOTOK(request->deserialize(info->mBuffer))) {
+        if(RC_IS_NOTOK(request->deserialize(info->mBuffer, info->mBufferSize))) {
             Request::cleanUpRequest(request);
-        } else {
-            if(request->getRequestType() == REQ_RESOURCE_TUNING) {
-                request->setHandle(info->mHandle);
-            }
-            processIncomingRequest(request);
+            return nullptr;
+        }
+
+        if(request->getRequestType() == REQ_RESOURCE_TUNING) {
+            request->setHandle(info->mHandle);
         }
 
     } catch(const std::bad_alloc& e) {
         TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE, e.what());
+        return nullptr;
     }
 
-    if(info != nullptr) {
-        FreeBlock<char[REQ_BUFFER_SIZE]>(info->mBuffer);
-        FreeBlock<MsgForwardInfo>(info);
+    return request;
+}
+
+void submitDecodedResProvisionReq(void* request) {
+    if(request == nullptr) return;
+    processIncomingRequest((Request*) request);
+}
+
+void submitResProvisionBatchMsg(void* msg) {
+    MsgForwardInfo* info = (MsgForwardInfo*) msg;
+    if(info == nullptr) return;
+
+    // Layout: module, type, numRequests, {entrySize, Tune Request} x numRequests
+    char* ptr = info->mBuffer + 2 * sizeof(int8_t);
+    int32_t numRequests = 0;
+    std::memcpy(&numRequests, ptr, sizeof(int32_t));
+    ptr += sizeof(int32_t);
+
+    for(int32_t i = 0; i < numRequests; i++) {
+        uint32_t entrySize = 0;
+        std::memcpy(&entrySize, ptr, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+
+        Request* request = nullptr;
+        try {
+            request = MPLACED(Request);
+            if(RC_IS_NOTOK(request->deserialize(ptr, entrySize))) {
+                Request::cleanUpRequest(request);
+            } else {
+                request->setHandle(info->mHandle + i);
+                processIncomingRequest(request);
+            }
+
+        } catch(const std::bad_alloc& e) {
+            TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE, e.what());
+        }
+
+        ptr += entrySize;
     }
+
+    AuxRoutines::freeMsgForwardInfo(info);
 }
 
 size_t submitPropGetRequest(void* msg, std::string& result) {
@@ -390,21 +424,19 @@ size_t submitPropGetRequest(void* msg, std::string& result) {
         return 0;
     }
 
-    int8_t* ptr8 = (int8_t*)info->mBuffer;
-    DEREF_AND_INCR(ptr8, int8_t);
-    DEREF_AND_INCR(ptr8, int8_t);
-
-    uint64_t* ptr64 = (uint64_t*)ptr8;
-    DEREF_AND_INCR(ptr64, uint64_t);
-
-    char* charIterator = (char*)ptr64;
-    const char* propNamePtr = charIterator;
+    // Layout: module, type, client buffer size, property name
+    size_t nameOffset = 2 * sizeof(int8_t) + sizeof(uint64_t);
+    if(info->mBufferSize <= nameOffset) {
+        return 0;
+    }
 
-    while(*charIterator != '\0') {
-        charIterator++;
+    const char* propNamePtr = info->mBuffer + nameOffset;
+    size_t nameLen = strnlen(propNamePtr, info->mBufferSize - nameOffset);
+    if(nameOffset + nameLen >= info->mBufferSize) {
+        // Unterminated property name
+        return 0;
     }
-    charIterator++;
-    std::string propName = propNamePtr;
+    std::string propName(propNamePtr, nameLen);
 
     std::string buffer = "";
     size_t writtenBytes = propReg->queryProperty(propName, buffer);
@@ -1,96 +1,207 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <algorithm>
+
 #include "RequestQueue.h"
 
 std::shared_ptr<RequestQueue> RequestQueue::mRequestQueueInstance = nullptr;
 std::mutex RequestQueue::instanceProtectionLock{};
 
-RequestQueue::RequestQueue() {}
+RequestQueue::RequestQueue()
+    : OrderedQueue((OrderedQueueMode)UrmSettings::metaConfigs.mRequestQueueMode) {}
 
-void RequestQueue::orderedQueueConsumerHook() {
+// Remove all the expired Requests from the CocoTable in a single pass, so that
+// each affected Resource is re-evaluated (and written) at most once per batch.
+void RequestQueue::processExpiryBatch() {
     std::shared_ptr<RequestManager> requestManager = RequestManager::getInstance();
     std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
 
-    while(this->hasPendingTasks()) {
-        Message* message = this->pop();
-        if(message == nullptr) {
+    std::vector<int64_t> expiredHandles;
+    std::vector<Request*> expiredRequests;
+    if(!cocoTable->fetchExpiredHandles(expiredHandles, expiredRequests)) {
+        return;
+    }
+
+    // A Request retuned after expiring can expire again before the batch is processed,
+    // hence the same handle may be present more than once.
+    std::sort(expiredHandles.begin(), expiredHandles.end());
+    expiredHandles.erase(std::unique(expiredHandles.begin(), expiredHandles.end()), expiredHandles.end());
+
+    for(int64_t handle: expiredHandles) {
+        RequestInfo matchingTuneReq = requestManager->getRequestFromMap(handle);
+
+        int8_t processingStatus = matchingTuneReq.second;
+        if(matchingTuneReq.first == nullptr || (processingStatus & REQ_NOT_FOUND)) {
+            // Request has already been untuned.
             continue;
         }
 
-        // This is a custom Request used to clean up the Server.
-        if(message->getPriority() == SERVER_CLEANUP_TRIGGER_PRIORITY) {
-            return;
+        if((processingStatus & REQ_COMPLETED) == 0) {
+            // Request has not entered the Coco Table yet.
+            continue;
         }
 
-        Request* req = dynamic_cast<Request*>(message);
-        if(req == nullptr) {
+        // The expiry is stale if the Request has since been retuned,
+        // i.e. it no longer expires, or its new timer is yet to fire.
+        Timer* requestTimer = matchingTuneReq.first->getTimer();
+        if(matchingTuneReq.first->getDuration() == -1 ||
+           (requestTimer != nullptr && requestTimer->isArmed())) {
             continue;
         }
 
-        if(req->getRequestType() == REQ_RESOURCE_TUNING) {
-            int8_t requestProcessingStatus = requestManager->getRequestProcessingStatus(req->getHandle());
-            if((requestProcessingStatus & REQ_CANCELLED) || (requestProcessingStatus & REQ_COMPLETED)) {
-                // Request has already been untuned or expired (Edge Cases)
-                // No need to process it again.
+        expiredRequests.push_back(matchingTuneReq.first);
+    }
 
-                // Remove from RequestManager
-                requestManager->removeRequest(req);
-                Request::cleanUpRequest(req);
-                continue;
-            }
+    cocoTable->removeRequests(expiredRequests);
+
+    for(Request* request: expiredRequests) {
+        requestManager->removeRequest(request);
+        Request::cleanUpRequest(request);
+    }
+}
+
+// Free a Message which will not be processed, since the Server is being cleaned up.
+void RequestQueue::discardMessage(Message* message) {
+    if(message == nullptr) return;
+
+    Request* req = dynamic_cast<Request*>(message);
+    if(req == nullptr) {
+        // Cleanup or Expiry Batch trigger
+        FreeBlock<Message>(static_cast<void*>(message));
+        return;
+    }
+
+    // Tune Requests are added to the RequestManager before being enqueued.
+    if(req->getRequestType() == REQ_RESOURCE_TUNING) {
+        RequestManager::getInstance()->removeRequest(req);
+    }
+    Request::cleanUpRequest(req);
+}
 
-            requestManager->markRequestAsComplete(req->getHandle());
+// Process a single Message popped from the Queue.
+// Returns false if the Message is the Server cleanup trigger, true otherwise.
+int8_t RequestQueue::processMessage(Message* message) {
+    std::shared_ptr<RequestManager> requestManager = RequestManager::getInstance();
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
+
+    if(message == nullptr) {
+        return true;
+    }
 
-            if(!cocoTable->insertRequest(req)) {
-                // Request could not be inserted, clean it up.
-                requestManager->removeRequest(req);
+    // This is a custom Request used to clean up the Server.
+    if(message->getPriority() == SERVER_CLEANUP_TRIGGER_PRIORITY) {
+        return false;
+    }
+
+    Request* req = dynamic_cast<Request*>(message);
+    if(req == nullptr) {
+        // Trigger for the batch of Requests which have expired since the last batch.
+        if(message->getRequestType() == REQ_RESOURCE_UNTUNING) {
+            this->processExpiryBatch();
+            FreeBlock<Message>(static_cast<void*>(message));
+        }
+        return true;
+    }
+
+    if(req->getRequestType() == REQ_RESOURCE_TUNING) {
+        int8_t requestProcessingStatus = requestManager->getRequestProcessingStatus(req->getHandle());
+        if((requestProcessingStatus & REQ_CANCELLED) || (requestProcessingStatus & REQ_COMPLETED)) {
+            // Request has already been untuned or expired (Edge Cases)
+            // No need to process it again.
+
+            // Remove from RequestManager
+            requestManager->removeRequest(req);
+            Request::cleanUpRequest(req);
+            return true;
+        }
+
+        requestManager->markRequestAsComplete(req->getHandle());
+
+        if(!cocoTable->insertRequest(req)) {
+            // Request could not be inserted, clean it up.
+            requestManager->removeRequest(req);
+            Request::cleanUpRequest(req);
+            return true;
+        }
+
+    } else {
+        // For Tune and Untune Requests, get the Corresponding Tune Request from the RequestManager
+        RequestInfo matchingTuneReq = requestManager->getRequestFromMap(req->getHandle());
+
+        int8_t processingStatus = matchingTuneReq.second;
+        if(matchingTuneReq.first == nullptr || (processingStatus & REQ_NOT_FOUND)) {
+            // Note by this point, the Client is ascertained to be in the Client Data Manager Table
+
+            Request::cleanUpRequest(req);
+            return true;
+        }
+
+        if(req->getRequestType() == REQ_RESOURCE_UNTUNING) {
+            // Request is in RM, ensure it has entered Coco Table before issuing untune.
+            if((processingStatus & REQ_COMPLETED) == 0) {
                 Request::cleanUpRequest(req);
-                continue;
+                return true;
             }
 
-        } else {
-            // For Tune and Untune Requests, get the Corresponding Tune Request from the RequestManager
-            RequestInfo matchingTuneReq = requestManager->getRequestFromMap(req->getHandle());
+            cocoTable->removeRequest(matchingTuneReq.first);
+            requestManager->removeRequest(matchingTuneReq.first);
 
-            int8_t processingStatus = matchingTuneReq.second;
-            if(matchingTuneReq.first == nullptr || (processingStatus & REQ_NOT_FOUND)) {
-                // Note by this point, the Client is ascertained to be in the Client Data Manager Table
+            // Free Up the Untune Request
+            Request::cleanUpRequest(req);
+            Request::cleanUpRequest(matchingTuneReq.first);
 
-                Request::cleanUpRequest(req);
-                continue;
+        } else if(req->getRequestType() == REQ_RESOURCE_RETUNING) {
+            int64_t newDuration = req->getDuration();
+
+            if((processingStatus & REQ_COMPLETED) == 0) {
+                // Request not in Coco Table yet
+                // Update the Request Duration directly.
+                matchingTuneReq.first->setDuration(newDuration);
+            } else {
+                cocoTable->updateRequest(matchingTuneReq.first, newDuration);
             }
 
-            if(req->getRequestType() == REQ_RESOURCE_UNTUNING) {
-                // Request is in RM, ensure it has entered Coco Table before issuing untune.
-                if((processingStatus & REQ_COMPLETED) == 0) {
-                    Request::cleanUpRequest(req);
-                    continue;
-                }
+            // Free Up the Retune Request
+            Request::cleanUpRequest(req);
+        }
+    }
 
-                cocoTable->removeRequest(matchingTuneReq.first);
-                requestManager->removeRequest(matchingTuneReq.first);
+    return true;
+}
 
-                // Free Up the Untune Request
-                Request::cleanUpRequest(req);
-                Request::cleanUpRequest(matchingTuneReq.first);
+// The Resource writes issued while processing the drained Messages are collected into
+// a single Write Plan, so that each Resource instance is written at most once.
+void RequestQueue::orderedQueueConsumerHook() {
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
 
-            } else if(req->getRequestType() == REQ_RESOURCE_RETUNING) {
-                int64_t newDuration = req->getDuration();
+    cocoTable->beginWritePlan();
+    while(this->hasPendingTasks()) {
+        Message* message = this->pop();
+        if(!this->processMessage(message)) {
+            this->discardMessage(message);
+            break;
+        }
+    }
+    cocoTable->commitWritePlan();
+}
 
-                if((processingStatus & REQ_COMPLETED) == 0) {
-                    // Request not in Coco Table yet
-                    // Update the Request Duration directly.
-                    matchingTuneReq.first->setDuration(newDuration);
-                } else {
-                    cocoTable->updateRequest(matchingTuneReq.first, newDuration);
-                }
+void RequestQueue::orderedQueueBatchHook(std::vector<Message*>& batch) {
+    LOGD("RESTUNE_REQUEST_QUEUE", "Processing batch of size: " + std::to_string(batch.size()));
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
 
-                // Free Up the Retune Request
-                Request::cleanUpRequest(req);
+    cocoTable->beginWritePlan();
+    for(size_t i = 0; i < batch.size(); i++) {
+        if(!this->processMessage(batch[i])) {
+            // The rest of the batch has already been taken off the Queue, hence it
+            // needs to be freed here, along with the cleanup trigger itself.
+            for(size_t j = i; j < batch.size(); j++) {
+                this->discardMessage(batch[j]);
             }
+            break;
         }
     }
+    cocoTable->commitWritePlan();
 }
 
 RequestQueue::~RequestQueue() {}
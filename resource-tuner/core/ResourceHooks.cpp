@@ -9,6 +9,7 @@
 #include "Extensions.h"
 #include "TargetRegistry.h"
 #include "ResourceRegistry.h"
+#include "NodeShadowCache.h"
 
 static std::string getFullResourceNodePath(ResConfInfo* rConf, int32_t id) {
     if(rConf == nullptr) return "";
@@ -36,6 +37,45 @@ static std::string getCGroupTypeResourceNodePath(Resource* resource, const std::
     return filePath;
 }
 
+// Write the value to the Resource Node, unless the node is known to already hold it.
+// If the Shadow Cache could not be allocated, the write is always performed.
+static void writeToResourceNode(const std::string& nodePath, const std::string& value) {
+    std::shared_ptr<NodeShadowCache> nodeShadowCache = NodeShadowCache::getInstance();
+
+    // Applier Shards may write to the same node concurrently, the node's lock keeps the
+    // shadowed value in line with the write which was performed last.
+    std::unique_lock<std::mutex> nodeLock;
+    if(nodeShadowCache != nullptr) {
+        nodeLock = std::unique_lock<std::mutex>(nodeShadowCache->getNodeLock(nodePath));
+    }
+
+    if(nodeShadowCache != nullptr && nodeShadowCache->isWriteRedundant(nodePath, value)) {
+        LOGD("RESTUNE_COCO_TABLE", "Node: " + nodePath + " already holds: " + value + ", skipping write");
+        return;
+    }
+
+    std::ofstream resourceFileStream(nodePath);
+    if(!resourceFileStream.is_open()) {
+        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
+        if(nodeShadowCache != nullptr) {
+            nodeShadowCache->invalidate(nodePath);
+        }
+        return;
+    }
+
+    resourceFileStream<<value<<std::endl;
+
+    if(resourceFileStream.fail()) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        if(nodeShadowCache != nullptr) {
+            nodeShadowCache->invalidate(nodePath);
+        }
+    } else if(nodeShadowCache != nullptr) {
+        nodeShadowCache->update(nodePath, value);
+    }
+    resourceFileStream.close();
+}
+
 // Default Applier Callback for Resources with ApplyType = "cluster"
 void defaultClusterLevelApplierCb(void* context) {
     if(context == nullptr) return;
@@ -62,18 +102,7 @@ void defaultClusterLevelApplierCb(void* context) {
     }
 
     TYPELOGV(NOTIFY_NODE_WRITE, resourceNodePath.c_str(), valueToBeWritten);
-    std::ofstream resourceFileStream(resourceNodePath);
-    if(!resourceFileStream.is_open()) {
-        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-        return;
-    }
-
-    resourceFileStream<<translatedValue<<std::endl;
-
-    if(resourceFileStream.fail()) {
-        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-    }
-    resourceFileStream.close();
+    writeToResourceNode(resourceNodePath, std::to_string(translatedValue));
 }
 
 // Default Tear Callback for Resources with ApplyType = "cluster"
@@ -90,18 +119,7 @@ void defaultClusterLevelTearCb(void* context) {
     std::string defVal = ResourceRegistry::getInstance()->getDefaultValue(resourceNodePath);
 
     TYPELOGV(NOTIFY_NODE_RESET, resourceNodePath.c_str(), defVal.c_str());
-    std::ofstream resourceFileStream(resourceNodePath);
-    if(!resourceFileStream.is_open()) {
-        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-        return;
-    }
-
-    resourceFileStream<<defVal<<std::endl;
-
-    if(resourceFileStream.fail()) {
-        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-    }
-    resourceFileStream.close();
+    writeToResourceNode(resourceNodePath, defVal);
 }
 
 static void defaultCoreLevelApplierHelper(Resource* resource, int32_t coreID) {
@@ -125,18 +143,7 @@ static void defaultCoreLevelApplierHelper(Resource* resource, int32_t coreID) {
     }
 
     TYPELOGV(NOTIFY_NODE_WRITE, resourceNodePath.c_str(), valueToBeWritten);
-    std::ofstream resourceFileStream(resourceNodePath);
-    if(!resourceFileStream.is_open()) {
-        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-        return;
-    }
-
-    resourceFileStream<<translatedValue<<std::endl;
-
-    if(resourceFileStream.fail()) {
-        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-    }
-    resourceFileStream.close();
+    writeToResourceNode(resourceNodePath, std::to_string(translatedValue));
 }
 
 // Default Applier Callback for Resources with ApplyType = "core"
@@ -173,18 +180,7 @@ static void defaultCoreLevelTearHelper(Resource* resource, int32_t coreID) {
     std::string defVal = ResourceRegistry::getInstance()->getDefaultValue(resourceNodePath);
 
     TYPELOGV(NOTIFY_NODE_RESET, resourceNodePath.c_str(), defVal.c_str());
-    std::ofstream controllerFile(resourceNodePath);
-    if(!controllerFile.is_open()) {
-        TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-        return;
-    }
-
-    controllerFile<<defVal<<std::endl;
-
-    if(controllerFile.fail()) {
-        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-    }
-    controllerFile.close();
+    writeToResourceNode(resourceNodePath, defVal);
 }
 
 // Default Tear Callback for Resources with ApplyType = "core"
@@ -244,18 +240,7 @@ void defaultCGroupLevelApplierCb(void* context) {
 
             TYPELOGV(NOTIFY_NODE_WRITE, controllerFilePath.c_str(), valueToBeWritten);
             LOGD("RESTUNE_COCO_TABLE", "Actual value to be written = " + std::to_string(translatedValue));
-            std::ofstream controllerFile(controllerFilePath);
-            if(!controllerFile.is_open()) {
-                TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-                return;
-            }
-
-            controllerFile<<translatedValue<<std::endl;
-
-            if(controllerFile.fail()) {
-                TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-            }
-            controllerFile.close();
+            writeToResourceNode(controllerFilePath, std::to_string(translatedValue));
         }
     } else {
         TYPELOGV(VERIFIER_CGROUP_NOT_FOUND, cGroupIdentifier);
@@ -286,18 +271,7 @@ void defaultCGroupLevelTearCb(void* context) {
         std::string defVal = ResourceRegistry::getInstance()->getDefaultValue(controllerFilePath);
 
         TYPELOGV(NOTIFY_NODE_RESET, controllerFilePath.c_str(), defVal.c_str());
-        std::ofstream controllerFile(controllerFilePath);
-        if(!controllerFile.is_open()) {
-            TYPELOGV(ERRNO_LOG, "open", strerror(errno));
-            return;
-        }
-
-        controllerFile<<defVal<<std::endl;
-
-        if(controllerFile.fail()) {
-            TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-        }
-        controllerFile.close();
+        writeToResourceNode(controllerFilePath, defVal);
     }
 }
 
@@ -319,7 +293,7 @@ void defaultGlobalLevelApplierCb(void* context) {
     }
 
     TYPELOGV(NOTIFY_NODE_WRITE, resourceNodePath.c_str(), valueToWrite);
-    AuxRoutines::writeToFile(resourceNodePath, std::to_string(valueToWrite));
+    writeToResourceNode(resourceNodePath, std::to_string(valueToWrite));
 }
 
 // Default Tear Callback for Resources with ApplyType = "global"
@@ -339,7 +313,7 @@ void defaultGlobalLevelTearCb(void* context) {
 
     std::string defVal = ResourceRegistry::getInstance()->getDefaultValue(resourceNodePath);
     TYPELOGV(NOTIFY_NODE_RESET, resourceNodePath.c_str(), defVal.c_str());
-    AuxRoutines::writeToFile(resourceNodePath, defVal);
+    writeToResourceNode(resourceNodePath, defVal);
 }
 
 // Specific callbacks for certain special Resources (which cannot be handled via the default versions)
@@ -5,6 +5,7 @@
 #include "AuxRoutines.h"
 #include "UrmSettings.h"
 #include "TargetRegistry.h"
+#include "NodeShadowCache.h"
 
 static const int32_t unsupportedResoure = -2;
 
@@ -42,6 +43,7 @@ void ResourceRegistry::setLifeCycleCallbacks(ResConfInfo* resourceConfigInfo) {
 }
 
 void ResourceRegistry::addDefaultValue(const std::string& filePath, const std::string& value) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueLock);
     this->mDefaultValueStore[filePath] = value;
 
     // std::fstream persistenceFile(UrmSettings::mPersistenceFile, std::ios::out | std::ios::app);
@@ -174,10 +176,12 @@ int32_t ResourceRegistry::getTotalResourcesCount() {
 }
 
 std::string ResourceRegistry::getDefaultValue(const std::string& filePath) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueLock);
     return this->mDefaultValueStore[filePath];
 }
 
 void ResourceRegistry::deleteDefaultValue(const std::string& filePath) {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueLock);
     this->mDefaultValueStore.erase(filePath);
 }
 
@@ -201,12 +205,22 @@ void ResourceRegistry::pluginModifications() {
 }
 
 void ResourceRegistry::restoreResourcesToDefaultValues() {
+    const std::lock_guard<std::mutex> lock(this->mDefaultValueLock);
     for(std::pair<std::string, std::string> defaultConfig: this->mDefaultValueStore) {
         std::string filePath = defaultConfig.first;
         std::string value = defaultConfig.second;
 
         AuxRoutines::writeToFile(filePath, value);
     }
+
+    // The nodes no longer hold the values last written by the Resource callbacks.
+    std::shared_ptr<NodeShadowCache> nodeShadowCache = NodeShadowCache::getInstance();
+    if(nodeShadowCache != nullptr) {
+        LOGI("RESTUNE_RESOURCE_REGISTRY",
+             "Node writes issued: " + std::to_string(nodeShadowCache->getIssuedWriteCount()) +
+             ", suppressed: " + std::to_string(nodeShadowCache->getSuppressedWriteCount()));
+        nodeShadowCache->invalidateAll();
+    }
 }
 
 ResourceRegistry::~ResourceRegistry() {
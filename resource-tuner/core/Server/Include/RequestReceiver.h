@@ -8,6 +8,8 @@
 #include <cstring>
 #include <fstream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 #include "ErrCodes.h"
 #include "Logger.h"
@@ -30,6 +32,8 @@ private:
 
     RequestReceiver();
 
+    void forwardBatch(int32_t clientSocket, MsgForwardInfo* msgForwardInfo);
+
 public:
     static ThreadPool* mRequestsThreadPool;
 
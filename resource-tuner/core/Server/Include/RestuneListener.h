@@ -13,12 +13,17 @@
 #include <fcntl.h>
 #include <string.h>
 #include <sys/stat.h>
+#include <atomic>
+#include <vector>
+#include <unordered_map>
 
 #include "MemoryPool.h"
+#include "AuxRoutines.h"
 #include "Request.h"
 #include "Signal.h"
 #include "SafeOps.h"
 #include "ServerEndpoint.h"
+#include "SharedRing.h"
 #include "UrmSettings.h"
 #include "ErrCodes.h"
 #include "Logger.h"
@@ -27,21 +32,191 @@
 
 static const uint32_t maxEvents = 128;
 
+// Max number of persistent client sessions, which can be open at any moment (across
+// all the listener threads). Sessions requested beyond this limit are declined, and
+// the client falls back to a connection per request.
+static const uint32_t maxSessions = 64;
+
+// Max number of connections accepted from the listen backlog per epoll wakeup, so that
+// a burst of connections does not starve the sessions served by the same thread, and
+// the remaining backlog can be picked up by the other listener threads.
+static const uint32_t maxAcceptsPerWakeup = 32;
+
+// Upper bound on the number of listener threads.
+static const uint32_t maxListenerThreads = 16;
+
+// Max number of Requests read from a single session per epoll wakeup, so that
+// one busy session cannot starve the others.
+static const uint32_t maxFramesPerWakeup = 32;
+
+// Time (in milliseconds) within which a newly accepted connection must deliver its first
+// message, and a closing connection must accept its pending response, else it is dropped.
+static const uint32_t connectionIdleTimeout = 5000;
+
+// Upper bound on the bytes of responses queued for a client which is not reading them.
+static const uint32_t maxPendingResponseSize = 64 * 1024;
+
+// Size of the per connection staging buffer, into which the messages are received before being
+// parsed. Frames which do not fit are received directly into their message buffer.
+static const uint32_t frameStageSize = 4096;
+
+/**
+ * @enum ConnectionState
+ * @brief Lifecycle of an accepted client connection.
+ */
+enum ConnectionState {
+    CONN_AWAITING_FIRST_MSG, //!< Accepted, the first message is yet to be received in full.
+    CONN_SESSION, //!< Persistent session, Requests are served until the client disconnects.
+    CONN_CLOSING, //!< No more Requests are read, the connection is closed once the responses are sent.
+};
+
+/**
+ * @brief ClientConnection
+ * @details Per connection state, all the client sockets are non-blocking. Bytes are accumulated
+ *          in the stage until a complete message is available, and responses which could not be
+ *          sent right away are queued until the socket becomes writable again.
+ */
+typedef struct {
+    int32_t mFd;
+    int32_t mState;
+    uint32_t mEvents; //!< Events the fd is currently registered for, 0 if not in the epoll set.
+    int64_t mDeadline; //!< Only applicable in the CONN_AWAITING_FIRST_MSG and CONN_CLOSING states.
+    int8_t mBroken; //!< Set if a response could not be sent, the connection is then dropped.
+
+    char mStage[frameStageSize];
+    size_t mStart;
+    size_t mEnd;
+
+    MsgForwardInfo* mPartial; //!< Frame too large for the stage, being received in place.
+    size_t mPartialFilled;
+
+    std::vector<char> mPending; //!< Responses yet to be sent.
+    size_t mPendingStart;
+
+    int32_t mFds[SHARED_RING_FD_COUNT]; //!< fds passed along with the first message.
+    int32_t mFdCount;
+
+    // Only used by the io_uring backend.
+    uint32_t mGen; //!< Tells completions for this connection apart from those of an earlier one with the same fd.
+    int8_t mSendInFlight;
+    int8_t mFlushQueued;
+} ClientConnection;
+
+/**
+ * @enum ListenerBackend
+ * @brief Mechanism used by the listener threads to wait on the client sockets.
+ */
+enum ListenerBackend {
+    LISTENER_BACKEND_EPOLL, //!< Readiness based, the sockets are read and written via syscalls.
+    LISTENER_BACKEND_IO_URING, //!< Completion based, see UringSocketServer.
+};
+
+/**
+ * @brief SocketServer
+ * @details By default, a client connection carries exactly one Request, and is closed
+ *          once the Request has been processed. Clients can opt-in to a persistent session
+ *          by sending a REQ_SESSION_OPEN message as the first Request on the connection.
+ *          The connection is then added to the epoll set, and multiple (pipelined) Requests
+ *          are served on it, in order, until the client disconnects.\n
+ *          Client sockets are non-blocking, and are never waited on: partially received messages
+ *          and partially sent responses are buffered per connection, and resumed when epoll reports
+ *          the socket as readable or writable. Hence a slow or misbehaving client cannot block the
+ *          listener thread. Connections which stall before delivering their first message are
+ *          dropped after connectionIdleTimeout.\n
+ *          Complete messages are passed to the MessageReceivedCallback in place, i.e. pointing into
+ *          the connection's stage, hence the callback must not retain them.\n
+ *          Each message is either a legacy fixed size message (REQ_BUFFER_SIZE bytes), or a frame
+ *          carrying a version byte and the payload length, followed by the payload. Both formats
+ *          are accepted on every connection, the first byte of the message tells them apart.\n
+ *          Alternatively, the first Request can be REQ_RING_OPEN, carrying the fds of a SharedRing.
+ *          In addition to the persistent session, the Requests submitted to the ring's SQ are then
+ *          served, whenever its doorbell is rung. Results are posted to the ring's CQ. The ring is
+ *          torn down along with the session, i.e. when the client disconnects.\n
+ *          Multiple SocketServer instances (one per listener thread) can share a single
+ *          listening socket. Each instance registers the socket with its own epoll set using
+ *          EPOLLEXCLUSIVE, so that a new connection wakes up only one of the idle threads.
+ *          The sessions and rings accepted by a thread are then served by that thread alone.
+ */
 class SocketServer : public ServerEndpoint {
 private:
+    int8_t mOwnsSockFd;
+    int32_t mEpollFd;
+
+    void serveClient(ClientConnection* conn, uint32_t events);
+    int8_t flushPending(ClientConnection* conn);
+    ssize_t receive(ClientConnection* conn, char* buf, size_t count);
+    int32_t acceptClients();
+
+protected:
     int32_t sockFd;
+    int64_t mNextSweep;
+    std::unordered_map<int32_t, ClientConnection*> mConnections;
     ServerOnlineCheckCallback mServerOnlineCheckCb;
     MessageReceivedCallback mMessageRecvCb;
 
+    // The SocketServer running on the calling listener thread, responses are sent via it.
+    static thread_local SocketServer* mThreadServer;
+
+    // Rings indexed by their SQ doorbell fd, which also identifies the ring as the "client"
+    // of the Requests read from it. Responses are sent from the listener thread which received
+    // the Request, hence each listener thread only needs to track the rings it serves.
+    static thread_local std::unordered_map<int32_t, std::pair<int32_t, SharedRing*>> mRings;
+
+    // Number of persistent sessions open, across all the listener threads.
+    static std::atomic<uint32_t> mSessionCount;
+
+    int8_t openSession(ClientConnection* conn);
+    int8_t openRing(ClientConnection* conn);
+    void closeRing(int32_t sqEventFd);
+    void serveRing(int32_t sqEventFd);
+    void readClient(ClientConnection* conn);
+    int8_t dispatchNext(ClientConnection* conn);
+    char* nextReadSpan(ClientConnection* conn, size_t& count);
+    void handleFirstMsg(ClientConnection* conn, MsgForwardInfo* info);
+    void sweepIdleClients();
+    int8_t extractFrame(ClientConnection* conn, MsgForwardInfo* view);
+    ClientConnection* trackClient(int32_t clientSocket);
+    void releaseClient(ClientConnection* conn);
+
+    // Event mechanism specific, overridden by the io_uring backend.
+    virtual void closeClient(ClientConnection* conn);
+    virtual void closeAfterFlush(ClientConnection* conn);
+    virtual int8_t setEvents(ClientConnection* conn, uint32_t events);
+    virtual int32_t queueResponse(ClientConnection* conn, const void* buf, size_t bufSize);
+    virtual int8_t watchRing(int32_t sqEventFd);
+    virtual void unwatchRing(int32_t sqEventFd);
+
 public:
+    /**
+     * @param listenFd A listening socket shared with other SocketServer instances, as returned
+     *                 by createListenSocket. The socket is not closed by this instance.
+     *                 If -1 (default), the instance creates and owns the listening socket.
+     */
     SocketServer(
         ServerOnlineCheckCallback mServerOnlineCheckCb,
-        MessageReceivedCallback mMessageRecvCb);
+        MessageReceivedCallback mMessageRecvCb,
+        int32_t listenFd = -1);
 
     virtual ~SocketServer();
 
     virtual int32_t ListenForClientRequests();
     virtual int32_t closeConnection();
+
+    /**
+     * @brief Create the non-blocking listening socket, bound to RESTUNE_SOCKET_PATH.
+     * @return int32_t: The socket fd if successful, -1 otherwise.
+     */
+    static int32_t createListenSocket();
+
+    /**
+     * @brief Send the response for a Request, to the client it was received from.
+     * @details Requests received over a SharedRing are answered via the ring's CQ, hence
+     *          the response must be an int64_t (i.e. a Request handle). The others are
+     *          answered over the client socket.
+     * @param clientFd The fd passed to the MessageReceivedCallback along with the Request.
+     * @return int32_t: RC_SUCCESS if the response was sent, an error code otherwise.
+     */
+    static int32_t sendResponse(int32_t clientFd, const void* buf, size_t bufSize);
 };
 
 #endif
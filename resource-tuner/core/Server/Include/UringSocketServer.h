@@ -0,0 +1,124 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#ifndef RESTUNE_URING_SOCKET_SERVER_H
+#define RESTUNE_URING_SOCKET_SERVER_H
+
+#include <vector>
+#include <utility>
+
+#include "RestuneListener.h"
+
+struct io_uring_sqe;
+struct io_uring_cqe;
+struct io_uring_buf;
+
+// Number of Submission Queue entries of the per thread io_uring instance.
+static const uint32_t uringQueueDepth = 256;
+
+// Number (power of 2) and size of the buffers provided to the kernel for receiving from the
+// persistent sessions. A buffer is only held for as long as its completion is being processed.
+static const uint32_t uringRecvBufferCount = 64;
+static const uint32_t uringRecvBufferSize = 4096;
+
+/**
+ * @brief UringSocketServer
+ * @details io_uring based listener backend, serving the same protocol and connection lifecycle
+ *          as the SocketServer, with fewer syscalls per Request:\n
+ *          - The listening socket is served by a multishot accept, i.e. a single submission
+ *            yields a completion per accepted connection.\n
+ *          - The first message is read right after the accept (as in the epoll backend), since it
+ *            may carry the fds of a SharedRing. If it is incomplete, a poll is armed for the rest.\n
+ *          - Persistent sessions are served by a multishot recv, the bytes are received into
+ *            buffers provided to the kernel up front (provided buffer ring), and are then parsed
+ *            exactly as in the epoll backend.\n
+ *          - Responses are queued while the completions are processed, and sent with a single
+ *            submission per connection afterwards. For a connection per Request, the send is
+ *            linked to the close of the connection.\n
+ *          All the submissions of a wakeup are flushed with the io_uring_enter call which waits
+ *          for the next completions.\n
+ *          If io_uring (or one of the features above) is not available, setup fails, and the
+ *          caller falls back to the epoll based SocketServer.
+ */
+class UringSocketServer : public SocketServer {
+private:
+    int32_t mRingFd;
+    uint32_t mPendingSubmits;
+    uint32_t mNextGen;
+    int8_t mAcceptMultishot;
+    int8_t mRecvMultishot;
+    int8_t mFailed;
+
+    // Submission and Completion Queues, shared with the kernel.
+    void* mRingMem;
+    size_t mRingMemSize;
+    io_uring_sqe* mSqes;
+    size_t mSqesSize;
+    uint32_t* mSqHead;
+    uint32_t* mSqTail;
+    uint32_t mSqMask;
+    uint32_t mSqEntries;
+    uint32_t* mSqArray;
+    uint32_t* mCqHead;
+    uint32_t* mCqTail;
+    uint32_t mCqMask;
+    io_uring_cqe* mCqes;
+
+    // Provided buffer ring, used by the session recvs. Its tail is overlaid on the first entry.
+    io_uring_buf* mBufRing;
+    size_t mBufRingSize;
+    char* mBufBase;
+    uint16_t mBufTail;
+
+    // Connections (fd, generation) with responses queued during the current wakeup.
+    std::vector<std::pair<int32_t, uint32_t>> mFlushList;
+
+    io_uring_sqe* getSqe();
+    int8_t reserveSqes(uint32_t count);
+    int32_t enter(uint32_t minComplete, int8_t wait);
+    void recycleBuffer(uint16_t bufferId);
+
+    void armAccept();
+    void armClient(ClientConnection* conn);
+    void submitSend(ClientConnection* conn);
+    void submitClose(int32_t fd);
+
+    ClientConnection* findClient(int32_t fd, uint32_t gen);
+    void handleCompletion(uint64_t userData, int32_t res, uint32_t flags);
+    void handleAccept(int32_t res, uint32_t flags);
+    void handleRecv(int32_t fd, uint32_t gen, int32_t res, uint32_t flags);
+    void handleSend(void* op, int32_t res);
+    void feedClient(ClientConnection* conn, const char* data, size_t size);
+    void flushResponses();
+    void teardown();
+
+protected:
+    virtual void closeClient(ClientConnection* conn);
+    virtual void closeAfterFlush(ClientConnection* conn);
+    virtual int8_t setEvents(ClientConnection* conn, uint32_t events);
+    virtual int32_t queueResponse(ClientConnection* conn, const void* buf, size_t bufSize);
+    virtual int8_t watchRing(int32_t sqEventFd);
+    virtual void unwatchRing(int32_t sqEventFd);
+
+public:
+    UringSocketServer(
+        ServerOnlineCheckCallback mServerOnlineCheckCb,
+        MessageReceivedCallback mMessageRecvCb,
+        int32_t listenFd = -1);
+
+    virtual ~UringSocketServer();
+
+    /**
+     * @brief Create the io_uring instance and register the provided buffers.
+     * @details Must be called on the listener thread which serves the connections.
+     * @return int8_t:\n
+     *            - 1: if io_uring is available, with all the features used by the backend.\n
+     *            - 0: otherwise, the epoll based SocketServer should be used instead.
+     */
+    int8_t setup();
+
+    virtual int32_t ListenForClientRequests();
+    virtual int32_t closeConnection();
+};
+
+#endif
@@ -3,11 +3,165 @@
 
 #include "RequestReceiver.h"
 
+#ifdef URM_IO_URING_BACKEND
+#include "UringSocketServer.h"
+#endif
+
 std::shared_ptr<RequestReceiver> RequestReceiver::mRequestReceiverInstance = nullptr;
 ThreadPool* RequestReceiver::mRequestsThreadPool = nullptr;
 
 RequestReceiver::RequestReceiver() {}
 
+// Determine the ThreadPool Lane for the incoming message, based on the Priority
+// specified by the client (i.e. before the permission based mapping is applied).
+// High priority Signals (for example: app launch boosts) are latency critical, hence
+// they are given the Critical Lane, so that they are not delayed behind a burst
+// of Resource Provisioning Requests.
+static int32_t getTaskLane(MsgForwardInfo* info) {
+    char* buffer = info->mBuffer;
+    char* bufferEnd = info->mBuffer + info->mBufferSize;
+    int32_t properties = 0;
+
+    switch(info->mRequestType) {
+        case REQ_RESOURCE_TUNING: {
+            // Layout: module, type, handle, duration, numResources, properties
+            char* ptr = buffer + 2 * sizeof(int8_t) + 2 * sizeof(int64_t) + sizeof(int32_t);
+
+            // Frames are variable length, a truncated Request is rejected by the decoder.
+            if(ptr + sizeof(int32_t) > bufferEnd) {
+                return TASK_LANE_NORMAL;
+            }
+            std::memcpy(&properties, ptr, sizeof(int32_t));
+            break;
+        }
+
+        case REQ_SIGNAL_TUNING:
+        case REQ_SIGNAL_RELAY: {
+            // Layout: module, type, code, type, handle, duration, appName, scenario, numArgs, properties
+            char* ptr = buffer + 2 * sizeof(int8_t) + 2 * sizeof(int32_t) + 2 * sizeof(int64_t);
+            for(int32_t strCount = 0; strCount < 2; strCount++) {
+                while(ptr < bufferEnd && *ptr != '\0') ptr++;
+                ptr++;
+            }
+            ptr += sizeof(int32_t);
+
+            if(ptr + sizeof(int32_t) > bufferEnd) {
+                return TASK_LANE_HIGH;
+            }
+            std::memcpy(&properties, ptr, sizeof(int32_t));
+
+            int8_t priority = (int8_t)(properties & ((1 << 8) - 1));
+            return (priority == RequestPriority::REQ_PRIORITY_HIGH) ? TASK_LANE_CRITICAL : TASK_LANE_HIGH;
+        }
+
+        default:
+            // Retune and Untune Requests, free up or shorten existing allocations
+            return TASK_LANE_HIGH;
+    }
+
+    int8_t priority = (int8_t)(properties & ((1 << 8) - 1));
+    return (priority == RequestPriority::REQ_PRIORITY_HIGH) ? TASK_LANE_HIGH : TASK_LANE_NORMAL;
+}
+
+// Validate the layout of a REQ_RESOURCE_TUNING_BATCH message:
+// module, type, numRequests, {entrySize, Tune Request} x numRequests
+// numRequests is populated as long as it is within the allowed range, even if an entry
+// turns out to be malformed, so that the client can be informed of the failure.
+// The Lane for the batch is the most critical Lane among its Requests.
+static int8_t parseBatch(MsgForwardInfo* info, int32_t& numRequests, int32_t& taskLane) {
+    // Module, type, handle, duration, numResources, properties, pid, tid
+    const size_t minTuneRequestSize = 2 * sizeof(int8_t) + 2 * sizeof(int64_t) + 4 * sizeof(int32_t);
+
+    char* ptr = info->mBuffer + 2 * sizeof(int8_t);
+    char* bufferEnd = info->mBuffer + info->mBufferSize;
+
+    numRequests = 0;
+    if(ptr + sizeof(int32_t) > bufferEnd) {
+        return false;
+    }
+
+    std::memcpy(&numRequests, ptr, sizeof(int32_t));
+    ptr += sizeof(int32_t);
+    if(numRequests <= 0 || numRequests > MAX_TUNE_BATCH_SIZE) {
+        numRequests = 0;
+        return false;
+    }
+
+    taskLane = TASK_LANE_NORMAL;
+    for(int32_t i = 0; i < numRequests; i++) {
+        uint32_t entrySize = 0;
+        if(ptr + sizeof(uint32_t) > bufferEnd) {
+            return false;
+        }
+
+        std::memcpy(&entrySize, ptr, sizeof(uint32_t));
+        ptr += sizeof(uint32_t);
+        if(entrySize < minTuneRequestSize || entrySize > (size_t)(bufferEnd - ptr) ||
+           ptr[sizeof(int8_t)] != REQ_RESOURCE_TUNING) {
+            return false;
+        }
+
+        MsgForwardInfo entry;
+        entry.mRequestType = REQ_RESOURCE_TUNING;
+        entry.mBuffer = ptr;
+        entry.mBufferSize = entrySize;
+        taskLane = std::min(taskLane, getTaskLane(&entry));
+
+        ptr += entrySize;
+    }
+
+    return true;
+}
+
+// All the Requests in the batch are admitted together: a single range of handles is
+// reserved, and the batch is processed by a single ThreadPool task. The handles are
+// written back to the client in one response, -1 for each Request if the batch is dropped.
+void RequestReceiver::forwardBatch(int32_t clientSocket, MsgForwardInfo* info) {
+    int64_t handles[MAX_TUNE_BATCH_SIZE];
+    int32_t numRequests = 0;
+    int32_t taskLane = TASK_LANE_NORMAL;
+    int8_t enqueued = false;
+    MsgForwardInfo* batch = nullptr;
+
+    if(!parseBatch(info, numRequests, taskLane)) {
+        LOGE("RESTUNE_REQUEST_RECEIVER", "Malformed Batch Request, Dropping the Batch");
+
+    } else if((info->mHandle = AuxRoutines::generateUniqueHandle(numRequests)) < 0) {
+        LOGE("RESTUNE_REQUEST_RECEIVER", "Failed to Generate Request handles");
+
+    } else if(this->mRequestsThreadPool == nullptr) {
+        LOGE("URM_SERVER_ENDPOINT", "Thread pool not initialized, Dropping the Batch");
+
+    } else if((batch = AuxRoutines::cloneMsgForwardInfo(info)) == nullptr) {
+        TYPELOGV(REQUEST_MEMORY_ALLOCATION_FAILURE, "Batch Request");
+
+    } else {
+        for(int32_t i = 0; i < numRequests; i++) {
+            handles[i] = info->mHandle + i;
+        }
+
+        // The batch is decoded by the ThreadPool task, hence it needs its own copy of the message.
+        enqueued = this->mRequestsThreadPool->enqueueTask(submitResProvisionBatchMsg, batch, taskLane);
+        if(!enqueued) {
+            LOGE("URM_SERVER_ENDPOINT", "Failed to enqueue the Batch to the Thread Pool");
+            AuxRoutines::freeMsgForwardInfo(batch);
+        }
+    }
+
+    if(!enqueued) {
+        for(int32_t i = 0; i < numRequests; i++) {
+            handles[i] = -1;
+        }
+    }
+
+    if(numRequests > 0) {
+        SocketServer::sendResponse(clientSocket, (const void*)handles, numRequests * sizeof(int64_t));
+    }
+}
+
+// Resource Provisioning Requests are decoded in place, straight out of the listener's receive
+// buffer into a Memory Pool allocated Request, which is then handed off to the ThreadPool. Other
+// messages are copied, and decoded by the ThreadPool task. info is only borrowed by this call.
 void RequestReceiver::forwardMessage(int32_t clientSocket, MsgForwardInfo* info) {
     int8_t moduleID = *(int8_t*) info->mBuffer;
     int8_t requestType = *(int8_t*) ((unsigned char*) info->mBuffer + sizeof(int8_t));
@@ -23,50 +177,88 @@ void RequestReceiver::forwardMessage(int32_t clientSocket, MsgForwardInfo* info)
             writeLen = result.length();
         }
 
-        if(write(clientSocket, result.c_str(), writeLen) == -1) {
-            TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+        // Never write more than the client can read, any residue would otherwise
+        // be mistaken for the response to the next Request on a persistent session.
+        // A frame too short to carry the client buffer size only gets the "na" response.
+        uint64_t clientBufSize = 0;
+        char* ptr = info->mBuffer + 2 * sizeof(int8_t);
+        if(ptr + sizeof(uint64_t) <= info->mBuffer + info->mBufferSize) {
+            std::memcpy(&clientBufSize, ptr, sizeof(uint64_t));
+        }
+        if(clientBufSize > 0 && writeLen > clientBufSize) {
+            writeLen = clientBufSize;
         }
+
+        SocketServer::sendResponse(clientSocket, result.c_str(), writeLen);
         return;
     }
 
+    if(info->mRequestType == REQ_RESOURCE_TUNING_BATCH) {
+        this->forwardBatch(clientSocket, info);
+        return;
+    }
+
+    // Tune Requests expect the handle as the response. On a persistent session or a Shared Ring
+    // the client waits for it, hence -1 is sent back if the Request is dropped.
+    int8_t expectsResponse = (requestType == REQ_RESOURCE_TUNING || requestType == REQ_SIGNAL_TUNING);
+    int8_t enqueued = false;
+    int64_t handle = -1;
+
     info->mHandle = AuxRoutines::generateUniqueHandle();
     if(info->mHandle < 0) {
         // Handle Generation Failure
         LOGE("RESTUNE_REQUEST_RECEIVER", "Failed to Generate Request handle");
-        return;
-    }
 
-    if(this->mRequestsThreadPool == nullptr) {
+    } else if(this->mRequestsThreadPool == nullptr) {
         LOGE("URM_SERVER_ENDPOINT", "Thread pool not initialized, Dropping the Request");
-        return;
-    }
 
-    // Enqueue the Request to the Thread Pool for async processing.
-    switch(info->mRequestType) {
-        case REQ_RESOURCE_TUNING:
-        case REQ_RESOURCE_RETUNING:
-        case REQ_RESOURCE_UNTUNING: {
-            if(!this->mRequestsThreadPool->enqueueTask(submitResProvisionReqMsg, info)) {
-                LOGE("URM_SERVER_ENDPOINT", "Failed to enqueue the Request to the Thread Pool");
+    } else {
+        // Enqueue the Request to the Thread Pool for async processing.
+        int32_t taskLane = getTaskLane(info);
+        switch(info->mRequestType) {
+            case REQ_RESOURCE_TUNING:
+            case REQ_RESOURCE_RETUNING:
+            case REQ_RESOURCE_UNTUNING: {
+                Request* request = decodeResProvisionReqMsg(info);
+                if(request == nullptr) {
+                    LOGE("RESTUNE_REQUEST_RECEIVER", "Malformed Request, Dropping the Request");
+                    break;
+                }
+
+                enqueued = this->mRequestsThreadPool->enqueueTask(submitDecodedResProvisionReq,
+                                                                  request, taskLane);
+                if(!enqueued) {
+                    Request::cleanUpRequest(request);
+                }
+                break;
             }
-            break;
-        }
 
-        case REQ_SIGNAL_TUNING:
-        case REQ_SIGNAL_UNTUNING:
-        case REQ_SIGNAL_RELAY: {
-            if(!this->mRequestsThreadPool->enqueueTask(submitSignalRequest, info)) {
-                LOGE("URM_SERVER_ENDPOINT", "Failed to enqueue the Request to the Thread Pool");
+            case REQ_SIGNAL_TUNING:
+            case REQ_SIGNAL_UNTUNING:
+            case REQ_SIGNAL_RELAY: {
+                MsgForwardInfo* signalMsg = AuxRoutines::cloneMsgForwardInfo(info);
+                if(signalMsg == nullptr) {
+                    break;
+                }
+
+                enqueued = this->mRequestsThreadPool->enqueueTask(submitSignalRequest, signalMsg, taskLane);
+                if(!enqueued) {
+                    AuxRoutines::freeMsgForwardInfo(signalMsg);
+                }
+                break;
             }
-            break;
+        }
+
+        if(!enqueued) {
+            LOGE("URM_SERVER_ENDPOINT", "Failed to enqueue the Request to the Thread Pool");
+        } else {
+            handle = info->mHandle;
         }
     }
 
     // Only in Case of Tune Requests, Write back the handle to the client.
-    if(requestType == REQ_RESOURCE_TUNING || requestType == REQ_SIGNAL_TUNING) {
-        if(write(clientSocket, (const void*)&info->mHandle, sizeof(int64_t)) == -1) {
-            TYPELOGV(ERRNO_LOG, "write", strerror(errno));
-        }
+    if(expectsResponse) {
+        SocketServer::sendResponse(clientSocket, (const void*)&handle, sizeof(int64_t));
     }
 }
 
@@ -79,11 +271,33 @@ void onMsgRecvCallback(int32_t clientSocket, MsgForwardInfo* msgForwardInfo) {
     requestReceiver->forwardMessage(clientSocket, msgForwardInfo);
 }
 
-void listenerThreadStartRoutine() {
+// The io_uring backend is used if configured and supported, else the epoll one.
+static SocketServer* createSocketServer(int32_t listenFd) {
+#ifdef URM_IO_URING_BACKEND
+    if(UrmSettings::metaConfigs.mListenerBackend == LISTENER_BACKEND_IO_URING) {
+        UringSocketServer* uringServer =
+            new UringSocketServer(checkServerOnlineStatus, onMsgRecvCallback, listenFd);
+        if(uringServer->setup()) {
+            return uringServer;
+        }
+
+        delete uringServer;
+        LOGW("URM_SERVER_ENDPOINT", "io_uring unavailable, falling back to the epoll listener");
+    }
+#else
+    if(UrmSettings::metaConfigs.mListenerBackend == LISTENER_BACKEND_IO_URING) {
+        LOGW("URM_SERVER_ENDPOINT", "Built without io_uring support, using the epoll listener");
+    }
+#endif
+
+    return new SocketServer(checkServerOnlineStatus, onMsgRecvCallback, listenFd);
+}
+
+static void serveListenSocket(int32_t listenFd) {
     SocketServer* connection = nullptr;
 
     try {
-        connection = new SocketServer(checkServerOnlineStatus, onMsgRecvCallback);
+        connection = createSocketServer(listenFd);
     } catch(const std::exception& e) {
         LOGE("URM_SERVER_ENDPOINT",
              "Failed to start the Resource Tuner Listener, error: " + std::string(e.what()));
@@ -98,3 +312,37 @@ void listenerThreadStartRoutine() {
         delete(connection);
     }
 }
+
+// The listening socket is shared by all the listener threads, each of which serves the
+// connections it accepts via its own epoll set. The calling thread acts as the first listener.
+void listenerThreadStartRoutine() {
+    int32_t listenFd = SocketServer::createListenSocket();
+    if(listenFd < 0) {
+        LOGE("URM_SERVER_ENDPOINT", "Failed to start the Resource Tuner Listener");
+        return;
+    }
+
+    // Make sure the singleton is created before the Requests are forwarded concurrently.
+    RequestReceiver::getInstance();
+
+    std::vector<std::thread> listenerThreads;
+    for(uint32_t i = 1; i < UrmSettings::metaConfigs.mListenerThreadCount; i++) {
+        try {
+            listenerThreads.emplace_back([listenFd]() {
+                AuxRoutines::applyThreadConfig(THREAD_CLASS_LISTENER);
+                serveListenSocket(listenFd);
+            });
+        } catch(const std::system_error& e) {
+            TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "resource-tuner-listener", e.what());
+            break;
+        }
+    }
+
+    serveListenSocket(listenFd);
+
+    for(std::thread& listenerThread: listenerThreads) {
+        listenerThread.join();
+    }
+
+    close(listenFd);
+}
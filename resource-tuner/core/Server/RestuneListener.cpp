@@ -7,29 +7,36 @@
 #define UNIX_PATH_MAX sizeof(((struct sockaddr_un *)0)->sun_path)
 #endif
 
+thread_local SocketServer* SocketServer::mThreadServer = nullptr;
+thread_local std::unordered_map<int32_t, std::pair<int32_t, SharedRing*>> SocketServer::mRings {};
+std::atomic<uint32_t> SocketServer::mSessionCount(0);
+
 SocketServer::SocketServer(
     ServerOnlineCheckCallback mServerOnlineCheckCb,
-    MessageReceivedCallback mMessageRecvCb) {
+    MessageReceivedCallback mMessageRecvCb,
+    int32_t listenFd) {
 
-    this->sockFd = -1;
+    this->sockFd = listenFd;
+    this->mOwnsSockFd = (listenFd == -1);
+    this->mEpollFd = -1;
+    this->mNextSweep = 0;
     this->mServerOnlineCheckCb = mServerOnlineCheckCb;
     this->mMessageRecvCb = mMessageRecvCb;
 }
 
-// Called by server, this will put the server in listening mode
-int32_t SocketServer::ListenForClientRequests() {
-    if((this->sockFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
+int32_t SocketServer::createListenSocket() {
+    int32_t listenFd = -1;
+    if((listenFd = socket(AF_UNIX, SOCK_STREAM, 0)) < 0) {
         TYPELOGV(ERRNO_LOG, "socket", strerror(errno));
         LOGE("RESTUNE_SOCKET_SERVER", "Failed to initialize Server Socket");
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        return -1;
     }
 
     // Make the socket Non-Blocking
-    if (fcntl(this->sockFd, F_SETFL, O_NONBLOCK) < 0) {
-        close(this->sockFd);
-        this->sockFd = -1;
+    if (fcntl(listenFd, F_SETFL, O_NONBLOCK) < 0) {
+        close(listenFd);
         LOGE("RESTUNE_SOCKET_SERVER", std::string("Failed to make socket non-blocking: ") + strerror(errno));
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        return -1;
     }
 
     struct sockaddr_un addr;
@@ -38,128 +45,806 @@ int32_t SocketServer::ListenForClientRequests() {
     size_t written = snprintf(addr.sun_path, UNIX_PATH_MAX, RESTUNE_SOCKET_PATH);
     if(written >= UNIX_PATH_MAX) {
         LOGE("RESTUNE_SOCKET_SERVER", "Socket path too long");
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(listenFd);
+        return -1;
     }
 
     // Remove old socket file
     unlink(addr.sun_path);
 
-    if(bind(this->sockFd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
+    if(bind(listenFd, (const sockaddr*)&addr, sizeof(addr)) < 0) {
         TYPELOGV(ERRNO_LOG, "bind", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(listenFd);
+        return -1;
     }
 
     // Set permissions for server
     mode_t perm = 0666;
     if(chmod(RESTUNE_SOCKET_PATH, perm) < 0) {
         TYPELOGV(ERRNO_LOG, "permission", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(listenFd);
+        return -1;
     }
 
-    if(listen(this->sockFd, maxEvents) < 0) {
+    if(listen(listenFd, maxEvents) < 0) {
         TYPELOGV(ERRNO_LOG, "listen", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
-        return RC_SOCKET_CONN_NOT_INITIALIZED;
+        close(listenFd);
+        return -1;
     }
 
-    int32_t epollFd = epoll_create1(0);
-    if(epollFd < 0) {
+    return listenFd;
+}
+
+// Called by server, this will put the server in listening mode
+int32_t SocketServer::ListenForClientRequests() {
+    if(this->sockFd == -1) {
+        if((this->sockFd = createListenSocket()) < 0) {
+            this->sockFd = -1;
+            return RC_SOCKET_CONN_NOT_INITIALIZED;
+        }
+    }
+
+    this->mEpollFd = epoll_create1(0);
+    if(this->mEpollFd < 0) {
         TYPELOGV(ERRNO_LOG, "epoll_create1", strerror(errno));
-        close(this->sockFd);
-        this->sockFd = -1;
         return RC_SOCKET_CONN_NOT_INITIALIZED;
     }
 
+    // The listening socket may be shared by multiple listener threads, EPOLLEXCLUSIVE
+    // avoids waking all of them up for every new connection.
     epoll_event event{}, events[maxEvents];
-    event.events = EPOLLIN;
+    event.events = EPOLLIN | EPOLLEXCLUSIVE;
     event.data.fd = this->sockFd;
-    if(epoll_ctl(epollFd, EPOLL_CTL_ADD, this->sockFd, &event) < 0) {
+    if(epoll_ctl(this->mEpollFd, EPOLL_CTL_ADD, this->sockFd, &event) < 0) {
         TYPELOGV(ERRNO_LOG, "epoll_ctl", strerror(errno));
-        close(epollFd);
-        close(this->sockFd);
-        this->sockFd = -1;
+        close(this->mEpollFd);
+        this->mEpollFd = -1;
         return RC_SOCKET_CONN_NOT_INITIALIZED;
     }
 
+    mThreadServer = this;
+    this->mNextSweep = AuxRoutines::getCurrentTimeInMilliseconds() + connectionIdleTimeout;
+
     while(this->mServerOnlineCheckCb()) {
-        int32_t clientsFdCount = epoll_wait(epollFd, events, maxEvents, 1000);
+        int32_t clientsFdCount = epoll_wait(this->mEpollFd, events, maxEvents, 1000);
 
         for(int32_t i = 0; i < clientsFdCount; i++) {
-            if(events[i].data.fd == this->sockFd) {
-                // Process all the Requests in the backlog
-                while(true) {
-                    int32_t clientSocket = -1;
-                    if((clientSocket = accept(this->sockFd, nullptr, nullptr)) < 0) {
-                        if(errno != EAGAIN && errno != EWOULDBLOCK) {
-                            TYPELOGV(ERRNO_LOG, "accept", strerror(errno));
-                            LOGE("RESTUNE_SOCKET_SERVER", "Server Socket-Endpoint crashed");
-                            return RC_SOCKET_OP_FAILURE;
-                        } else {
-                            // No more clients to accept, Backlog is completely drained.
-                            break;
-                        }
-                    }
-
-                    if(clientSocket >= 0) {
-                        MsgForwardInfo* info = nullptr;
-                        char* reqBuf = nullptr;
-
-                        try {
-                            info = new (GetBlock<MsgForwardInfo>()) MsgForwardInfo;
-                            reqBuf = new (GetBlock<char[REQ_BUFFER_SIZE]>()) char[REQ_BUFFER_SIZE];
-
-                            info->mBuffer = reqBuf;
-                            info->mBufferSize = REQ_BUFFER_SIZE;
-
-                        } catch(const std::bad_alloc& e) {
-                            FreeBlock<MsgForwardInfo>(info);
-                            FreeBlock<char[REQ_BUFFER_SIZE]>(reqBuf);
-
-                            // Failed to allocate memory for Request, close client socket.
-                            close(clientSocket);
-                            continue;
-                        }
-
-                        int32_t bytesRead = 0;
-                        if((bytesRead = recv(clientSocket, info->mBuffer, info->mBufferSize, 0)) < 0) {
-                            if(errno != EAGAIN && errno != EWOULDBLOCK) {
-                                TYPELOGV(ERRNO_LOG, "recv", strerror(errno));
-                                LOGE("RESTUNE_SOCKET_SERVER", "Server Socket-Endpoint crashed");
-                                return RC_SOCKET_OP_FAILURE;
-                            }
-                        }
-
-                        if(bytesRead > 0) {
-                            this->mMessageRecvCb(clientSocket, info);
-                        }
-                        close(clientSocket);
-                    }
+            int32_t fd = events[i].data.fd;
+            if(fd == this->sockFd) {
+                if(RC_IS_NOTOK(this->acceptClients())) {
+                    return RC_SOCKET_OP_FAILURE;
+                }
+                continue;
+            }
+
+            if(mRings.find(fd) != mRings.end()) {
+                this->serveRing(fd);
+                continue;
+            }
+
+            // The connection may have been closed while serving an earlier event of this wakeup.
+            auto connIt = this->mConnections.find(fd);
+            if(connIt != this->mConnections.end()) {
+                this->serveClient(connIt->second, events[i].events);
+            }
+        }
+
+        this->sweepIdleClients();
+    }
+
+    return RC_SUCCESS;
+}
+
+// Register the connection for the given events, or update its registration.
+// An events value of 0 removes the connection from the epoll set.
+int8_t SocketServer::setEvents(ClientConnection* conn, uint32_t events) {
+    if(conn->mEvents == events) {
+        return true;
+    }
+
+    epoll_event event{};
+    event.events = events;
+    event.data.fd = conn->mFd;
+
+    int32_t op = EPOLL_CTL_MOD;
+    if(conn->mEvents == 0) {
+        op = EPOLL_CTL_ADD;
+    } else if(events == 0) {
+        op = EPOLL_CTL_DEL;
+    }
+
+    if(epoll_ctl(this->mEpollFd, op, conn->mFd, &event) < 0) {
+        TYPELOGV(ERRNO_LOG, "epoll_ctl", strerror(errno));
+        return false;
+    }
+
+    conn->mEvents = events;
+    return true;
+}
+
+// Receive upto count bytes without blocking. The fds passed by the client are only
+// accepted along with the first message, i.e. before the connection is classified.
+ssize_t SocketServer::receive(ClientConnection* conn, char* buf, size_t count) {
+    if(conn->mState != CONN_AWAITING_FIRST_MSG) {
+        return recv(conn->mFd, buf, count, MSG_DONTWAIT);
+    }
+
+    struct iovec iov;
+    iov.iov_base = buf;
+    iov.iov_len = count;
+
+    char control[CMSG_SPACE(SHARED_RING_FD_COUNT * sizeof(int32_t))];
+    struct msghdr msg;
+    memset(&msg, 0, sizeof(msg));
+    msg.msg_iov = &iov;
+    msg.msg_iovlen = 1;
+    msg.msg_control = control;
+    msg.msg_controllen = sizeof(control);
+
+    ssize_t bytesRead = recvmsg(conn->mFd, &msg, MSG_DONTWAIT | MSG_CMSG_CLOEXEC);
+    if(bytesRead < 0) {
+        return bytesRead;
+    }
+
+    for(struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg); cmsg != nullptr; cmsg = CMSG_NXTHDR(&msg, cmsg)) {
+        if(cmsg->cmsg_level == SOL_SOCKET && cmsg->cmsg_type == SCM_RIGHTS) {
+            int32_t fdCount = (cmsg->cmsg_len - CMSG_LEN(0)) / sizeof(int32_t);
+            for(int32_t i = 0; i < fdCount; i++) {
+                int32_t fd = -1;
+                memcpy(&fd, CMSG_DATA(cmsg) + i * sizeof(int32_t), sizeof(int32_t));
+                if(conn->mFdCount < SHARED_RING_FD_COUNT) {
+                    conn->mFds[conn->mFdCount++] = fd;
+                } else {
+                    close(fd);
+                }
+            }
+        }
+    }
+
+    return bytesRead;
+}
+
+// Parse the next message out of the stage. Returns 1 if a complete message was staged, with view
+// pointing to its payload in the stage (no copy is made), 0 if more bytes are needed, and -1 if
+// the client sent a malformed frame. The view is valid until the stage is read into again.
+// A frame which does not fit in the stage is moved to its own message buffer (mPartial), and the
+// remainder of its payload is received directly into it.
+int8_t SocketServer::extractFrame(ClientConnection* conn, MsgForwardInfo* view) {
+    size_t staged = conn->mEnd - conn->mStart;
+    size_t headerSize = 0;
+    uint64_t payloadSize = REQ_BUFFER_SIZE;
+
+    if(staged == 0) {
+        return 0;
+    }
+
+    char* frame = conn->mStage + conn->mStart;
+    if(IS_WIRE_VERSION_BYTE(frame[0])) {
+        if(staged < WIRE_FRAME_HEADER_SIZE) {
+            return 0;
+        }
+
+        uint8_t version = WIRE_VERSION_OF(frame[0]);
+        uint32_t length = 0;
+        memcpy(&length, frame + sizeof(uint8_t), sizeof(uint32_t));
+
+        if(version != WIRE_PROTOCOL_VERSION ||
+           length < 2 * sizeof(int8_t) || length > MAX_FRAME_PAYLOAD_SIZE) {
+            LOGE("RESTUNE_SOCKET_SERVER", "Malformed frame, version: " + std::to_string(version) +
+                                          ", length: " + std::to_string(length));
+            return -1;
+        }
+
+        headerSize = WIRE_FRAME_HEADER_SIZE;
+        payloadSize = length;
+    }
+
+    if(staged >= headerSize + payloadSize) {
+        view->mBuffer = frame + headerSize;
+        view->mBufferSize = payloadSize;
+
+        // The bytes stay in place, until the stage is compacted before the next read.
+        conn->mStart += headerSize + payloadSize;
+        return 1;
+    }
+
+    if(headerSize + payloadSize <= frameStageSize) {
+        return 0;
+    }
+
+    MsgForwardInfo* frameInfo = AuxRoutines::allocMsgForwardInfo(payloadSize);
+    if(frameInfo == nullptr) {
+        return -1;
+    }
+
+    size_t payloadStaged = staged - headerSize;
+    memcpy(frameInfo->mBuffer, frame + headerSize, payloadStaged);
+    conn->mStart = conn->mEnd = 0;
+
+    conn->mPartial = frameInfo;
+    conn->mPartialFilled = payloadStaged;
+    return 0;
+}
+
+// Dispatch the next complete message of the connection, if one has been received. Returns 1 if a
+// message was dispatched, 0 if more bytes are needed, and -1 if the connection was closed, or moved
+// to the CONN_CLOSING state, in which case it must not be read from any more.
+int8_t SocketServer::dispatchNext(ClientConnection* conn) {
+    MsgForwardInfo view;
+    MsgForwardInfo* info = &view;
+    MsgForwardInfo* owned = nullptr;
+
+    if(conn->mPartial != nullptr) {
+        if(conn->mPartialFilled < conn->mPartial->mBufferSize) {
+            return 0;
+        }
+
+        info = owned = conn->mPartial;
+        conn->mPartial = nullptr;
+        conn->mPartialFilled = 0;
+    } else {
+        int8_t status = this->extractFrame(conn, &view);
+        if(status < 0) {
+            // Malformed Request, the stream can no longer be parsed.
+            this->closeClient(conn);
+            return -1;
+        }
+
+        if(status == 0) {
+            return 0;
+        }
+    }
+
+    if(conn->mState == CONN_AWAITING_FIRST_MSG) {
+        this->handleFirstMsg(conn, info);
+    } else {
+        this->mMessageRecvCb(conn->mFd, info);
+    }
+
+    if(owned != nullptr) {
+        AuxRoutines::freeMsgForwardInfo(owned);
+    }
+
+    if(conn->mBroken) {
+        this->closeClient(conn);
+        return -1;
+    }
+
+    if(conn->mState == CONN_CLOSING) {
+        this->closeAfterFlush(conn);
+        return -1;
+    }
+
+    return 1;
+}
+
+// Where the next bytes of the connection are to be received: either the remainder of the
+// partially received frame, or the free space of the stage (compacted first).
+char* SocketServer::nextReadSpan(ClientConnection* conn, size_t& count) {
+    if(conn->mPartial != nullptr) {
+        count = conn->mPartial->mBufferSize - conn->mPartialFilled;
+        return conn->mPartial->mBuffer + conn->mPartialFilled;
+    }
+
+    if(conn->mStart > 0) {
+        memmove(conn->mStage, conn->mStage + conn->mStart, conn->mEnd - conn->mStart);
+        conn->mEnd -= conn->mStart;
+        conn->mStart = 0;
+    }
+
+    count = frameStageSize - conn->mEnd;
+    return conn->mStage + conn->mEnd;
+}
+
+// Read and dispatch the messages available on the connection, until the socket is drained
+// or the wakeup budget is exhausted. The budget is only enforced before reading from the socket
+// again, as the staged messages have already been consumed from it. Any bytes left unread keep
+// the socket readable, hence epoll reports it again on the next wait.
+void SocketServer::readClient(ClientConnection* conn) {
+    uint32_t frameCount = 0;
+
+    while(true) {
+        int8_t status = this->dispatchNext(conn);
+        if(status < 0) {
+            return;
+        }
+
+        if(status > 0) {
+            frameCount++;
+            continue;
+        }
+
+        if(frameCount >= maxFramesPerWakeup) {
+            return;
+        }
+
+        size_t count = 0;
+        char* buf = this->nextReadSpan(conn, count);
+
+        ssize_t bytesRead = this->receive(conn, buf, count);
+        if(bytesRead < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+            return;
+        }
+
+        if(bytesRead <= 0) {
+            // Client disconnected, possibly in the middle of a message.
+            this->closeClient(conn);
+            return;
+        }
+
+        if(conn->mPartial != nullptr) {
+            conn->mPartialFilled += bytesRead;
+        } else {
+            conn->mEnd += bytesRead;
+        }
+    }
+}
+
+// The first message determines the type of the connection: it either carries a single Request,
+// or upgrades the connection to a persistent session (optionally with a Shared Ring attached).
+// In the former case, the connection is moved to the CONN_CLOSING state.
+void SocketServer::handleFirstMsg(ClientConnection* conn, MsgForwardInfo* info) {
+    int8_t requestType = info->mBuffer[1];
+
+    if(requestType == REQ_RING_OPEN && conn->mFdCount == SHARED_RING_FD_COUNT) {
+        if(!this->openRing(conn)) {
+            conn->mState = CONN_CLOSING;
+        }
+        return;
+    }
+
+    // fds are only expected along with a Ring Open Request.
+    for(int32_t i = 0; i < conn->mFdCount; i++) {
+        close(conn->mFds[i]);
+    }
+    conn->mFdCount = 0;
+
+    if(requestType == REQ_SESSION_OPEN || requestType == REQ_RING_OPEN) {
+        if(requestType == REQ_SESSION_OPEN && this->openSession(conn)) {
+            return;
+        }
+    } else {
+        this->mMessageRecvCb(conn->mFd, info);
+    }
+
+    conn->mState = CONN_CLOSING;
+}
+
+// Stop reading from the connection, and close it as soon as the pending responses are sent.
+void SocketServer::closeAfterFlush(ClientConnection* conn) {
+    conn->mState = CONN_CLOSING;
+    if(conn->mPendingStart == conn->mPending.size() || conn->mBroken) {
+        this->closeClient(conn);
+        return;
+    }
+
+    conn->mDeadline = AuxRoutines::getCurrentTimeInMilliseconds() + connectionIdleTimeout;
+    if(!this->setEvents(conn, EPOLLOUT)) {
+        this->closeClient(conn);
+    }
+}
+
+// Upgrade the client connection to a persistent session. The client is notified
+// of the outcome via an int64_t status: 1 if the session was opened, 0 otherwise.
+int8_t SocketServer::openSession(ClientConnection* conn) {
+    int64_t status = 0;
+
+    if(mSessionCount.fetch_add(1) < maxSessions) {
+        if(this->setEvents(conn, EPOLLIN | EPOLLRDHUP)) {
+            conn->mState = CONN_SESSION;
+            status = 1;
+        }
+    } else {
+        LOGW("RESTUNE_SOCKET_SERVER", "Session limit reached, declining persistent session");
+    }
+
+    if(status == 0) {
+        mSessionCount--;
+    }
+
+    if(RC_IS_NOTOK(this->queueResponse(conn, &status, sizeof(status)))) {
+        if(status == 1) {
+            conn->mState = CONN_AWAITING_FIRST_MSG;
+            mSessionCount--;
+        }
+        return false;
+    }
+
+    return (status == 1);
+}
+
+// Attach the SharedRing created by the client, and upgrade the connection to a persistent
+// session. The ring lives as long as the session, so that a client exit is detected via
+// the socket, and the ring is torn down along with it.
+int8_t SocketServer::openRing(ClientConnection* conn) {
+    int32_t* fds = conn->mFds;
+    conn->mFdCount = 0;
+
+    SharedRing* ring = nullptr;
+    try {
+        ring = new SharedRing();
+    } catch(const std::bad_alloc& e) {
+        for(int32_t i = 0; i < SHARED_RING_FD_COUNT; i++) {
+            close(fds[i]);
+        }
+        return false;
+    }
+
+    int32_t sqEventFd = fds[1];
+    if(RC_IS_NOTOK(ring->attach(fds[0], fds[1], fds[2]))) {
+        delete ring;
+        int64_t status = 0;
+        this->queueResponse(conn, &status, sizeof(status));
+        return false;
+    }
+
+    if(!this->watchRing(sqEventFd)) {
+        delete ring;
+        int64_t status = 0;
+        this->queueResponse(conn, &status, sizeof(status));
+        return false;
+    }
+
+    mRings[sqEventFd] = {conn->mFd, ring};
+    if(!this->openSession(conn)) {
+        this->closeRing(sqEventFd);
+        return false;
+    }
+
+    // The Server starts out idle, announce it so that the first submission rings the doorbell.
+    if(!ring->prepareSqWait()) {
+        this->serveRing(sqEventFd);
+    }
+
+    return true;
+}
+
+void SocketServer::closeRing(int32_t sqEventFd) {
+    auto ringIt = mRings.find(sqEventFd);
+    if(ringIt == mRings.end()) return;
+
+    this->unwatchRing(sqEventFd);
+    delete ringIt->second.second;
+    mRings.erase(ringIt);
+}
+
+int8_t SocketServer::watchRing(int32_t sqEventFd) {
+    epoll_event event{};
+    event.events = EPOLLIN;
+    event.data.fd = sqEventFd;
+    if(epoll_ctl(this->mEpollFd, EPOLL_CTL_ADD, sqEventFd, &event) < 0) {
+        TYPELOGV(ERRNO_LOG, "epoll_ctl", strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+void SocketServer::unwatchRing(int32_t sqEventFd) {
+    if(epoll_ctl(this->mEpollFd, EPOLL_CTL_DEL, sqEventFd, nullptr) < 0) {
+        TYPELOGV(ERRNO_LOG, "epoll_ctl", strerror(errno));
+    }
+}
+
+void SocketServer::closeClient(ClientConnection* conn) {
+    // Closing the fd removes it from the epoll set as well.
+    close(conn->mFd);
+    this->releaseClient(conn);
+}
+
+// Drop the state of the connection, along with its session and ring if any. The client fd
+// itself is left to the caller.
+void SocketServer::releaseClient(ClientConnection* conn) {
+    if(conn->mState == CONN_SESSION) {
+        for(auto& ringEntry: mRings) {
+            if(ringEntry.second.first == conn->mFd) {
+                this->closeRing(ringEntry.first);
+                break;
+            }
+        }
+        mSessionCount--;
+    }
+
+    this->mConnections.erase(conn->mFd);
+
+    for(int32_t i = 0; i < conn->mFdCount; i++) {
+        close(conn->mFds[i]);
+    }
+
+    if(conn->mPartial != nullptr) {
+        AuxRoutines::freeMsgForwardInfo(conn->mPartial);
+    }
+
+    conn->~ClientConnection();
+    FreeBlock<ClientConnection>(conn);
+}
+
+// Send as much of the pending responses as the socket accepts, without blocking.
+// Returns false if the client can no longer be written to.
+int8_t SocketServer::flushPending(ClientConnection* conn) {
+    while(conn->mPendingStart < conn->mPending.size()) {
+        ssize_t bytesSent = send(conn->mFd,
+                                 conn->mPending.data() + conn->mPendingStart,
+                                 conn->mPending.size() - conn->mPendingStart,
+                                 MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(bytesSent < 0) {
+            if(errno == EAGAIN || errno == EWOULDBLOCK) {
+                return true;
+            }
+            TYPELOGV(ERRNO_LOG, "send", strerror(errno));
+            return false;
+        }
+        conn->mPendingStart += bytesSent;
+    }
+
+    conn->mPending.clear();
+    conn->mPendingStart = 0;
+    return true;
+}
+
+// Send the response right away if possible, the part which the socket does not
+// accept is queued, and sent once epoll reports the socket as writable.
+int32_t SocketServer::queueResponse(ClientConnection* conn, const void* buf, size_t bufSize) {
+    if(conn->mBroken) {
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    size_t bytesSent = 0;
+    if(conn->mPendingStart == conn->mPending.size()) {
+        ssize_t status = send(conn->mFd, buf, bufSize, MSG_DONTWAIT | MSG_NOSIGNAL);
+        if(status < 0 && errno != EAGAIN && errno != EWOULDBLOCK) {
+            TYPELOGV(ERRNO_LOG, "send", strerror(errno));
+            conn->mBroken = true;
+            return RC_SOCKET_FD_WRITE_FAILURE;
+        }
+
+        bytesSent = (status > 0) ? status : 0;
+        if(bytesSent == bufSize) {
+            return RC_SUCCESS;
+        }
+    }
+
+    if(conn->mPending.size() - conn->mPendingStart + bufSize - bytesSent > maxPendingResponseSize) {
+        LOGE("RESTUNE_SOCKET_SERVER", "Client not reading its responses, dropping the connection");
+        conn->mBroken = true;
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    const char* remainder = (const char*)buf + bytesSent;
+    conn->mPending.insert(conn->mPending.end(), remainder, remainder + (bufSize - bytesSent));
+
+    // Closing connections are already waiting for the socket to become writable.
+    if(conn->mState != CONN_CLOSING && !this->setEvents(conn, conn->mEvents | EPOLLOUT)) {
+        conn->mBroken = true;
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    return RC_SUCCESS;
+}
+
+void SocketServer::serveClient(ClientConnection* conn, uint32_t events) {
+    if((events & EPOLLERR) || conn->mBroken) {
+        this->closeClient(conn);
+        return;
+    }
+
+    if(events & EPOLLOUT) {
+        if(!this->flushPending(conn)) {
+            this->closeClient(conn);
+            return;
+        }
+
+        if(conn->mPendingStart == conn->mPending.size()) {
+            if(conn->mState == CONN_CLOSING) {
+                this->closeClient(conn);
+                return;
+            }
+
+            if(!this->setEvents(conn, conn->mEvents & ~EPOLLOUT)) {
+                this->closeClient(conn);
+                return;
+            }
+        }
+    }
+
+    if(conn->mState == CONN_CLOSING) {
+        if(events & EPOLLHUP) {
+            this->closeClient(conn);
+        }
+        return;
+    }
+
+    if(events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP)) {
+        this->readClient(conn);
+    }
+}
+
+// Drop the connections which have not made progress within connectionIdleTimeout,
+// i.e. those which never delivered their first message, or never accepted their response.
+// Persistent sessions are exempt, their clients may stay idle indefinitely.
+void SocketServer::sweepIdleClients() {
+    int64_t now = AuxRoutines::getCurrentTimeInMilliseconds();
+    if(now < this->mNextSweep) {
+        return;
+    }
+    this->mNextSweep = now + connectionIdleTimeout;
+
+    std::vector<ClientConnection*> expired;
+    for(auto& connEntry: this->mConnections) {
+        ClientConnection* conn = connEntry.second;
+        if(conn->mState != CONN_SESSION && conn->mDeadline <= now) {
+            expired.push_back(conn);
+        }
+    }
+
+    for(ClientConnection* conn: expired) {
+        LOGW("RESTUNE_SOCKET_SERVER", "Dropping idle client connection");
+        this->closeClient(conn);
+    }
+}
+
+// Serve the Requests submitted to the ring's SQ. The doorbell is reset first, and the ring is
+// only considered idle once prepareSqWait confirms that the SQ is empty. If the wakeup budget
+// is exhausted, the doorbell is rung again so that epoll reports the ring on the next wait.
+// The Requests are copied out of the shared region, so that the client cannot modify them
+// while they are being parsed.
+void SocketServer::serveRing(int32_t sqEventFd) {
+    SharedRing* ring = mRings[sqEventFd].second;
+    ring->drainSqDoorbell();
+
+    char buf[REQ_BUFFER_SIZE];
+    MsgForwardInfo view;
+    view.mBuffer = buf;
+    view.mBufferSize = REQ_BUFFER_SIZE;
+
+    for(uint32_t frameCount = 0; frameCount < maxFramesPerWakeup; frameCount++) {
+        int8_t status = ring->consume(buf);
+        if(status <= 0) {
+            if(status < 0) {
+                LOGE("RESTUNE_SOCKET_SERVER", "Shared Ring corrupted, closing the session");
+                // The session may be in the middle of being served, hence it is only marked
+                // broken here, and is closed once epoll reports the hangup.
+                auto connIt = this->mConnections.find(mRings[sqEventFd].first);
+                if(connIt != this->mConnections.end()) {
+                    connIt->second->mBroken = true;
+                    shutdown(connIt->first, SHUT_RDWR);
                 }
+                this->closeRing(sqEventFd);
+                return;
+            }
+
+            if(ring->prepareSqWait()) {
+                return;
             }
+            continue;
         }
+
+        this->mMessageRecvCb(sqEventFd, &view);
     }
 
+    uint64_t count = 1;
+    if(write(sqEventFd, &count, sizeof(count)) < 0) {
+        TYPELOGV(ERRNO_LOG, "write", strerror(errno));
+    }
+}
+
+// Accept the connections in the listen backlog, upto maxAcceptsPerWakeup of them. The first
+// message is usually sent right after connecting, hence it is read right away. The connection
+// is only added to the epoll set if it has to wait for more bytes, or for a persistent session.
+int32_t SocketServer::acceptClients() {
+    for(uint32_t acceptCount = 0; acceptCount < maxAcceptsPerWakeup; acceptCount++) {
+        int32_t clientSocket = accept4(this->sockFd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if(clientSocket < 0) {
+            if(errno != EAGAIN && errno != EWOULDBLOCK) {
+                TYPELOGV(ERRNO_LOG, "accept", strerror(errno));
+                LOGE("RESTUNE_SOCKET_SERVER", "Server Socket-Endpoint crashed");
+                return RC_SOCKET_OP_FAILURE;
+            }
+
+            // No more clients to accept, Backlog is completely drained.
+            return RC_SUCCESS;
+        }
+
+        ClientConnection* conn = this->trackClient(clientSocket);
+        if(conn == nullptr) {
+            continue;
+        }
+
+        this->readClient(conn);
+
+        // Still waiting for the first message to arrive in full.
+        auto connIt = this->mConnections.find(clientSocket);
+        if(connIt != this->mConnections.end() && conn->mState == CONN_AWAITING_FIRST_MSG &&
+           !this->setEvents(conn, EPOLLIN | EPOLLRDHUP)) {
+            this->closeClient(conn);
+        }
+    }
+
+    // Backlog not yet drained, the listening socket stays readable and is reported again.
     return RC_SUCCESS;
 }
 
+// Set up the state of a newly accepted connection. On failure, the client socket is closed.
+ClientConnection* SocketServer::trackClient(int32_t clientSocket) {
+    ClientConnection* conn = nullptr;
+    try {
+        conn = new (GetBlock<ClientConnection>()) ClientConnection;
+    } catch(const std::bad_alloc& e) {
+        LOGE("RESTUNE_SOCKET_SERVER", "Failed to allocate connection state, dropping the client");
+        close(clientSocket);
+        return nullptr;
+    }
+
+    conn->mFd = clientSocket;
+    conn->mState = CONN_AWAITING_FIRST_MSG;
+    conn->mEvents = 0;
+    conn->mDeadline = AuxRoutines::getCurrentTimeInMilliseconds() + connectionIdleTimeout;
+    conn->mBroken = false;
+    conn->mStart = conn->mEnd = 0;
+    conn->mPartial = nullptr;
+    conn->mPartialFilled = 0;
+    conn->mPendingStart = 0;
+    conn->mFdCount = 0;
+    conn->mGen = 0;
+    conn->mSendInFlight = false;
+    conn->mFlushQueued = false;
+    this->mConnections[clientSocket] = conn;
+    return conn;
+}
+
 int32_t SocketServer::closeConnection() {
-    if(this->sockFd != -1) {
+    std::vector<ClientConnection*> conns;
+    for(auto& connEntry: this->mConnections) {
+        conns.push_back(connEntry.second);
+    }
+
+    for(ClientConnection* conn: conns) {
+        this->closeClient(conn);
+    }
+
+    for(auto& ringEntry: mRings) {
+        delete ringEntry.second.second;
+    }
+    mRings.clear();
+
+    if(this->mEpollFd != -1) {
+        close(this->mEpollFd);
+        this->mEpollFd = -1;
+    }
+
+    if(this->sockFd != -1 && this->mOwnsSockFd) {
         close(this->sockFd);
-        this->sockFd = -1;
+    }
+    this->sockFd = -1;
+
+    if(mThreadServer == this) {
+        mThreadServer = nullptr;
     }
     return RC_SOCKET_FD_CLOSE_FAILURE;
 }
 
-SocketServer::~SocketServer() {
-    if(this->sockFd != -1) {
-        close(this->sockFd);
-        this->sockFd = -1;
+int32_t SocketServer::sendResponse(int32_t clientFd, const void* buf, size_t bufSize) {
+    auto ringIt = mRings.find(clientFd);
+    if(ringIt != mRings.end()) {
+        int64_t result = -1;
+        memcpy(&result, buf, (bufSize < sizeof(result)) ? bufSize : sizeof(result));
+        if(!ringIt->second.second->complete(result)) {
+            LOGE("RESTUNE_SOCKET_SERVER", "Shared Ring CQ full, dropping the response");
+            return RC_SOCKET_FD_WRITE_FAILURE;
+        }
+        return RC_SUCCESS;
+    }
+
+    if(mThreadServer != nullptr) {
+        auto connIt = mThreadServer->mConnections.find(clientFd);
+        if(connIt != mThreadServer->mConnections.end()) {
+            return mThreadServer->queueResponse(connIt->second, buf, bufSize);
+        }
     }
+
+    LOGE("RESTUNE_SOCKET_SERVER", "Response for an unknown client, dropping it");
+    return RC_SOCKET_FD_WRITE_FAILURE;
+}
+
+SocketServer::~SocketServer() {
+    this->closeConnection();
 }
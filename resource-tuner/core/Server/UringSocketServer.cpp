@@ -0,0 +1,672 @@
+// Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
+// SPDX-License-Identifier: BSD-3-Clause-Clear
+
+#include <poll.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#include <linux/io_uring.h>
+
+#include "UringSocketServer.h"
+
+// The kind of operation a completion belongs to is carried in the low bits of its user_data.
+// The remaining bits hold the fd and the generation of the client connection (or of the Shared
+// Ring's doorbell), or for sends, the address of the UringSendOp.
+enum UringOpTag {
+    URING_OP_IGNORE,
+    URING_OP_ACCEPT,
+    URING_OP_POLL_CLIENT,
+    URING_OP_RECV,
+    URING_OP_SEND,
+    URING_OP_CLOSE,
+    URING_OP_RING,
+};
+
+static const uint32_t uringTagBits = 3;
+static const uint64_t uringTagMask = (1ULL << uringTagBits) - 1;
+static const uint32_t uringGenShift = 35;
+static const uint32_t uringGenMask = (1U << (64 - uringGenShift)) - 1;
+
+static uint64_t packUserData(int32_t tag, int32_t fd, uint32_t gen) {
+    return ((uint64_t)(gen & uringGenMask) << uringGenShift) |
+           ((uint64_t)(uint32_t)fd << uringTagBits) | (uint64_t)tag;
+}
+
+// Responses being sent. The bytes are owned by the operation rather than the connection,
+// since they must stay valid until the send completes, even if the connection is closed.
+typedef struct {
+    std::vector<char> mData;
+    int32_t mFd;
+    uint32_t mGen;
+    int8_t mLinkedClose;
+} UringSendOp;
+
+UringSocketServer::UringSocketServer(
+    ServerOnlineCheckCallback mServerOnlineCheckCb,
+    MessageReceivedCallback mMessageRecvCb,
+    int32_t listenFd) : SocketServer(mServerOnlineCheckCb, mMessageRecvCb, listenFd) {
+
+    this->mRingFd = -1;
+    this->mPendingSubmits = 0;
+    this->mNextGen = 1;
+    this->mAcceptMultishot = true;
+    this->mRecvMultishot = true;
+    this->mFailed = false;
+    this->mRingMem = nullptr;
+    this->mRingMemSize = 0;
+    this->mSqes = nullptr;
+    this->mSqesSize = 0;
+    this->mBufRing = nullptr;
+    this->mBufRingSize = 0;
+    this->mBufBase = nullptr;
+    this->mBufTail = 0;
+}
+
+int8_t UringSocketServer::setup() {
+    struct io_uring_params params;
+    memset(&params, 0, sizeof(params));
+
+    // Only the listener thread submits, and completions are only reaped via io_uring_enter,
+    // hence the kernel can defer the completion work until then.
+    params.flags = IORING_SETUP_SINGLE_ISSUER | IORING_SETUP_DEFER_TASKRUN;
+    this->mRingFd = syscall(__NR_io_uring_setup, uringQueueDepth, &params);
+    if(this->mRingFd < 0 && errno == EINVAL) {
+        memset(&params, 0, sizeof(params));
+        this->mRingFd = syscall(__NR_io_uring_setup, uringQueueDepth, &params);
+    }
+
+    if(this->mRingFd < 0) {
+        TYPELOGV(ERRNO_LOG, "io_uring_setup", strerror(errno));
+        this->mRingFd = -1;
+        return false;
+    }
+
+    uint32_t requiredFeatures = IORING_FEAT_SINGLE_MMAP | IORING_FEAT_NODROP | IORING_FEAT_EXT_ARG;
+    if((params.features & requiredFeatures) != requiredFeatures) {
+        LOGW("RESTUNE_SOCKET_SERVER", "io_uring lacks the features required by the listener");
+        this->teardown();
+        return false;
+    }
+
+    size_t sqRingSize = params.sq_off.array + params.sq_entries * sizeof(uint32_t);
+    size_t cqRingSize = params.cq_off.cqes + params.cq_entries * sizeof(struct io_uring_cqe);
+    this->mRingMemSize = (sqRingSize > cqRingSize) ? sqRingSize : cqRingSize;
+
+    void* ringMem = mmap(nullptr, this->mRingMemSize, PROT_READ | PROT_WRITE,
+                         MAP_SHARED | MAP_POPULATE, this->mRingFd, IORING_OFF_SQ_RING);
+    if(ringMem == MAP_FAILED) {
+        TYPELOGV(ERRNO_LOG, "mmap", strerror(errno));
+        this->teardown();
+        return false;
+    }
+    this->mRingMem = ringMem;
+
+    char* ring = (char*)ringMem;
+    this->mSqHead = (uint32_t*)(ring + params.sq_off.head);
+    this->mSqTail = (uint32_t*)(ring + params.sq_off.tail);
+    this->mSqMask = *(uint32_t*)(ring + params.sq_off.ring_mask);
+    this->mSqEntries = *(uint32_t*)(ring + params.sq_off.ring_entries);
+    this->mSqArray = (uint32_t*)(ring + params.sq_off.array);
+    this->mCqHead = (uint32_t*)(ring + params.cq_off.head);
+    this->mCqTail = (uint32_t*)(ring + params.cq_off.tail);
+    this->mCqMask = *(uint32_t*)(ring + params.cq_off.ring_mask);
+    this->mCqes = (struct io_uring_cqe*)(ring + params.cq_off.cqes);
+
+    this->mSqesSize = params.sq_entries * sizeof(struct io_uring_sqe);
+    void* sqes = mmap(nullptr, this->mSqesSize, PROT_READ | PROT_WRITE,
+                      MAP_SHARED | MAP_POPULATE, this->mRingFd, IORING_OFF_SQES);
+    if(sqes == MAP_FAILED) {
+        TYPELOGV(ERRNO_LOG, "mmap", strerror(errno));
+        this->teardown();
+        return false;
+    }
+    this->mSqes = (struct io_uring_sqe*)sqes;
+
+    // The buffer ring (which must be page aligned) is followed by the buffers themselves.
+    size_t bufRingEntriesSize = uringRecvBufferCount * sizeof(struct io_uring_buf);
+    this->mBufRingSize = bufRingEntriesSize + uringRecvBufferCount * uringRecvBufferSize;
+    void* bufRing = mmap(nullptr, this->mBufRingSize, PROT_READ | PROT_WRITE,
+                         MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+    if(bufRing == MAP_FAILED) {
+        TYPELOGV(ERRNO_LOG, "mmap", strerror(errno));
+        this->teardown();
+        return false;
+    }
+    this->mBufRing = (struct io_uring_buf*)bufRing;
+    this->mBufBase = (char*)bufRing + bufRingEntriesSize;
+
+    struct io_uring_buf_reg reg;
+    memset(&reg, 0, sizeof(reg));
+    reg.ring_addr = (uint64_t)bufRing;
+    reg.ring_entries = uringRecvBufferCount;
+    reg.bgid = 0;
+    if(syscall(__NR_io_uring_register, this->mRingFd, IORING_REGISTER_PBUF_RING, &reg, 1) < 0) {
+        TYPELOGV(ERRNO_LOG, "io_uring_register", strerror(errno));
+        this->teardown();
+        return false;
+    }
+
+    for(uint32_t i = 0; i < uringRecvBufferCount; i++) {
+        this->recycleBuffer(i);
+    }
+
+    return true;
+}
+
+void UringSocketServer::teardown() {
+    // Closing the ring cancels all the operations still in flight.
+    if(this->mRingFd != -1) {
+        close(this->mRingFd);
+        this->mRingFd = -1;
+    }
+
+    if(this->mSqes != nullptr) {
+        munmap(this->mSqes, this->mSqesSize);
+        this->mSqes = nullptr;
+    }
+
+    if(this->mRingMem != nullptr) {
+        munmap(this->mRingMem, this->mRingMemSize);
+        this->mRingMem = nullptr;
+    }
+
+    if(this->mBufRing != nullptr) {
+        munmap(this->mBufRing, this->mBufRingSize);
+        this->mBufRing = nullptr;
+        this->mBufBase = nullptr;
+    }
+
+    this->mPendingSubmits = 0;
+    this->mFlushList.clear();
+}
+
+// Hand the buffer back to the kernel, for the subsequent recvs. The ring is accessed as an array
+// of io_uring_buf entries, since in C++ the flexible array member of io_uring_buf_ring does not
+// start at offset 0.
+void UringSocketServer::recycleBuffer(uint16_t bufferId) {
+    struct io_uring_buf* buf = &this->mBufRing[this->mBufTail & (uringRecvBufferCount - 1)];
+    buf->addr = (uint64_t)(this->mBufBase + (size_t)bufferId * uringRecvBufferSize);
+    buf->len = uringRecvBufferSize;
+    buf->bid = bufferId;
+
+    this->mBufTail++;
+    __atomic_store_n(&this->mBufRing[0].resv, this->mBufTail, __ATOMIC_RELEASE);
+}
+
+// Make sure count SQEs can be queued back to back (e.g. a linked chain), submitting the
+// queued ones if the Submission Queue is full.
+int8_t UringSocketServer::reserveSqes(uint32_t count) {
+    uint32_t head = __atomic_load_n(this->mSqHead, __ATOMIC_ACQUIRE);
+    if(this->mSqEntries - (*this->mSqTail - head) >= count) {
+        return true;
+    }
+
+    if(this->enter(0, false) < 0) {
+        this->mFailed = true;
+        return false;
+    }
+
+    head = __atomic_load_n(this->mSqHead, __ATOMIC_ACQUIRE);
+    return (this->mSqEntries - (*this->mSqTail - head) >= count);
+}
+
+// Queue a zeroed SQE. It is only read by the kernel on the next io_uring_enter, hence the
+// tail can be published before the caller fills it in.
+struct io_uring_sqe* UringSocketServer::getSqe() {
+    if(!this->reserveSqes(1)) {
+        return nullptr;
+    }
+
+    uint32_t tail = *this->mSqTail;
+    uint32_t index = tail & this->mSqMask;
+    struct io_uring_sqe* sqe = &this->mSqes[index];
+    memset(sqe, 0, sizeof(struct io_uring_sqe));
+    this->mSqArray[index] = index;
+
+    __atomic_store_n(this->mSqTail, tail + 1, __ATOMIC_RELEASE);
+    this->mPendingSubmits++;
+    return sqe;
+}
+
+// Submit the queued SQEs, and if wait is set, wait (for upto a second) for minComplete completions.
+// The timeout lets the caller check the Server status, and sweep the idle connections periodically.
+int32_t UringSocketServer::enter(uint32_t minComplete, int8_t wait) {
+    struct __kernel_timespec timeout;
+    memset(&timeout, 0, sizeof(timeout));
+    timeout.tv_sec = 1;
+
+    struct io_uring_getevents_arg arg;
+    memset(&arg, 0, sizeof(arg));
+    arg.ts = (uint64_t)&timeout;
+
+    uint32_t flags = 0;
+    if(wait) {
+        flags = IORING_ENTER_GETEVENTS | IORING_ENTER_EXT_ARG;
+    }
+
+    int32_t submitted = syscall(__NR_io_uring_enter, this->mRingFd, this->mPendingSubmits, minComplete,
+                                flags, wait ? &arg : nullptr, wait ? sizeof(arg) : 0);
+    if(submitted >= 0) {
+        this->mPendingSubmits -= submitted;
+        return submitted;
+    }
+
+    if(errno == ETIME || errno == EINTR || errno == EAGAIN || errno == EBUSY) {
+        return 0;
+    }
+
+    TYPELOGV(ERRNO_LOG, "io_uring_enter", strerror(errno));
+    return -1;
+}
+
+void UringSocketServer::armAccept() {
+    struct io_uring_sqe* sqe = this->getSqe();
+    if(sqe == nullptr) return;
+
+    sqe->opcode = IORING_OP_ACCEPT;
+    sqe->fd = this->sockFd;
+    sqe->accept_flags = SOCK_NONBLOCK | SOCK_CLOEXEC;
+    sqe->ioprio = this->mAcceptMultishot ? IORING_ACCEPT_MULTISHOT : 0;
+    sqe->user_data = packUserData(URING_OP_ACCEPT, this->sockFd, 0);
+}
+
+// Wait for more bytes on the connection. The rest of the first message is read via recvmsg once
+// the socket is readable (as it may carry fds), while the sessions are served by a recv into the
+// provided buffers. Connections in the CONN_CLOSING state are not read from any more.
+void UringSocketServer::armClient(ClientConnection* conn) {
+    if(conn->mState != CONN_AWAITING_FIRST_MSG && conn->mState != CONN_SESSION) {
+        return;
+    }
+
+    struct io_uring_sqe* sqe = this->getSqe();
+    if(sqe == nullptr) return;
+
+    sqe->fd = conn->mFd;
+    if(conn->mState == CONN_AWAITING_FIRST_MSG) {
+        sqe->opcode = IORING_OP_POLL_ADD;
+        sqe->poll32_events = POLLIN | POLLRDHUP;
+        sqe->user_data = packUserData(URING_OP_POLL_CLIENT, conn->mFd, conn->mGen);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_RECV;
+    sqe->flags = IOSQE_BUFFER_SELECT;
+    sqe->buf_group = 0;
+    sqe->ioprio = this->mRecvMultishot ? IORING_RECV_MULTISHOT : 0;
+    sqe->user_data = packUserData(URING_OP_RECV, conn->mFd, conn->mGen);
+}
+
+void UringSocketServer::submitClose(int32_t fd) {
+    struct io_uring_sqe* sqe = this->getSqe();
+    if(sqe == nullptr) {
+        close(fd);
+        return;
+    }
+
+    sqe->opcode = IORING_OP_CLOSE;
+    sqe->fd = fd;
+    sqe->user_data = packUserData(URING_OP_CLOSE, fd, 0);
+}
+
+// Send all the pending responses of the connection with a single submission. For a connection which
+// is to be closed once its responses are sent, the close is linked to the send, i.e. it is carried
+// out by the kernel as soon as the send completes, and the connection state is released right away.
+void UringSocketServer::submitSend(ClientConnection* conn) {
+    int8_t linkClose = (conn->mState == CONN_CLOSING);
+    if(!this->reserveSqes(linkClose ? 2 : 1)) {
+        return;
+    }
+
+    UringSendOp* op = nullptr;
+    try {
+        op = new UringSendOp;
+    } catch(const std::bad_alloc& e) {
+        this->closeClient(conn);
+        return;
+    }
+
+    op->mData.swap(conn->mPending);
+    op->mFd = conn->mFd;
+    op->mGen = conn->mGen;
+    op->mLinkedClose = linkClose;
+
+    struct io_uring_sqe* sqe = this->getSqe();
+    sqe->opcode = IORING_OP_SEND;
+    sqe->fd = conn->mFd;
+    sqe->addr = (uint64_t)op->mData.data();
+    sqe->len = op->mData.size();
+    // A short send fails the link, hence the kernel is asked to send all the bytes.
+    sqe->msg_flags = MSG_NOSIGNAL | MSG_WAITALL;
+    sqe->user_data = (uint64_t)op | URING_OP_SEND;
+    conn->mSendInFlight = true;
+
+    if(linkClose) {
+        sqe->flags |= IOSQE_IO_LINK;
+        int32_t fd = conn->mFd;
+        this->releaseClient(conn);
+        this->submitClose(fd);
+    }
+}
+
+ClientConnection* UringSocketServer::findClient(int32_t fd, uint32_t gen) {
+    auto connIt = this->mConnections.find(fd);
+    if(connIt == this->mConnections.end() || connIt->second->mGen != gen) {
+        return nullptr;
+    }
+    return connIt->second;
+}
+
+void UringSocketServer::handleAccept(int32_t res, uint32_t flags) {
+    if(res >= 0) {
+        ClientConnection* conn = this->trackClient(res);
+        if(conn != nullptr) {
+            conn->mGen = (this->mNextGen++) & uringGenMask;
+            uint32_t gen = conn->mGen;
+
+            // The first message is usually sent right after connecting, hence it is read right away.
+            this->readClient(conn);
+            if((conn = this->findClient(res, gen)) != nullptr) {
+                this->armClient(conn);
+            }
+        }
+    } else if(res == -EINVAL && this->mAcceptMultishot) {
+        LOGW("RESTUNE_SOCKET_SERVER", "Multishot accept not supported, accepting one client per submission");
+        this->mAcceptMultishot = false;
+    } else if(res != -EAGAIN && res != -EINTR) {
+        TYPELOGV(ERRNO_LOG, "accept", strerror(-res));
+        LOGE("RESTUNE_SOCKET_SERVER", "Server Socket-Endpoint crashed");
+        this->mFailed = true;
+        return;
+    }
+
+    if(!(flags & IORING_CQE_F_MORE)) {
+        this->armAccept();
+    }
+}
+
+// Feed the received bytes to the connection, dispatching the messages as they are completed.
+void UringSocketServer::feedClient(ClientConnection* conn, const char* data, size_t size) {
+    while(true) {
+        int8_t status = 0;
+        while((status = this->dispatchNext(conn)) > 0);
+
+        if(status < 0 || size == 0) {
+            return;
+        }
+
+        size_t count = 0;
+        char* buf = this->nextReadSpan(conn, count);
+        count = (count < size) ? count : size;
+        memcpy(buf, data, count);
+        data += count;
+        size -= count;
+
+        if(conn->mPartial != nullptr) {
+            conn->mPartialFilled += count;
+        } else {
+            conn->mEnd += count;
+        }
+    }
+}
+
+void UringSocketServer::handleRecv(int32_t fd, uint32_t gen, int32_t res, uint32_t flags) {
+    ClientConnection* conn = this->findClient(fd, gen);
+
+    if(flags & IORING_CQE_F_BUFFER) {
+        uint16_t bufferId = flags >> IORING_CQE_BUFFER_SHIFT;
+        if(conn != nullptr && conn->mState == CONN_SESSION && res > 0) {
+            this->feedClient(conn, this->mBufBase + (size_t)bufferId * uringRecvBufferSize, res);
+            conn = this->findClient(fd, gen);
+        }
+        this->recycleBuffer(bufferId);
+    }
+
+    if(conn == nullptr || conn->mState != CONN_SESSION) {
+        return;
+    }
+
+    if(res == 0) {
+        // Client disconnected.
+        this->closeClient(conn);
+        return;
+    }
+
+    if(res == -EINVAL && this->mRecvMultishot) {
+        LOGW("RESTUNE_SOCKET_SERVER", "Multishot recv not supported, receiving once per submission");
+        this->mRecvMultishot = false;
+    } else if(res < 0 && res != -ENOBUFS) {
+        this->closeClient(conn);
+        return;
+    }
+
+    if(!(flags & IORING_CQE_F_MORE)) {
+        this->armClient(conn);
+    }
+}
+
+void UringSocketServer::handleSend(void* sendOp, int32_t res) {
+    UringSendOp* op = (UringSendOp*)sendOp;
+    ClientConnection* conn = op->mLinkedClose ? nullptr : this->findClient(op->mFd, op->mGen);
+    size_t size = op->mData.size();
+    delete op;
+
+    if(conn == nullptr) {
+        return;
+    }
+
+    conn->mSendInFlight = false;
+    if(res < 0 || (size_t)res < size) {
+        if(res < 0) {
+            TYPELOGV(ERRNO_LOG, "send", strerror(-res));
+        }
+        this->closeClient(conn);
+        return;
+    }
+
+    if(!conn->mPending.empty()) {
+        this->submitSend(conn);
+    } else if(conn->mState == CONN_CLOSING) {
+        this->closeClient(conn);
+    }
+}
+
+void UringSocketServer::handleCompletion(uint64_t userData, int32_t res, uint32_t flags) {
+    int32_t tag = userData & uringTagMask;
+    int32_t fd = (int32_t)(uint32_t)(userData >> uringTagBits);
+    uint32_t gen = (uint32_t)(userData >> uringGenShift);
+
+    switch(tag) {
+        case URING_OP_ACCEPT:
+            this->handleAccept(res, flags);
+            break;
+
+        case URING_OP_POLL_CLIENT: {
+            ClientConnection* conn = this->findClient(fd, gen);
+            if(conn != nullptr) {
+                this->readClient(conn);
+                if((conn = this->findClient(fd, gen)) != nullptr) {
+                    this->armClient(conn);
+                }
+            }
+            break;
+        }
+
+        case URING_OP_RECV:
+            this->handleRecv(fd, gen, res, flags);
+            break;
+
+        case URING_OP_SEND:
+            this->handleSend((void*)(userData & ~uringTagMask), res);
+            break;
+
+        case URING_OP_CLOSE:
+            // The close linked to a failed send is cancelled, the fd is closed right away instead.
+            if(res == -ECANCELED) {
+                close(fd);
+            }
+            break;
+
+        case URING_OP_RING:
+            if(res < 0 || mRings.find(fd) == mRings.end()) {
+                break;
+            }
+
+            this->serveRing(fd);
+            if(!(flags & IORING_CQE_F_MORE) && mRings.find(fd) != mRings.end()) {
+                this->watchRing(fd);
+            }
+            break;
+
+        default:
+            break;
+    }
+}
+
+// Submit the responses queued while processing the completions of the current wakeup.
+void UringSocketServer::flushResponses() {
+    for(std::pair<int32_t, uint32_t>& entry: this->mFlushList) {
+        ClientConnection* conn = this->findClient(entry.first, entry.second);
+        if(conn == nullptr) {
+            continue;
+        }
+
+        conn->mFlushQueued = false;
+        if(!conn->mSendInFlight && !conn->mPending.empty()) {
+            this->submitSend(conn);
+        }
+    }
+
+    this->mFlushList.clear();
+}
+
+int32_t UringSocketServer::ListenForClientRequests() {
+    if(this->mRingFd == -1 && !this->setup()) {
+        return RC_SOCKET_CONN_NOT_INITIALIZED;
+    }
+
+    if(this->sockFd == -1) {
+        if((this->sockFd = createListenSocket()) < 0) {
+            this->sockFd = -1;
+            return RC_SOCKET_CONN_NOT_INITIALIZED;
+        }
+    }
+
+    mThreadServer = this;
+    this->mNextSweep = AuxRoutines::getCurrentTimeInMilliseconds() + connectionIdleTimeout;
+    this->armAccept();
+
+    while(this->mServerOnlineCheckCb() && !this->mFailed) {
+        // Flushes the submissions queued during the previous wakeup as well.
+        if(this->enter(1, true) < 0) {
+            return RC_SOCKET_OP_FAILURE;
+        }
+
+        uint32_t head = *this->mCqHead;
+        while(head != __atomic_load_n(this->mCqTail, __ATOMIC_ACQUIRE) && !this->mFailed) {
+            struct io_uring_cqe* cqe = &this->mCqes[head & this->mCqMask];
+            uint64_t userData = cqe->user_data;
+            int32_t res = cqe->res;
+            uint32_t flags = cqe->flags;
+
+            head++;
+            __atomic_store_n(this->mCqHead, head, __ATOMIC_RELEASE);
+            this->handleCompletion(userData, res, flags);
+        }
+
+        this->flushResponses();
+        this->sweepIdleClients();
+    }
+
+    return this->mFailed ? RC_SOCKET_OP_FAILURE : RC_SUCCESS;
+}
+
+// The connection is (re)armed by armClient according to its state, once the message has been
+// dispatched, hence there are no events to update.
+int8_t UringSocketServer::setEvents(ClientConnection* conn, uint32_t events) {
+    (void)conn;
+    (void)events;
+    return true;
+}
+
+// Responses are only queued here, and sent by flushResponses once all the completions of the
+// current wakeup have been processed. At most one send is in flight per connection, so that
+// the responses are delivered in order.
+int32_t UringSocketServer::queueResponse(ClientConnection* conn, const void* buf, size_t bufSize) {
+    if(conn->mBroken) {
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    if(conn->mPending.size() + bufSize > maxPendingResponseSize) {
+        LOGE("RESTUNE_SOCKET_SERVER", "Client not reading its responses, dropping the connection");
+        conn->mBroken = true;
+        return RC_SOCKET_FD_WRITE_FAILURE;
+    }
+
+    const char* bytes = (const char*)buf;
+    conn->mPending.insert(conn->mPending.end(), bytes, bytes + bufSize);
+
+    if(!conn->mFlushQueued) {
+        conn->mFlushQueued = true;
+        this->mFlushList.push_back({conn->mFd, conn->mGen});
+    }
+    return RC_SUCCESS;
+}
+
+void UringSocketServer::closeAfterFlush(ClientConnection* conn) {
+    conn->mState = CONN_CLOSING;
+    if(conn->mBroken || (!conn->mSendInFlight && conn->mPending.empty())) {
+        this->closeClient(conn);
+        return;
+    }
+
+    // Closed along with (or after) the send of its pending responses.
+    conn->mDeadline = AuxRoutines::getCurrentTimeInMilliseconds() + connectionIdleTimeout;
+}
+
+// Shutting the socket down completes the poll, recv or send still pending on it, while the
+// fd itself is closed by the kernel, along with the other submissions of this wakeup.
+void UringSocketServer::closeClient(ClientConnection* conn) {
+    if(this->mRingFd == -1) {
+        SocketServer::closeClient(conn);
+        return;
+    }
+
+    int32_t fd = conn->mFd;
+    shutdown(fd, SHUT_RDWR);
+    this->releaseClient(conn);
+    this->submitClose(fd);
+}
+
+int8_t UringSocketServer::watchRing(int32_t sqEventFd) {
+    struct io_uring_sqe* sqe = this->getSqe();
+    if(sqe == nullptr) {
+        return false;
+    }
+
+    sqe->opcode = IORING_OP_POLL_ADD;
+    sqe->fd = sqEventFd;
+    sqe->poll32_events = POLLIN;
+    sqe->len = IORING_POLL_ADD_MULTI;
+    sqe->user_data = packUserData(URING_OP_RING, sqEventFd, 0);
+    return true;
+}
+
+void UringSocketServer::unwatchRing(int32_t sqEventFd) {
+    if(this->mRingFd == -1) return;
+
+    struct io_uring_sqe* sqe = this->getSqe();
+    if(sqe == nullptr) return;
+
+    sqe->opcode = IORING_OP_POLL_REMOVE;
+    sqe->addr = packUserData(URING_OP_RING, sqEventFd, 0);
+    sqe->user_data = packUserData(URING_OP_IGNORE, sqEventFd, 0);
+}
+
+int32_t UringSocketServer::closeConnection() {
+    // Once the ring is gone, the connections are closed directly.
+    this->teardown();
+    return SocketServer::closeConnection();
+}
+
+UringSocketServer::~UringSocketServer() {
+    this->closeConnection();
+}
@@ -378,7 +378,10 @@ int32_t TargetRegistry::getPhysicalCoreId(int32_t logicalClusterId, int32_t logi
 }
 
 ClusterInfo* TargetRegistry::getClusterInfo(int32_t physicalClusterID) {
-    return this->mPhysicalClusters[physicalClusterID];
+    // Lookup without insertion, since it may be invoked concurrently by the Applier Shards.
+    auto it = this->mPhysicalClusters.find(physicalClusterID);
+    if(it == this->mPhysicalClusters.end()) return nullptr;
+    return it->second;
 }
 
 void TargetRegistry::getCGroupNames(std::vector<std::string>& cGroupNames) {
@@ -388,7 +391,9 @@ void TargetRegistry::getCGroupNames(std::vector<std::string>& cGroupNames) {
 }
 
 CGroupConfigInfo* TargetRegistry::getCGroupConfig(int32_t cGroupID) {
-    return this->mCGroupMapping[cGroupID];
+    auto it = this->mCGroupMapping.find(cGroupID);
+    if(it == this->mCGroupMapping.end()) return nullptr;
+    return it->second;
 }
 
 void TargetRegistry::getCGroupConfigs(std::vector<CGroupConfigInfo*>& cGroupConfigs) {
@@ -505,6 +510,21 @@ void TargetRegistry::addCacheInfoMapping(CacheInfo* cacheInfo) {
     this->mCacheInfoMapping[cacheInfo->mCacheType] = cacheInfo;
 }
 
+void TargetRegistry::addThreadConfigMapping(ThreadConfigInfo* threadConfigInfo) {
+    if(threadConfigInfo == nullptr) return;
+
+    int32_t threadClass = threadConfigInfo->mThreadClass;
+    if(threadClass < 0 || threadClass >= TOTAL_THREAD_CLASSES) {
+        delete threadConfigInfo;
+        return;
+    }
+
+    // Configs from the Custom Init files override the Common ones.
+    threadConfigInfo->mConfigured = true;
+    UrmSettings::threadConfigs[threadClass] = *threadConfigInfo;
+    delete threadConfigInfo;
+}
+
 ErrCode TargetRegistry::addIrqAffine(std::vector<std::string>& values,
                                      int8_t areClusterValues) {
     if(values.size() < 1) {
@@ -836,6 +856,215 @@ CacheInfo* CacheInfoBuilder::build() {
     return this->mCacheInfo;
 }
 
+ThreadConfigInfoBuilder::ThreadConfigInfoBuilder() {
+    this->mThreadConfigInfo = new(std::nothrow) ThreadConfigInfo;
+    if(this->mThreadConfigInfo == nullptr) {
+        return;
+    }
+
+    this->mThreadConfigInfo->mThreadClass = -1;
+    this->mThreadConfigInfo->mConfigured = false;
+    this->mThreadConfigInfo->mHasCpuSet = false;
+    CPU_ZERO(&this->mThreadConfigInfo->mCpuSet);
+    this->mThreadConfigInfo->mSchedPolicy = -1;
+    this->mThreadConfigInfo->mSchedPriority = 0;
+    this->mThreadConfigInfo->mHasNice = false;
+    this->mThreadConfigInfo->mNice = 0;
+    this->mThreadConfigInfo->mUclampMin = -1;
+    this->mThreadConfigInfo->mUclampMax = -1;
+}
+
+ErrCode ThreadConfigInfoBuilder::setName(const std::string& threadClassName) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    const std::unordered_map<std::string, int32_t> threadClasses = {
+        {"listener", THREAD_CLASS_LISTENER},
+        {"consumer", THREAD_CLASS_CONSUMER},
+        {"workers", THREAD_CLASS_WORKER},
+        {"timer", THREAD_CLASS_TIMER},
+        {"classifier", THREAD_CLASS_CLASSIFIER},
+    };
+
+    auto it = threadClasses.find(threadClassName);
+    if(it == threadClasses.end()) {
+        this->mThreadConfigInfo->mThreadClass = -1;
+        return RC_INVALID_VALUE;
+    }
+
+    this->mThreadConfigInfo->mThreadClass = it->second;
+    return RC_SUCCESS;
+}
+
+// CPU set is specified as a comma separated list of CPUs and CPU ranges, for example: "0-3,6"
+ErrCode ThreadConfigInfoBuilder::setCpuSet(const std::string& cpuSetString) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    cpu_set_t cpuSet;
+    CPU_ZERO(&cpuSet);
+
+    try {
+        std::stringstream cpuStream(cpuSetString);
+        std::string token;
+        while(std::getline(cpuStream, token, ',')) {
+            size_t sep = token.find('-');
+            int32_t first = std::stoi(token.substr(0, sep));
+            int32_t last = (sep == std::string::npos) ? first : std::stoi(token.substr(sep + 1));
+
+            if(first < 0 || last < first || last >= CPU_SETSIZE) {
+                return RC_INVALID_VALUE;
+            }
+
+            for(int32_t cpu = first; cpu <= last; cpu++) {
+                CPU_SET(cpu, &cpuSet);
+            }
+        }
+    } catch(const std::exception& e) {
+        return RC_INVALID_VALUE;
+    }
+
+    if(CPU_COUNT(&cpuSet) == 0) {
+        return RC_INVALID_VALUE;
+    }
+
+    this->mThreadConfigInfo->mCpuSet = cpuSet;
+    this->mThreadConfigInfo->mHasCpuSet = true;
+    return RC_SUCCESS;
+}
+
+ErrCode ThreadConfigInfoBuilder::setSchedPolicy(const std::string& policy) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    if(policy == "SCHED_OTHER") {
+        this->mThreadConfigInfo->mSchedPolicy = SCHED_OTHER;
+    } else if(policy == "SCHED_FIFO") {
+        this->mThreadConfigInfo->mSchedPolicy = SCHED_FIFO;
+    } else if(policy == "SCHED_RR") {
+        this->mThreadConfigInfo->mSchedPolicy = SCHED_RR;
+    } else {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+// Static priority, only applicable to the Real Time policies (SCHED_FIFO and SCHED_RR)
+ErrCode ThreadConfigInfoBuilder::setPriority(const std::string& priorityString) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    try {
+        int32_t priority = std::stoi(priorityString);
+        if(priority < 0 || priority > 99) {
+            return RC_INVALID_VALUE;
+        }
+
+        this->mThreadConfigInfo->mSchedPriority = priority;
+        return RC_SUCCESS;
+
+    } catch(const std::exception& e) {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_INVALID_VALUE;
+}
+
+ErrCode ThreadConfigInfoBuilder::setNice(const std::string& niceString) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    try {
+        int32_t nice = std::stoi(niceString);
+        if(nice < -20 || nice > 19) {
+            return RC_INVALID_VALUE;
+        }
+
+        this->mThreadConfigInfo->mNice = nice;
+        this->mThreadConfigInfo->mHasNice = true;
+        return RC_SUCCESS;
+
+    } catch(const std::exception& e) {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_INVALID_VALUE;
+}
+
+ErrCode ThreadConfigInfoBuilder::setUclampMin(const std::string& uclampMinString) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    try {
+        int32_t uclampMin = std::stoi(uclampMinString);
+        if(uclampMin < 0 || uclampMin > 1024) {
+            return RC_INVALID_VALUE;
+        }
+
+        this->mThreadConfigInfo->mUclampMin = uclampMin;
+        return RC_SUCCESS;
+
+    } catch(const std::exception& e) {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_INVALID_VALUE;
+}
+
+ErrCode ThreadConfigInfoBuilder::setUclampMax(const std::string& uclampMaxString) {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    try {
+        int32_t uclampMax = std::stoi(uclampMaxString);
+        if(uclampMax < 0 || uclampMax > 1024) {
+            return RC_INVALID_VALUE;
+        }
+
+        this->mThreadConfigInfo->mUclampMax = uclampMax;
+        return RC_SUCCESS;
+
+    } catch(const std::exception& e) {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_INVALID_VALUE;
+}
+
+// The static priority must be in the range [1, 99] for the Real Time policies (SCHED_FIFO
+// and SCHED_RR), and 0 for the others. Checked once all the attributes have been set,
+// since they can be listed in any order.
+ErrCode ThreadConfigInfoBuilder::validate() {
+    if(this->mThreadConfigInfo == nullptr) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    int32_t policy = this->mThreadConfigInfo->mSchedPolicy;
+    int32_t priority = this->mThreadConfigInfo->mSchedPriority;
+
+    if(policy == SCHED_FIFO || policy == SCHED_RR) {
+        if(priority < 1 || priority > 99) {
+            return RC_INVALID_VALUE;
+        }
+    } else if(priority != 0) {
+        return RC_INVALID_VALUE;
+    }
+
+    return RC_SUCCESS;
+}
+
+ThreadConfigInfo* ThreadConfigInfoBuilder::build() {
+    return this->mThreadConfigInfo;
+}
+
 uint64_t GET_TARGET_INFO(int32_t option,
                          int32_t numArgs,
                          int32_t* args) {
@@ -75,6 +75,16 @@
 #define INIT_CONFIGS_ELEM_CACHE_INFO_BLK_CNT "NumCacheBlocks"
 #define INIT_CONFIGS_ELEM_CACHE_INFO_PRIO_AWARE "PriorityAware"
 
+// Thread Configs
+#define INIT_CONFIGS_ELEM_THREAD_CONFIGS_LIST "ThreadConfigs"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_NAME "Name"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_CPU_SET "CpuSet"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_POLICY "SchedPolicy"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_PRIORITY "Priority"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_NICE "Nice"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MIN "UclampMin"
+#define INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MAX "UclampMax"
+
 // IRQ Configs
 #define INIT_CONFIGS_IRQ_CONFIGS_LIST "IRQConfigs"
 #define INIT_CONFIG_IRQ_AFFINE_ONE "AffineIRQ"
@@ -220,11 +230,24 @@
  *       NumCacheBlocks: 1
  *       PriorityAware: 1
  *
+ *   # Thread Classes: listener, consumer, workers, timer, classifier
+ *   # All the fields except Name are optional.
+ *   - ThreadConfigs:
+ *     - Name: "listener"
+ *       CpuSet: "0-3"
+ *       Nice: -5
+ *     - Name: "consumer"
+ *       CpuSet: "0-3"
+ *       SchedPolicy: "SCHED_FIFO"
+ *       Priority: 10
+ *       UclampMin: 512
+ *
  * @endcode
  *
  * @example Init_Configs
  * This example shows the expected YAML format for Init Configuration, which includes any
- * applicable Control group, Mpam group Creation Information.
+ * applicable Control group, Mpam group Creation Information and the CPU set / scheduling
+ * attributes for the daemon-internal threads.
  */
 
 /**
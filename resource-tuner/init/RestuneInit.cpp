@@ -6,6 +6,7 @@
 #include <string>
 #include <thread>
 #include <memory>
+#include <sstream>
 
 #include "Config.h"
 #include "ErrCodes.h"
@@ -29,6 +30,9 @@ static void** extensionLibHandles = nullptr;
 static std::thread restuneHandlerThread;
 static std::thread resourceTunerListener;
 
+// Recurring Timer, which releases the idle Memory Pool Slabs
+static Timer* poolTrimTimer = nullptr;
+
 static void restoreToSafeState() {
     if(AuxRoutines::fileExists(UrmSettings::mPersistenceFile)) {
         AuxRoutines::writeSysFsDefaults();
@@ -79,6 +83,18 @@ static ErrCode loadExtensionsLib() {
     return RC_SUCCESS;
 }
 
+// Reserve the boot share of the capacity for the type T. The pool grows on demand
+// in Slabs of the same size, upto ceiling factor x capacity.
+template <typename T>
+static void makePoolAllocation(uint32_t capacity) {
+    uint32_t reservedCount = (capacity * UrmSettings::metaConfigs.mPoolBootShare) / 100;
+    if(reservedCount < 1) {
+        reservedCount = 1;
+    }
+
+    MakeAlloc<T> (reservedCount, capacity * UrmSettings::metaConfigs.mPoolCeilingFactor);
+}
+
 static void preAllocateMemory() {
     // Preallocate Memory for certain frequently used types.
     uint32_t concurrentRequestsUB = UrmSettings::metaConfigs.mMaxConcurrentRequests;
@@ -86,20 +102,46 @@ static void preAllocateMemory() {
 
     uint32_t maxBlockCount = concurrentRequestsUB * resourcesPerRequestUB;
 
-    MakeAlloc<Message> (concurrentRequestsUB);
-    MakeAlloc<Request> (concurrentRequestsUB);
-    MakeAlloc<DLManager> (concurrentRequestsUB);
-    MakeAlloc<Timer> (concurrentRequestsUB);
-    MakeAlloc<Resource> (maxBlockCount);
-    MakeAlloc<ClientInfo> (maxBlockCount);
-    MakeAlloc<ClientTidData> (maxBlockCount);
-    MakeAlloc<std::unordered_set<int64_t>> (maxBlockCount);
-    MakeAlloc<MsgForwardInfo> (maxBlockCount);
-    MakeAlloc<ResIterable> (maxBlockCount);
-    MakeAlloc<char[REQ_BUFFER_SIZE]> (maxBlockCount);
-    MakeAlloc<Signal> (concurrentRequestsUB);
-    MakeAlloc<std::vector<Resource*>> (concurrentRequestsUB * resourcesPerRequestUB);
-    MakeAlloc<std::vector<uint32_t>> (concurrentRequestsUB * resourcesPerRequestUB);
+    makePoolAllocation<Message> (concurrentRequestsUB);
+    makePoolAllocation<Request> (concurrentRequestsUB);
+    makePoolAllocation<DLManager> (concurrentRequestsUB);
+    makePoolAllocation<Timer> (concurrentRequestsUB);
+    makePoolAllocation<Resource> (maxBlockCount);
+    makePoolAllocation<ClientInfo> (maxBlockCount);
+    makePoolAllocation<ClientTidData> (maxBlockCount);
+    makePoolAllocation<std::unordered_set<int64_t>> (maxBlockCount);
+    makePoolAllocation<MsgForwardInfo> (maxBlockCount);
+    makePoolAllocation<ClientConnection> (maxEvents);
+    makePoolAllocation<ResIterable> (maxBlockCount);
+    makePoolAllocation<char[REQ_BUFFER_SIZE]> (maxBlockCount);
+    makePoolAllocation<Signal> (concurrentRequestsUB);
+    makePoolAllocation<std::vector<Resource*>> (concurrentRequestsUB * resourcesPerRequestUB);
+    makePoolAllocation<std::vector<uint32_t>> (concurrentRequestsUB * resourcesPerRequestUB);
+}
+
+// Periodically release the grown Memory Pool Slabs, which are no longer needed.
+static ErrCode startPoolTrimDaemon() {
+    if(UrmSettings::metaConfigs.mPoolIdleRelease == 0) {
+        return RC_SUCCESS;
+    }
+
+    try {
+        poolTrimTimer = MPLACEV(Timer, [](void*) {
+            int32_t releasedCount = ReleaseIdleSlabs();
+            if(releasedCount > 0) {
+                LOGD("URM_MEMORY_POOL", "Released " + std::to_string(releasedCount) + " idle blocks");
+            }
+        }, true);
+
+    } catch(const std::bad_alloc& e) {
+        return RC_MEMORY_ALLOCATION_FAILURE;
+    }
+
+    if(!poolTrimTimer->startTimer(UrmSettings::metaConfigs.mPoolIdleRelease)) {
+        return RC_WORKER_THREAD_ASSIGNMENT_FAILURE;
+    }
+
+    return RC_SUCCESS;
 }
 
 static void initLogger() {
@@ -185,14 +227,100 @@ static ErrCode fetchMetaConfigs() {
             UrmSettings::metaConfigs.mAcceptMode = ACCEPT_AND_REPLACE;
         }
 
+        // Coalesce Request expiries into batched CocoTable removals by default
+        submitPropGetRequest(EXPIRY_BATCHING, resultBuffer, "true");
+        UrmSettings::metaConfigs.mExpiryBatching = (std::string(resultBuffer) == "true");
+
+        // Producers publish to lock-free Ingest Rings by default
+        UrmSettings::metaConfigs.mRequestQueueMode = ORDERED_QUEUE_INGEST_RING;
+        submitPropGetRequest(REQUEST_QUEUE_MODE, resultBuffer, "INGEST_RING");
+        if(std::string(resultBuffer) == "LOCKED") {
+            UrmSettings::metaConfigs.mRequestQueueMode = ORDERED_QUEUE_LOCKED;
+        }
+
+        submitPropGetRequest(REQUEST_QUEUE_BATCH_SIZE, resultBuffer, "32");
+        UrmSettings::metaConfigs.mConsumerBatchSize = (uint32_t)std::stol(resultBuffer);
+
+        UrmSettings::metaConfigs.mThreadPoolMode = THREAD_POOL_SHARED_QUEUE;
+        submitPropGetRequest(THREAD_POOL_MODE, resultBuffer, "SHARED_QUEUE");
+        if(std::string(resultBuffer) == "WORK_STEALING") {
+            UrmSettings::metaConfigs.mThreadPoolMode = THREAD_POOL_WORK_STEALING;
+        }
+
+        // Lanes are served in proportion to their weights by default
+        UrmSettings::metaConfigs.mLanePolicy = TASK_LANE_WEIGHTED;
+        submitPropGetRequest(THREAD_POOL_LANE_POLICY, resultBuffer, "WEIGHTED");
+        if(resultBuffer == "STRICT") {
+            UrmSettings::metaConfigs.mLanePolicy = TASK_LANE_STRICT;
+        }
+
+        submitPropGetRequest(THREAD_POOL_LANE_WEIGHTS, resultBuffer, "8,4,1");
+        std::stringstream weightStream(resultBuffer);
+        std::string weight;
+        for(int32_t lane = 0; lane < TOTAL_TASK_LANES; lane++) {
+            UrmSettings::metaConfigs.mLaneWeights[lane] = 1;
+            if(std::getline(weightStream, weight, ',')) {
+                UrmSettings::metaConfigs.mLaneWeights[lane] = std::stoi(weight);
+            }
+        }
+
+        submitPropGetRequest(MEMORY_POOL_BOOT_SHARE, resultBuffer, "25");
+        UrmSettings::metaConfigs.mPoolBootShare = (uint32_t)std::stol(resultBuffer);
+
+        submitPropGetRequest(MEMORY_POOL_CEILING_FACTOR, resultBuffer, "2");
+        UrmSettings::metaConfigs.mPoolCeilingFactor = (uint32_t)std::stol(resultBuffer);
+
+        submitPropGetRequest(MEMORY_POOL_IDLE_RELEASE, resultBuffer, "60000");
+        UrmSettings::metaConfigs.mPoolIdleRelease = (uint32_t)std::stol(resultBuffer);
+
+        submitPropGetRequest(LISTENER_THREAD_COUNT, resultBuffer, "2");
+        UrmSettings::metaConfigs.mListenerThreadCount = (uint32_t)std::stol(resultBuffer);
+
+        UrmSettings::metaConfigs.mListenerBackend = LISTENER_BACKEND_EPOLL;
+        submitPropGetRequest(LISTENER_BACKEND, resultBuffer, "EPOLL");
+        if(std::string(resultBuffer) == "IO_URING") {
+            UrmSettings::metaConfigs.mListenerBackend = LISTENER_BACKEND_IO_URING;
+        }
+
+        // Resource writes are performed inline (on the consumer thread) by default
+        submitPropGetRequest(APPLIER_SHARD_COUNT, resultBuffer, "1");
+        UrmSettings::metaConfigs.mApplierShardCount = (uint32_t)std::stol(resultBuffer);
+
+        // Coalesce the Resource writes issued while processing a batch of Requests by default
+        submitPropGetRequest(WRITE_PLAN, resultBuffer, "true");
+        UrmSettings::metaConfigs.mWritePlan = (std::string(resultBuffer) == "true");
+
+        submitPropGetRequest(NODE_SHADOW_VALIDITY, resultBuffer, "5000");
+        UrmSettings::metaConfigs.mNodeShadowValidity = (uint32_t)std::stol(resultBuffer);
+
+        if(UrmSettings::metaConfigs.mPoolBootShare < 1 || UrmSettings::metaConfigs.mPoolBootShare > 100) {
+            UrmSettings::metaConfigs.mPoolBootShare = 100;
+        }
+
+        if(UrmSettings::metaConfigs.mPoolCeilingFactor < 1) {
+            UrmSettings::metaConfigs.mPoolCeilingFactor = 1;
+        }
+
         if(UrmSettings::metaConfigs.mDesiredThreadCount < 1) {
             UrmSettings::metaConfigs.mDesiredThreadCount = 5; // Reset to default
         }
 
+        if(UrmSettings::metaConfigs.mConsumerBatchSize < 1) {
+            UrmSettings::metaConfigs.mConsumerBatchSize = 32; // Reset to default
+        }
+
         if(UrmSettings::metaConfigs.mMaxScalingCapacity > 100) {
             UrmSettings::metaConfigs.mMaxScalingCapacity = 100;
         }
 
+        if(UrmSettings::metaConfigs.mListenerThreadCount < 1) {
+            UrmSettings::metaConfigs.mListenerThreadCount = 1;
+        }
+
+        if(UrmSettings::metaConfigs.mListenerThreadCount > maxListenerThreads) {
+            UrmSettings::metaConfigs.mListenerThreadCount = maxListenerThreads;
+        }
+
     } catch(const std::invalid_argument& e) {
         TYPELOGV(META_CONFIG_PARSE_FAILURE, e.what());
         return RC_PROP_PARSING_ERROR;
@@ -432,39 +560,54 @@ static ErrCode fetchPerAppConfigs() {
     return opStatus;
 }
 
-// Initialize Request and Timer ThreadPools
+// Initialize Request ThreadPool and the Timer Wheel
 static ErrCode preAllocateWorkers() {
     uint32_t desiredThreadCapacity = UrmSettings::metaConfigs.mDesiredThreadCount;
     uint32_t maxScalingCapacity = UrmSettings::metaConfigs.mMaxScalingCapacity;
 
     try {
         RequestReceiver::mRequestsThreadPool = new ThreadPool(desiredThreadCapacity,
-                                                              maxScalingCapacity);
+                                                              maxScalingCapacity,
+                                                              (ThreadPoolMode)UrmSettings::metaConfigs.mThreadPoolMode);
 
-        // Allocate 2 extra threads for Pulse Monitor and Garbage Collector
-        Timer::mTimerThreadPool = new ThreadPool(desiredThreadCapacity + 2,
-                                                 maxScalingCapacity);
+        RequestReceiver::mRequestsThreadPool->setLanePolicy(
+            (TaskLanePolicy)UrmSettings::metaConfigs.mLanePolicy,
+            UrmSettings::metaConfigs.mLaneWeights);
 
     } catch(const std::bad_alloc& e) {
         TYPELOGV(THREAD_POOL_CREATION_FAILURE, e.what());
         return RC_MODULE_INIT_FAILURE;
     }
 
+    // All the Timers (Request expiry, Pulse Monitor and Garbage Collector)
+    // are driven by a single expiry thread.
+    if(TimerWheel::getInstance() == nullptr) {
+        TYPELOGV(SYSTEM_THREAD_CREATION_FAILURE, "timer-wheel", "allocation failed");
+        return RC_MODULE_INIT_FAILURE;
+    }
+
     return RC_SUCCESS;
 }
 
 static void* restuneThreadStart() {
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_CONSUMER);
     std::shared_ptr<RequestQueue> requestQueue = RequestQueue::getInstance();
 
     // Initialize CocoTable
     CocoTable::getInstance();
+    // Requests are extracted in batches, and applied with the Queue lock released
     while(UrmSettings::isServerOnline()) {
-        requestQueue->wait();
+        requestQueue->waitForBatch(UrmSettings::metaConfigs.mConsumerBatchSize);
     }
 
     return nullptr;
 }
 
+static void listenerThreadStart() {
+    AuxRoutines::applyThreadConfig(THREAD_CLASS_LISTENER);
+    listenerThreadStartRoutine();
+}
+
 static ErrCode setCgroupParam(const std::string& slice,
                               const std::string& name,
                               const std::string& value) {
@@ -556,11 +699,6 @@ static ErrCode init(void* arg) {
     // syslog, ftrace or regular text file.
     initLogger();
 
-    // Pre Allocate some Worker Threads in the Thread Pool for handling requests
-    if(RC_IS_NOTOK(preAllocateWorkers())) {
-        return RC_MODULE_INIT_FAILURE;
-    }
-
     // Fetch and Parse: Custom Target Configs
     if(RC_IS_NOTOK(fetchTargetInfo())) {
         return RC_MODULE_INIT_FAILURE;
@@ -574,6 +712,13 @@ static ErrCode init(void* arg) {
         return RC_MODULE_INIT_FAILURE;
     }
 
+    // Pre Allocate some Worker Threads in the Thread Pool for handling requests
+    // Note this is done after parsing the Init Configs, so that the Thread Configs
+    // (CPU set and scheduling attributes) are available when the workers start.
+    if(RC_IS_NOTOK(preAllocateWorkers())) {
+        return RC_MODULE_INIT_FAILURE;
+    }
+
     // Fetch and Parse Resource Configs
     // Resource Configs which will be considered:
     // - Common Resource Configs
@@ -634,9 +779,13 @@ static ErrCode init(void* arg) {
         return RC_MODULE_INIT_FAILURE;
     }
 
+    if(RC_IS_NOTOK(startPoolTrimDaemon())) {
+        return RC_MODULE_INIT_FAILURE;
+    }
+
     // Create the listener thread
     try {
-        resourceTunerListener = std::thread(listenerThreadStartRoutine);
+        resourceTunerListener = std::thread(listenerThreadStart);
         TYPELOGD(LISTENER_THREAD_CREATION_SUCCESS);
 
     } catch(const std::system_error& e) {
@@ -667,18 +816,27 @@ static ErrCode tear(void* arg) {
         TYPELOGV(SYSTEM_THREAD_NOT_JOINABLE, "resource-tuner");
     }
 
+    // Complete the pending Resource writes, before restoring the Original Values
+    CocoTable::getInstance()->stopAppliers();
+
     // Restore all the Resources to Original Values
     ResourceRegistry::getInstance()->restoreResourcesToDefaultValues();
 
     stopPulseMonitorDaemon();
     stopClientGarbageCollectorDaemon();
 
+    if(poolTrimTimer != nullptr) {
+        poolTrimTimer->killTimer();
+        FreeBlock<Timer>(poolTrimTimer);
+        poolTrimTimer = nullptr;
+    }
+
     if(RequestReceiver::mRequestsThreadPool != nullptr) {
         delete RequestReceiver::mRequestsThreadPool;
     }
 
-    if(Timer::mTimerThreadPool != nullptr) {
-        delete Timer::mTimerThreadPool;
+    if(TimerWheel::getInstance() != nullptr) {
+        TimerWheel::getInstance()->stop();
     }
 
     // Delete the Sysfs Persistent File
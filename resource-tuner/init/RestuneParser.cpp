@@ -38,6 +38,17 @@
         break;                                                  \
     }
 
+#define ADD_TO_THREAD_CONFIG_BUILDER(KEY, METHOD)               \
+    if(topKey == KEY && threadConfigBuilder != nullptr) {       \
+        if(RC_IS_OK(rc)) {                                      \
+            rc = threadConfigBuilder->METHOD(value);            \
+            if(RC_IS_NOTOK(rc)) {                               \
+                TYPELOGV(INV_ATTR_VAL, KEY, value.c_str());     \
+            }                                                   \
+        }                                                       \
+        break;                                                  \
+    }
+
 
 #define ADD_TO_SIGNAL_BUILDER(KEY, METHOD)                      \
     if(topKey == KEY && signalInfoBuilder != nullptr) {         \
@@ -104,6 +115,14 @@ static int8_t isKey(const std::string& keyName) {
         INIT_CONFIGS_ELEM_CACHE_INFO_TYPE,
         INIT_CONFIGS_ELEM_CACHE_INFO_BLK_CNT,
         INIT_CONFIGS_ELEM_CACHE_INFO_PRIO_AWARE,
+        INIT_CONFIGS_ELEM_THREAD_CONFIGS_LIST,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_NAME,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_CPU_SET,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_POLICY,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_PRIORITY,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_NICE,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MIN,
+        INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MAX,
         INIT_CONFIGS_IRQ_CONFIGS_LIST,
         INIT_CONFIG_IRQ_AFFINE_TO_CLUSTER,
         INIT_CONFIG_IRQ_AFFINE_ONE,
@@ -156,6 +175,7 @@ static int8_t isKeyTypeList(const std::string& keyName) {
     if(keyName == INIT_CONFIGS_ELEM_CGROUPS_LIST) return true;
     if(keyName == INIT_CONFIGS_ELEM_MPAM_GROUPS_LIST) return true;
     if(keyName == INIT_CONFIGS_ELEM_CACHE_INFO_LIST) return true;
+    if(keyName == INIT_CONFIGS_ELEM_THREAD_CONFIGS_LIST) return true;
 
     if(keyName == INIT_CONFIGS_IRQ_CONFIGS_LIST) return true;
     if(keyName == INIT_CONFIG_IRQ_AFFINE_TO_CLUSTER) return true;
@@ -485,6 +505,7 @@ ErrCode RestuneParser::parseInitConfigYamlNode(const std::string& filePath) {
     CGroupConfigInfoBuilder* cGroupConfigBuilder = nullptr;
     MpamGroupConfigInfoBuilder* mpamGroupConfigBuilder = nullptr;
     CacheInfoBuilder* cacheInfoBuilder = nullptr;
+    ThreadConfigInfoBuilder* threadConfigBuilder = nullptr;
 
     while(!parsingDone) {
         if(!yaml_parser_parse(&parser, &event)) {
@@ -577,6 +598,12 @@ ErrCode RestuneParser::parseInitConfigYamlNode(const std::string& filePath) {
                         if(cacheInfoBuilder == nullptr) {
                             return RC_MEMORY_ALLOCATION_FAILURE;
                         }
+
+                    } else if(topKey == INIT_CONFIGS_ELEM_THREAD_CONFIGS_LIST) {
+                        threadConfigBuilder = new(std::nothrow) ThreadConfigInfoBuilder;
+                        if(threadConfigBuilder == nullptr) {
+                            return RC_MEMORY_ALLOCATION_FAILURE;
+                        }
                     }
                 }
 
@@ -621,6 +648,26 @@ ErrCode RestuneParser::parseInitConfigYamlNode(const std::string& filePath) {
                     delete cacheInfoBuilder;
                     cacheInfoBuilder = nullptr;
 
+                } else if(topKey == INIT_CONFIGS_ELEM_THREAD_CONFIGS_LIST) {
+                    if(RC_IS_OK(rc)) {
+                        rc = threadConfigBuilder->validate();
+                        if(RC_IS_NOTOK(rc)) {
+                            LOGE("RESTUNE_CONFIG_PROCESSOR",
+                                 "Thread Config Priority must be in [1, 99] for SCHED_FIFO and SCHED_RR, "\
+                                 "and 0 for the other policies");
+                        }
+                    }
+
+                    if(RC_IS_NOTOK(rc)) {
+                        // Drop the config, the thread class keeps its default attributes
+                        threadConfigBuilder->setName("");
+                    }
+
+                    TargetRegistry::getInstance()->addThreadConfigMapping(threadConfigBuilder->build());
+
+                    delete threadConfigBuilder;
+                    threadConfigBuilder = nullptr;
+
                 }
 
                 break;
@@ -657,6 +704,14 @@ ErrCode RestuneParser::parseInitConfigYamlNode(const std::string& filePath) {
                 ADD_TO_CACHE_INFO_BUILDER(INIT_CONFIGS_ELEM_CACHE_INFO_BLK_CNT, setNumBlocks);
                 ADD_TO_CACHE_INFO_BUILDER(INIT_CONFIGS_ELEM_CACHE_INFO_PRIO_AWARE, setPriorityAware);
 
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_NAME, setName);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_CPU_SET, setCpuSet);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_POLICY, setSchedPolicy);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_PRIORITY, setPriority);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_NICE, setNice);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MIN, setUclampMin);
+                ADD_TO_THREAD_CONFIG_BUILDER(INIT_CONFIGS_ELEM_THREAD_CONFIG_UCLAMP_MAX, setUclampMax);
+
                 if(topKey == INIT_CONFIG_IRQ_AFFINE_TO_CLUSTER ||
                    topKey == INIT_CONFIG_IRQ_AFFINE_ONE ||
                    topKey == INIT_CONFIG_LOGGING_CONF) {
@@ -298,7 +298,7 @@ ErrCode submitSignalRequest(void* msg) {
     if(RC_IS_OK(opStatus)) {
         try {
             signal = MPLACED(Signal);
-            opStatus = signal->deserialize(info->mBuffer);
+            opStatus = signal->deserialize(info->mBuffer, info->mBufferSize);
             if(RC_IS_NOTOK(opStatus)) {
                 Signal::cleanUpSignal(signal);
             }
@@ -318,8 +318,7 @@ ErrCode submitSignalRequest(void* msg) {
     }
 
     if(info != nullptr) {
-        FreeBlock<char[REQ_BUFFER_SIZE]>(info->mBuffer);
-        FreeBlock<MsgForwardInfo>(info);
+        AuxRoutines::freeMsgForwardInfo(info);
     }
 
     return RC_SUCCESS;
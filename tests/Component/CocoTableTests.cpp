@@ -1,8 +1,16 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <new>
+#include <atomic>
+#include <cstdlib>
+
 #include "TestUtils.h"
 #include "CocoTable.h"
+#include "RequestQueue.h"
+#include "RequestManager.h"
+#include "ClientDataManager.h"
+#include "NodeShadowCache.h"
 #include "URMTests.h"
 
 #define TEST_CLASS "COMPONENT"
@@ -23,3 +31,509 @@ URM_TEST(TestCocoTableInsertRequest3, {
     E_ASSERT((CocoTable::getInstance()->insertRequest(request) == false));
     delete request;
 })
+
+static ResIterable* createSlotNode(int32_t value) {
+    Resource* resource = new Resource;
+    resource->setResCode(0x00030000);
+    resource->setNumValues(1);
+    resource->setValueAt(0, value);
+
+    ResIterable* resIter = new ResIterable;
+    resIter->mData = resource;
+    return resIter;
+}
+
+static void destroySlotNodes(std::vector<ResIterable*>& nodes) {
+    for(ResIterable* resIter: nodes) {
+        delete resIter->mData;
+        delete resIter;
+    }
+    nodes.clear();
+}
+
+URM_TEST(TestCocoSlotHigherBetterOrdering, {
+    CocoSlot slot(HIGHER_BETTER);
+    std::vector<ResIterable*> nodes;
+
+    // Values: 0, 7, 14, ... (mod 500), inserted out of order
+    for(int32_t i = 0; i < 500; i++) {
+        nodes.push_back(createSlotNode((i * 7) % 500));
+        slot.insert(nodes.back());
+    }
+    E_ASSERT((slot.getSize() == 500));
+    E_ASSERT((slot.peek()->mData->getValueAt(0) == 499));
+
+    // Remove every other node (by handle), the winner must always be the max among the remaining
+    for(int32_t i = 0; i < 500; i += 2) {
+        slot.remove(nodes[i]);
+    }
+    E_ASSERT((slot.getSize() == 250));
+    E_ASSERT((nodes[0]->mSlotPos == -1));
+
+    int32_t prevValue = INT32_MAX;
+    while(slot.peek() != nullptr) {
+        ResIterable* winner = slot.peek();
+        E_ASSERT((winner->mData->getValueAt(0) <= prevValue));
+        prevValue = winner->mData->getValueAt(0);
+        E_ASSERT((slot.remove(winner) == true));
+    }
+    E_ASSERT((slot.getSize() == 0));
+
+    destroySlotNodes(nodes);
+})
+
+URM_TEST(TestCocoSlotPolicyTieBreaks, {
+    std::vector<ResIterable*> nodes;
+    for(int32_t i = 0; i < 3; i++) {
+        nodes.push_back(createSlotNode(100));
+    }
+
+    // Equal values, the earliest insertion wins
+    CocoSlot lowerBetter(LOWER_BETTER);
+    E_ASSERT((lowerBetter.insert(nodes[0]) == true));
+    E_ASSERT((lowerBetter.insert(nodes[1]) == false));
+    E_ASSERT((lowerBetter.remove(nodes[1]) == false));
+    E_ASSERT((lowerBetter.remove(nodes[0]) == true));
+
+    // The latest insertion wins
+    CocoSlot instantApply(INSTANT_APPLY);
+    for(ResIterable* resIter: nodes) {
+        E_ASSERT((instantApply.insert(resIter) == true));
+    }
+    E_ASSERT((instantApply.remove(nodes[2]) == true));
+    E_ASSERT((instantApply.peek() == nodes[1]));
+    E_ASSERT((instantApply.remove(nodes[1]) == true));
+    E_ASSERT((instantApply.remove(nodes[0]) == true));
+
+    // First-in-first-out
+    CocoSlot lazyApply(LAZY_APPLY);
+    for(ResIterable* resIter: nodes) {
+        lazyApply.insert(resIter);
+    }
+    E_ASSERT((lazyApply.peek() == nodes[0]));
+    E_ASSERT((lazyApply.remove(nodes[1]) == false));
+    E_ASSERT((lazyApply.remove(nodes[0]) == true));
+    E_ASSERT((lazyApply.peek() == nodes[2]));
+    lazyApply.remove(nodes[2]);
+
+    destroySlotNodes(nodes);
+})
+
+static std::mutex shardRecordLock;
+static std::vector<std::vector<int32_t>> shardRecords(8);
+
+static void recordShardWrite(void* context) {
+    Resource* resource = static_cast<Resource*>(context);
+    const std::lock_guard<std::mutex> lock(shardRecordLock);
+    shardRecords[resource->getResCode()].push_back(resource->getValueAt(0));
+}
+
+URM_TEST(TestApplierShardsPerResourceOrdering, {
+    ApplierShards applierShards(4);
+    Resource resource;
+    resource.setNumValues(1);
+
+    for(int32_t i = 0; i < 1000; i++) {
+        int32_t key = i % 8;
+        resource.setResCode(key);
+        resource.setValueAt(0, i);
+        applierShards.dispatch(key, recordShardWrite, &resource);
+    }
+    applierShards.drain();
+    E_ASSERT((applierShards.getDispatchedCount() == 1000));
+
+    // Writes for each key are performed in the order in which they were issued
+    for(int32_t key = 0; key < 8; key++) {
+        E_ASSERT((shardRecords[key].size() == 125));
+        for(size_t i = 1; i < shardRecords[key].size(); i++) {
+            E_ASSERT((shardRecords[key][i] > shardRecords[key][i - 1]));
+        }
+        shardRecords[key].clear();
+    }
+
+    // Once stopped, the writes are performed inline
+    applierShards.stop();
+    resource.setResCode(0);
+    applierShards.dispatch(0, recordShardWrite, &resource);
+    E_ASSERT((shardRecords[0].size() == 1));
+    E_ASSERT((applierShards.getDispatchedCount() == 1000));
+    shardRecords[0].clear();
+})
+
+URM_TEST(TestNodeShadowCacheSuppression, {
+    std::shared_ptr<NodeShadowCache> nodeShadowCache = NodeShadowCache::getInstance();
+    uint32_t savedValidity = UrmSettings::metaConfigs.mNodeShadowValidity;
+    std::string nodePath = "/etc/urm/tests/nodes/shadow_cache_test.txt";
+
+    UrmSettings::metaConfigs.mNodeShadowValidity = 5000;
+    int64_t issued = nodeShadowCache->getIssuedWriteCount();
+    int64_t suppressed = nodeShadowCache->getSuppressedWriteCount();
+
+    // Only a successfully written value is shadowed
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == false));
+    nodeShadowCache->update(nodePath, "300");
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == true));
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "400") == false));
+    E_ASSERT((nodeShadowCache->getIssuedWriteCount() == issued + 2));
+    E_ASSERT((nodeShadowCache->getSuppressedWriteCount() == suppressed + 1));
+
+    // Writes to a node are always serialized by the same lock
+    E_ASSERT((&nodeShadowCache->getNodeLock(nodePath) == &nodeShadowCache->getNodeLock(nodePath)));
+
+    nodeShadowCache->invalidate(nodePath);
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == false));
+
+    nodeShadowCache->update(nodePath, "300");
+    nodeShadowCache->invalidateAll();
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == false));
+
+    // The shadowed value is no longer trusted once the validity interval elapses
+    UrmSettings::metaConfigs.mNodeShadowValidity = 20;
+    nodeShadowCache->update(nodePath, "300");
+    std::this_thread::sleep_for(std::chrono::milliseconds(40));
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == false));
+
+    // Disabled
+    UrmSettings::metaConfigs.mNodeShadowValidity = 0;
+    nodeShadowCache->update(nodePath, "300");
+    E_ASSERT((nodeShadowCache->isWriteRedundant(nodePath, "300") == false));
+
+    nodeShadowCache->invalidateAll();
+    UrmSettings::metaConfigs.mNodeShadowValidity = savedValidity;
+})
+
+#define TEST_RES_CODE 0x00ff0000
+#define TEST_CLIENT_ID 7321
+
+static std::mutex writeRecordLock;
+static std::vector<int32_t> writeRecords; // Applied value, or -1 for a Tear
+
+static void recordApplierWrite(void* context) {
+    Resource* resource = static_cast<Resource*>(context);
+    const std::lock_guard<std::mutex> lock(writeRecordLock);
+    writeRecords.push_back(resource->getValueAt(0));
+}
+
+static void recordTearWrite(void* context) {
+    (void)context;
+    const std::lock_guard<std::mutex> lock(writeRecordLock);
+    writeRecords.push_back(-1);
+}
+
+static void InitCocoRequests() {
+    static int8_t initDone = false;
+    if(!initDone) {
+        initDone = true;
+
+        MakeAlloc<ClientInfo> (8);
+        MakeAlloc<ClientTidData> (8);
+        MakeAlloc<std::unordered_set<int64_t>> (8);
+        MakeAlloc<Message> (8);
+        MakeAlloc<Request> (16);
+        MakeAlloc<Resource> (16);
+        MakeAlloc<ResIterable> (16);
+        MakeAlloc<DLManager> (16);
+        MakeAlloc<Timer> (16);
+    }
+
+    writeRecords.clear();
+    writeRecords.reserve(64);
+}
+
+static Request* createCocoRequest(int64_t handle, int32_t value, int64_t duration) {
+    Resource* resource = MPLACED(Resource);
+    resource->setResCode(TEST_RES_CODE);
+    resource->setNumValues(1);
+    resource->setValueAt(0, value);
+
+    ResIterable* resIterable = MPLACED(ResIterable);
+    resIterable->mData = resource;
+
+    Request* request = MPLACED(Request);
+    request->setRequestType(REQ_RESOURCE_TUNING);
+    request->setHandle(handle);
+    request->setDuration(duration);
+    request->setPriority(SYSTEM_HIGH);
+    request->setClientPID(TEST_CLIENT_ID);
+    request->setClientTID(TEST_CLIENT_ID);
+    request->setBackgroundProcessing(false);
+    request->addResource(resIterable);
+    return request;
+}
+
+// Requests expiring together must only wake up the RequestQueue once, and be
+// removed from the CocoTable in a single pass, i.e. with a single Tear.
+URM_TEST(TestCocoTableExpiryBatching, {
+    InitCocoRequests();
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
+    std::shared_ptr<RequestQueue> requestQueue = RequestQueue::getInstance();
+    std::shared_ptr<RequestManager> requestManager = RequestManager::getInstance();
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+
+    ResConfInfo* resConf = ResourceRegistry::getInstance()->getResConf(TEST_RES_CODE);
+    E_ASSERT((resConf != nullptr));
+
+    MetaConfigs savedMetaConfigs = UrmSettings::metaConfigs;
+    int8_t savedMode = UrmSettings::targetConfigs.currMode;
+    ResourceLifecycleCallback savedApplier = resConf->mResourceApplierCallback;
+    ResourceLifecycleCallback savedTear = resConf->mResourceTearCallback;
+
+    UrmSettings::metaConfigs.mExpiryBatching = true;
+    UrmSettings::metaConfigs.mWritePlan = false;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = 16;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+    resConf->mResourceApplierCallback = recordApplierWrite;
+    resConf->mResourceTearCallback = recordTearWrite;
+
+    if(!clientDataManager->clientExists(TEST_CLIENT_ID, TEST_CLIENT_ID)) {
+        clientDataManager->createNewClient(TEST_CLIENT_ID, TEST_CLIENT_ID);
+    }
+
+    // Higher is better, every Request is applied on insertion
+    std::vector<int64_t> handles = {9001, 9002, 9003, 9004};
+    for(size_t i = 0; i < handles.size(); i++) {
+        Request* request = createCocoRequest(handles[i], 100 * (i + 1), 50);
+        E_ASSERT((requestManager->addRequest(request) == true));
+        requestManager->markRequestAsComplete(request->getHandle());
+        E_ASSERT((cocoTable->insertRequest(request) == true));
+    }
+    E_ASSERT((writeRecords.size() == 4));
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(300));
+
+    // A single trigger is queued for all the expired Requests
+    std::vector<Message*> batch;
+    while(requestQueue->hasPendingTasks()) {
+        batch.push_back((Message*)requestQueue->pop());
+    }
+    E_ASSERT((batch.size() == 1));
+    E_ASSERT((dynamic_cast<Request*>(batch[0]) == nullptr));
+
+    requestQueue->orderedQueueBatchHook(batch);
+
+    E_ASSERT((writeRecords.size() == 5));
+    E_ASSERT((writeRecords.back() == -1));
+    for(int64_t handle: handles) {
+        E_ASSERT((requestManager->getRequestFromMap(handle).first == nullptr));
+    }
+
+    // The next expiry queues a new trigger
+    Request* request = createCocoRequest(9005, 100, 20);
+    E_ASSERT((requestManager->addRequest(request) == true));
+    requestManager->markRequestAsComplete(request->getHandle());
+    E_ASSERT((cocoTable->insertRequest(request) == true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    batch.clear();
+    while(requestQueue->hasPendingTasks()) {
+        batch.push_back((Message*)requestQueue->pop());
+    }
+    E_ASSERT((batch.size() == 1));
+    requestQueue->orderedQueueBatchHook(batch);
+    E_ASSERT((requestManager->getRequestFromMap(9005).first == nullptr));
+
+    clientDataManager->deleteClientPID(TEST_CLIENT_ID);
+    clientDataManager->deleteClientTID(TEST_CLIENT_ID);
+    resConf->mResourceApplierCallback = savedApplier;
+    resConf->mResourceTearCallback = savedTear;
+    UrmSettings::targetConfigs.currMode = savedMode;
+    UrmSettings::metaConfigs = savedMetaConfigs;
+})
+
+// A Request retuned after expiring is either batched twice (if its new timer fires
+// before the batch is processed), or must not be removed (if it is yet to fire).
+URM_TEST(TestCocoTableExpiryBatchingRetune, {
+    InitCocoRequests();
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
+    std::shared_ptr<RequestQueue> requestQueue = RequestQueue::getInstance();
+    std::shared_ptr<RequestManager> requestManager = RequestManager::getInstance();
+    std::shared_ptr<ClientDataManager> clientDataManager = ClientDataManager::getInstance();
+
+    ResConfInfo* resConf = ResourceRegistry::getInstance()->getResConf(TEST_RES_CODE);
+    E_ASSERT((resConf != nullptr));
+
+    MetaConfigs savedMetaConfigs = UrmSettings::metaConfigs;
+    int8_t savedMode = UrmSettings::targetConfigs.currMode;
+    ResourceLifecycleCallback savedApplier = resConf->mResourceApplierCallback;
+    ResourceLifecycleCallback savedTear = resConf->mResourceTearCallback;
+
+    UrmSettings::metaConfigs.mExpiryBatching = true;
+    UrmSettings::metaConfigs.mWritePlan = false;
+    UrmSettings::metaConfigs.mMaxConcurrentRequests = 16;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+    resConf->mResourceApplierCallback = recordApplierWrite;
+    resConf->mResourceTearCallback = recordTearWrite;
+
+    if(!clientDataManager->clientExists(TEST_CLIENT_ID, TEST_CLIENT_ID)) {
+        clientDataManager->createNewClient(TEST_CLIENT_ID, TEST_CLIENT_ID);
+    }
+
+    Request* expiredTwice = createCocoRequest(9201, 100, 50);
+    Request* extended = createCocoRequest(9202, 200, 50);
+    for(Request* request: {expiredTwice, extended}) {
+        E_ASSERT((requestManager->addRequest(request) == true));
+        requestManager->markRequestAsComplete(request->getHandle());
+        E_ASSERT((cocoTable->insertRequest(request) == true));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+    E_ASSERT((cocoTable->updateRequest(expiredTwice, 60) == true));
+    E_ASSERT((cocoTable->updateRequest(extended, 10000) == true));
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    std::vector<Message*> batch;
+    while(requestQueue->hasPendingTasks()) {
+        batch.push_back((Message*)requestQueue->pop());
+    }
+    E_ASSERT((batch.size() == 1));
+    requestQueue->orderedQueueBatchHook(batch);
+
+    // The twice expired Request is removed once, the extended one is left untouched
+    E_ASSERT((requestManager->getRequestFromMap(9201).first == nullptr));
+    E_ASSERT((requestManager->getRequestFromMap(9202).first == extended));
+    E_ASSERT((writeRecords == std::vector<int32_t>{100, 200}));
+
+    cocoTable->removeRequest(extended);
+    requestManager->removeRequest(extended);
+    Request::cleanUpRequest(extended);
+    E_ASSERT((writeRecords.back() == -1));
+
+    clientDataManager->deleteClientPID(TEST_CLIENT_ID);
+    clientDataManager->deleteClientTID(TEST_CLIENT_ID);
+    resConf->mResourceApplierCallback = savedApplier;
+    resConf->mResourceTearCallback = savedTear;
+    UrmSettings::targetConfigs.currMode = savedMode;
+    UrmSettings::metaConfigs = savedMetaConfigs;
+})
+
+// Allocations are made to fail on demand, in order to exercise the bad_alloc paths.
+// Once armed, only the next allocation of the given size fails.
+static std::atomic<size_t> failingAllocSize(0);
+
+void* operator new(size_t size) {
+    size_t armedSize = failingAllocSize.load(std::memory_order_relaxed);
+    if(armedSize != 0 && armedSize == size && failingAllocSize.compare_exchange_strong(armedSize, 0)) {
+        throw std::bad_alloc();
+    }
+
+    void* block = std::malloc(size == 0 ? 1 : size);
+    if(block == nullptr) {
+        throw std::bad_alloc();
+    }
+    return block;
+}
+
+void operator delete(void* block) noexcept {
+    std::free(block);
+}
+
+void operator delete(void* block, size_t size) noexcept {
+    (void)size;
+    std::free(block);
+}
+
+static void releaseCocoRequests(const std::vector<Request*>& requests) {
+    CocoTable::getInstance()->removeRequests(requests);
+    for(Request* request: requests) {
+        Request::cleanUpRequest(request);
+    }
+}
+
+// Writes issued while a Write Plan is open are coalesced per Resource instance, and the
+// net write is performed on commit. A write is only dropped if it duplicates the planned one.
+URM_TEST(TestCocoTableWritePlan, {
+    InitCocoRequests();
+    std::shared_ptr<CocoTable> cocoTable = CocoTable::getInstance();
+
+    ResConfInfo* resConf = ResourceRegistry::getInstance()->getResConf(TEST_RES_CODE);
+    E_ASSERT((resConf != nullptr));
+
+    MetaConfigs savedMetaConfigs = UrmSettings::metaConfigs;
+    int8_t savedMode = UrmSettings::targetConfigs.currMode;
+    ResourceLifecycleCallback savedApplier = resConf->mResourceApplierCallback;
+    ResourceLifecycleCallback savedTear = resConf->mResourceTearCallback;
+
+    UrmSettings::metaConfigs.mWritePlan = true;
+    UrmSettings::targetConfigs.currMode = MODE_RESUME;
+    resConf->mResourceApplierCallback = recordApplierWrite;
+    resConf->mResourceTearCallback = recordTearWrite;
+
+    int64_t coalesced = cocoTable->getCoalescedWriteCount();
+    int64_t suppressed = cocoTable->getPlanSuppressedWriteCount();
+
+    // Only the last of the writes to the instance is performed
+    Request* first = createCocoRequest(9101, 300, -1);
+    Request* second = createCocoRequest(9102, 400, -1);
+    cocoTable->beginWritePlan();
+    E_ASSERT((cocoTable->insertRequest(first) == true));
+    E_ASSERT((cocoTable->insertRequest(second) == true));
+    E_ASSERT((writeRecords.size() == 0));
+    cocoTable->commitWritePlan();
+
+    E_ASSERT((writeRecords == std::vector<int32_t>{400}));
+    E_ASSERT((cocoTable->getCoalescedWriteCount() == coalesced + 1));
+    E_ASSERT((cocoTable->getPlanSuppressedWriteCount() == suppressed));
+
+    // Equal values do not displace the applied Request, hence nothing is written
+    Request* third = createCocoRequest(9103, 400, -1);
+    Request* fourth = createCocoRequest(9104, 400, -1);
+    E_ASSERT((cocoTable->insertRequest(third) == true));
+    E_ASSERT((cocoTable->insertRequest(fourth) == true));
+    E_ASSERT((writeRecords.size() == 1));
+
+    // A write duplicating the planned one is dropped. The instance is written again, although
+    // the previous plan wrote the same value, since the node may no longer hold it.
+    cocoTable->beginWritePlan();
+    releaseCocoRequests({second});
+    releaseCocoRequests({third});
+    cocoTable->commitWritePlan();
+
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400}));
+    E_ASSERT((cocoTable->getCoalescedWriteCount() == coalesced + 1));
+    E_ASSERT((cocoTable->getPlanSuppressedWriteCount() == suppressed + 1));
+
+    // Reapplying the remaining Request and then removing it coalesces into a single Tear
+    cocoTable->beginWritePlan();
+    releaseCocoRequests({fourth});
+    releaseCocoRequests({first});
+    cocoTable->commitWritePlan();
+
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400, -1}));
+    E_ASSERT((cocoTable->getCoalescedWriteCount() == coalesced + 2));
+
+    // A Tear following a Tear is performed as well
+    Request* transient = createCocoRequest(9105, 500, -1);
+    cocoTable->beginWritePlan();
+    E_ASSERT((cocoTable->insertRequest(transient) == true));
+    releaseCocoRequests({transient});
+    cocoTable->commitWritePlan();
+
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400, -1, -1}));
+    E_ASSERT((cocoTable->getCoalescedWriteCount() == coalesced + 3));
+    E_ASSERT((cocoTable->getPlanSuppressedWriteCount() == suppressed + 1));
+
+    // If the write cannot be recorded, it is issued right away,
+    // and the write planned earlier for the instance is dropped.
+    Request* planned = createCocoRequest(9106, 600, -1);
+    Request* unplanned = createCocoRequest(9107, 700, -1);
+    cocoTable->beginWritePlan();
+    E_ASSERT((cocoTable->insertRequest(planned) == true));
+    failingAllocSize.store(sizeof(Resource));
+    E_ASSERT((cocoTable->insertRequest(unplanned) == true));
+    E_ASSERT((failingAllocSize.load() == 0));
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400, -1, -1, 700}));
+    cocoTable->commitWritePlan();
+
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400, -1, -1, 700}));
+    E_ASSERT((cocoTable->getCoalescedWriteCount() == coalesced + 3));
+    E_ASSERT((cocoTable->getPlanSuppressedWriteCount() == suppressed + 1));
+
+    // Outside of a plan, every write is performed as soon as it is issued
+    releaseCocoRequests({unplanned, planned});
+    E_ASSERT((writeRecords == std::vector<int32_t>{400, 400, -1, -1, 700, -1}));
+
+    resConf->mResourceApplierCallback = savedApplier;
+    resConf->mResourceTearCallback = savedTear;
+    UrmSettings::targetConfigs.currMode = savedMode;
+    UrmSettings::metaConfigs = savedMetaConfigs;
+})
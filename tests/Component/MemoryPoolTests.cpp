@@ -1,8 +1,13 @@
 // Copyright (c) Qualcomm Technologies, Inc. and/or its subsidiaries.
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
+#include <thread>
+#include <atomic>
+#include <chrono>
+
 #include "TestUtils.h"
 #include "MemoryPool.h"
+#include "Request.h"
 #include "URMTests.h"
 
 #define TEST_CLASS "COMPONENT"
@@ -243,3 +248,238 @@ URM_TEST(TestMemoryPoolFreeingMemory, {
     FreeBlock<CustomDataType>(static_cast<void*>(customDTObject));
     E_ASSERT((*destructorCalled == true));
 })
+
+// Threads racing to make the first allocation for a type, must end up sharing a single pool.
+URM_TEST(TestMemoryPoolTypedSlotCreation, {
+    struct RaceBuffer {
+        int64_t values[5];
+    };
+
+    int32_t threadCount = 8;
+    std::vector<std::thread> threads;
+    for(int32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([]{
+            MakeAlloc<RaceBuffer>(2);
+        });
+    }
+
+    for(std::thread& th: threads) {
+        th.join();
+    }
+
+    std::vector<void*> blocks;
+    for(int32_t i = 0; i < threadCount * 2; i++) {
+        blocks.push_back(GetBlock<RaceBuffer>());
+        E_ASSERT((blocks.back() != nullptr));
+    }
+
+    void* block = nullptr;
+    try {
+        block = GetBlock<RaceBuffer>();
+    } catch(const std::bad_alloc& e) {}
+    E_ASSERT((block == nullptr));
+
+    for(void* allocatedBlock: blocks) {
+        FreeBlock<RaceBuffer>(allocatedBlock);
+    }
+})
+
+// Pool grows in Slabs of the reserved size upto the ceiling, and the grown
+// Slabs are released once they are no longer needed.
+URM_TEST(TestMemoryPoolSlabGrowth, {
+    MemoryPool pool(64);
+    E_ASSERT((pool.makeAllocation(4, 10) == 4));
+
+    std::vector<void*> blocks;
+    for(int32_t i = 0; i < 10; i++) {
+        void* block = nullptr;
+        try {
+            block = pool.getBlock();
+        } catch(const std::bad_alloc& e) {}
+
+        E_ASSERT((block != nullptr));
+        blocks.push_back(block);
+    }
+    E_ASSERT((pool.getTotalBlockCount() == 10));
+
+    int8_t allocationFailed = false;
+    try {
+        pool.getBlock();
+    } catch(const std::bad_alloc& e) {
+        allocationFailed = true;
+    }
+    E_ASSERT((allocationFailed == true));
+
+    for(void* block: blocks) {
+        pool.freeBlock(block);
+    }
+
+    // The grown Slabs were needed during this period, hence they are retained
+    E_ASSERT((pool.releaseIdleSlabs() == 0));
+
+    // Idle for a complete period, only the reservation is kept
+    E_ASSERT((pool.releaseIdleSlabs() == 6));
+    E_ASSERT((pool.getTotalBlockCount() == 4));
+
+    blocks.clear();
+    for(int32_t i = 0; i < 10; i++) {
+        blocks.push_back(pool.getBlock());
+        E_ASSERT((blocks.back() != nullptr));
+    }
+
+    for(void* block: blocks) {
+        pool.freeBlock(block);
+    }
+})
+
+URM_TEST(TestMemoryPoolSlabGrowthViaMakeAlloc, {
+    MakeAlloc<char[350]>(2, 6);
+
+    std::vector<void*> blocks;
+    for(int32_t i = 0; i < 6; i++) {
+        void* block = nullptr;
+        try {
+            block = GetBlock<char[350]>();
+        } catch(const std::bad_alloc& e) {}
+
+        E_ASSERT((block != nullptr));
+        blocks.push_back(block);
+    }
+
+    void* block = nullptr;
+    try {
+        block = GetBlock<char[350]>();
+    } catch(const std::bad_alloc& e) {}
+    E_ASSERT((block == nullptr));
+
+    for(void* allocatedBlock: blocks) {
+        FreeBlock<char[350]>(allocatedBlock);
+    }
+})
+
+// Blocks cached in the Magazine of a live thread are reclaimed once the shared pool runs dry.
+URM_TEST(TestMemoryPoolMagazineReclaim, {
+    MakeAlloc<char[330]>(8);
+
+    std::atomic<int8_t> blocksCached(false);
+    std::atomic<int8_t> done(false);
+
+    std::thread holder([&]{
+        std::vector<void*> blocks;
+        for(int32_t i = 0; i < 8; i++) {
+            blocks.push_back(GetBlock<char[330]>());
+        }
+        for(void* block: blocks) {
+            FreeBlock<char[330]>(block);
+        }
+
+        blocksCached.store(true);
+        while(!done.load()) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    while(!blocksCached.load()) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    }
+
+    std::vector<void*> blocks;
+    for(int32_t i = 0; i < 8; i++) {
+        void* block = nullptr;
+        try {
+            block = GetBlock<char[330]>();
+        } catch(const std::bad_alloc& e) {}
+
+        E_ASSERT((block != nullptr));
+        blocks.push_back(block);
+    }
+
+    done.store(true);
+    holder.join();
+
+    for(void* block: blocks) {
+        FreeBlock<char[330]>(block);
+    }
+})
+
+// Blocks cached by a thread are returned to the shared pool when the thread exits.
+URM_TEST(TestMemoryPoolMagazineFlushOnExit, {
+    MakeAlloc<char[340]>(MAGAZINE_CAPACITY);
+
+    std::thread worker([&]{
+        std::vector<void*> blocks;
+        for(int32_t i = 0; i < MAGAZINE_CAPACITY; i++) {
+            blocks.push_back(GetBlock<char[340]>());
+        }
+        for(void* block: blocks) {
+            FreeBlock<char[340]>(block);
+        }
+    });
+    worker.join();
+
+    std::vector<void*> blocks;
+    for(int32_t i = 0; i < MAGAZINE_CAPACITY; i++) {
+        blocks.push_back(GetBlock<char[340]>());
+        E_ASSERT((blocks.back() != nullptr));
+    }
+
+    for(void* block: blocks) {
+        FreeBlock<char[340]>(block);
+    }
+})
+
+// Microbenchmark: each thread repeatedly allocates and frees a few Requests.
+// Baseline is a MemoryPool accessed directly, i.e. every call takes the pool lock.
+static int64_t runRequestAllocations(MemoryPool* sharedPool,
+                                     int32_t threadCount,
+                                     int32_t iterations) {
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> threads;
+    for(int32_t t = 0; t < threadCount; t++) {
+        threads.emplace_back([&]{
+            Request* requests[4];
+            for(int32_t i = 0; i < iterations; i++) {
+                for(int32_t j = 0; j < 4; j++) {
+                    if(sharedPool != nullptr) {
+                        requests[j] = new (sharedPool->getBlock()) Request();
+                    } else {
+                        requests[j] = MPLACED(Request);
+                    }
+                }
+
+                for(int32_t j = 0; j < 4; j++) {
+                    if(sharedPool != nullptr) {
+                        requests[j]->~Request();
+                        sharedPool->freeBlock(requests[j]);
+                    } else {
+                        FreeBlock<Request>(requests[j]);
+                    }
+                }
+            }
+        });
+    }
+
+    for(std::thread& th: threads) {
+        th.join();
+    }
+
+    return std::chrono::duration_cast<std::chrono::microseconds>(
+                std::chrono::steady_clock::now() - start).count();
+}
+
+URM_TEST(TestMemoryPoolMagazineThroughput, {
+    int32_t threadCount = 8;
+    int32_t iterations = 50000;
+    int32_t blockCount = threadCount * (MAGAZINE_CAPACITY + 4);
+
+    MemoryPool sharedPool(sizeof(Request));
+    sharedPool.makeAllocation(blockCount);
+    MakeAlloc<Request>(blockCount);
+
+    int64_t sharedUs = runRequestAllocations(&sharedPool, threadCount, iterations);
+    int64_t magazineUs = runRequestAllocations(nullptr, threadCount, iterations);
+
+    std::cout<<LOG_BASE<<threadCount<<" threads x "<<iterations * 4<<" Request allocations, "
+             <<"shared pool: "<<sharedUs<<" us, magazines: "<<magazineUs<<" us"<<std::endl;
+})
@@ -133,3 +133,62 @@ URM_TEST(TestRequestModeAddition, {
     request.addProcessingMode(MODE_DOZE);
     E_ASSERT((request.getProcessingModes() == (MODE_RESUME | MODE_SUSPEND | MODE_DOZE)));
 })
+
+// Encode a Tune Request with a single Resource, at an unaligned offset of buf, as is the
+// case when it is parsed in place out of the listener's receive buffer.
+// Layout: module, type, handle, duration, numResources, properties, pid, tid,
+//         {resCode, resInfo, optionalInfo, numValues, values...} x numResources
+static uint64_t encodeTuneRequestForTesting(char* buf, int32_t numResources) {
+    char* ptr = buf;
+    int8_t header[2] = {MOD_RESTUNE, REQ_RESOURCE_TUNING};
+    int64_t longFields[2] = {7, 5000};
+    int32_t intFields[4] = {numResources, 0, 321, 322};
+    int32_t resFields[5] = {(int32_t)CONSTRUCT_RES_CODE(0x03, 0x0001), 0, 0, 1, 1024};
+
+    memcpy(ptr, header, sizeof(header));
+    ptr += sizeof(header);
+    memcpy(ptr, longFields, sizeof(longFields));
+    ptr += sizeof(longFields);
+    memcpy(ptr, intFields, sizeof(intFields));
+    ptr += sizeof(intFields);
+    memcpy(ptr, resFields, sizeof(resFields));
+    ptr += sizeof(resFields);
+
+    return ptr - buf;
+}
+
+URM_TEST(TestRequestDeserializeInPlace, {
+    MakeAlloc<Request> (4);
+    MakeAlloc<Resource> (4);
+    MakeAlloc<ResIterable> (4);
+    MakeAlloc<DLManager> (4);
+
+    char buf[128];
+    char* msg = buf + 1;
+    uint64_t msgSize = encodeTuneRequestForTesting(msg, 1);
+
+    Request* request = MPLACED(Request);
+    E_ASSERT((RC_IS_OK(request->deserialize(msg, msgSize))));
+    E_ASSERT((request->getRequestType() == REQ_RESOURCE_TUNING));
+    E_ASSERT((request->getDuration() == 5000));
+    E_ASSERT((request->getClientPID() == 321));
+    E_ASSERT((request->getResourcesCount() == 1));
+
+    Resource* resource = ((ResIterable*) request->getResDlMgr()->mHead)->mData;
+    E_ASSERT((resource->getResCode() == CONSTRUCT_RES_CODE(0x03, 0x0001)));
+    E_ASSERT((resource->getValuesCount() == 1));
+    E_ASSERT((resource->getValueAt(0) == 1024));
+    Request::cleanUpRequest(request);
+
+    // Truncated Request
+    request = MPLACED(Request);
+    E_ASSERT((RC_IS_NOTOK(request->deserialize(msg, msgSize - 1))));
+    Request::cleanUpRequest(request);
+
+    // Resource count which the buffer cannot hold, rejected before allocating any Resource
+    msgSize = encodeTuneRequestForTesting(msg, 1000000);
+    request = MPLACED(Request);
+    E_ASSERT((RC_IS_NOTOK(request->deserialize(msg, msgSize))));
+    E_ASSERT((request->getResourcesCount() == 0));
+    Request::cleanUpRequest(request);
+})
@@ -470,6 +470,44 @@ URM_TEST(InitConfigParsingTests, {
         E_ASSERT((videoConfig->mMpamGroupInfoID == 2));
         E_ASSERT((videoConfig->mPriority == 2));
     }
+
+    {
+        ThreadConfigInfo* listenerConfig = &UrmSettings::threadConfigs[THREAD_CLASS_LISTENER];
+        E_ASSERT((listenerConfig->mConfigured == true));
+        E_ASSERT((listenerConfig->mHasCpuSet == true));
+        E_ASSERT((CPU_COUNT(&listenerConfig->mCpuSet) == 3));
+        E_ASSERT((CPU_ISSET(0, &listenerConfig->mCpuSet)));
+        E_ASSERT((CPU_ISSET(1, &listenerConfig->mCpuSet)));
+        E_ASSERT((CPU_ISSET(3, &listenerConfig->mCpuSet)));
+        E_ASSERT((listenerConfig->mSchedPolicy == -1));
+        E_ASSERT((listenerConfig->mHasNice == true));
+        E_ASSERT((listenerConfig->mNice == -5));
+        E_ASSERT((listenerConfig->mUclampMin == -1));
+
+        ThreadConfigInfo* consumerConfig = &UrmSettings::threadConfigs[THREAD_CLASS_CONSUMER];
+        E_ASSERT((consumerConfig->mConfigured == true));
+        E_ASSERT((CPU_COUNT(&consumerConfig->mCpuSet) == 1));
+        E_ASSERT((CPU_ISSET(2, &consumerConfig->mCpuSet)));
+        E_ASSERT((consumerConfig->mSchedPolicy == SCHED_FIFO));
+        E_ASSERT((consumerConfig->mSchedPriority == 10));
+        E_ASSERT((consumerConfig->mHasNice == false));
+        E_ASSERT((consumerConfig->mUclampMin == 512));
+        E_ASSERT((consumerConfig->mUclampMax == 1024));
+
+        // Thread Classes which are not listed retain the default attributes
+        E_ASSERT((UrmSettings::threadConfigs[THREAD_CLASS_WORKER].mConfigured == false));
+        E_ASSERT((UrmSettings::threadConfigs[THREAD_CLASS_TIMER].mConfigured == false));
+    }
+})
+
+URM_TEST(InitConfigThreadPriorityParsingTests, {
+    ErrCode parsingStatus = RC_SUCCESS;
+    RestuneParser configProcessor;
+    parsingStatus = configProcessor.parseInitConfigs("/etc/urm/tests/configs/InitConfigInvalidThreads.yaml");
+
+    // The config is rejected, the Thread Class keeps its default attributes
+    E_ASSERT((parsingStatus != RC_SUCCESS));
+    E_ASSERT((UrmSettings::threadConfigs[THREAD_CLASS_TIMER].mConfigured == false));
 })
 
 URM_TEST(PropertyParsingTests, {
@@ -526,3 +526,204 @@ URM_TEST(TestRequestQueueInvalidPriority, {
 
     E_ASSERT((requestQueue->addAndWakeup(invalidRequest) == false));
 })
+
+// Standalone Queue, used to exercise both the OrderedQueue implementations.
+class IngestTestQueue : public OrderedQueue {
+public:
+    std::atomic<int64_t> mConsumed;
+    std::atomic<int64_t> mPrioritySum;
+
+    IngestTestQueue(OrderedQueueMode queueMode) : OrderedQueue(queueMode) {
+        this->mConsumed.store(0);
+        this->mPrioritySum.store(0);
+    }
+
+    void orderedQueueConsumerHook() {
+        while(this->hasPendingTasks()) {
+            Message* message = this->pop();
+            if(message == nullptr) continue;
+
+            this->mPrioritySum.fetch_add(message->getPriority());
+            this->mConsumed.fetch_add(1);
+        }
+    }
+
+    std::vector<Message*> mLastBatch;
+    std::function<void()> mOnBatch;
+
+    void orderedQueueBatchHook(std::vector<Message*>& batch) {
+        this->mLastBatch = batch;
+        this->mConsumed.fetch_add(batch.size());
+        if(this->mOnBatch) {
+            this->mOnBatch();
+        }
+    }
+};
+
+URM_TEST(TestIngestRingPriorityOrdering, {
+    IngestTestQueue queue(ORDERED_QUEUE_INGEST_RING);
+    E_ASSERT((queue.getQueueMode() == ORDERED_QUEUE_INGEST_RING));
+
+    std::vector<Message> messages(4 * TOTAL_PRIORITIES);
+    for(int32_t i = 0; i < (int32_t)messages.size(); i++) {
+        // Interleave the priorities, lowest priority first
+        messages[i].setPriority(TOTAL_PRIORITIES - 1 - (i % TOTAL_PRIORITIES));
+        E_ASSERT((queue.addAndWakeup(&messages[i]) == true));
+    }
+
+    int8_t lastPriority = SERVER_CLEANUP_TRIGGER_PRIORITY;
+    int32_t popped = 0;
+    while(queue.hasPendingTasks()) {
+        Message* message = queue.pop();
+        E_ASSERT((message != nullptr));
+        E_ASSERT((message->getPriority() >= lastPriority));
+        lastPriority = message->getPriority();
+        popped++;
+    }
+
+    E_ASSERT((popped == (int32_t)messages.size()));
+})
+
+URM_TEST(TestIngestRingOverflow, {
+    IngestTestQueue queue(ORDERED_QUEUE_INGEST_RING);
+
+    // Exceed the capacity of a single Ingest Ring
+    int32_t messageCount = 3 * INGEST_RING_CAPACITY;
+    std::vector<Message> messages(messageCount);
+    for(int32_t i = 0; i < messageCount; i++) {
+        messages[i].setPriority(SYSTEM_LOW);
+        E_ASSERT((queue.addAndWakeup(&messages[i]) == true));
+    }
+
+    // Cleanup trigger must still be served first
+    Message cleanupTrigger;
+    cleanupTrigger.setPriority(SERVER_CLEANUP_TRIGGER_PRIORITY);
+    E_ASSERT((queue.addAndWakeup(&cleanupTrigger) == true));
+
+    E_ASSERT((queue.pop() == &cleanupTrigger));
+
+    int32_t popped = 0;
+    while(queue.hasPendingTasks()) {
+        E_ASSERT((queue.pop() != nullptr));
+        popped++;
+    }
+
+    E_ASSERT((popped == messageCount));
+})
+
+// Contention microbenchmark: many producers enqueue concurrently, while a single
+// consumer drains the Queue through the regular wait / consumer hook path.
+static int64_t runIngestContention(OrderedQueueMode queueMode,
+                                   int32_t producerCount,
+                                   int32_t messagesPerProducer) {
+    IngestTestQueue queue(queueMode);
+    int64_t totalMessages = (int64_t)producerCount * messagesPerProducer;
+
+    std::vector<Message> messages(totalMessages);
+    int64_t expectedPrioritySum = 0;
+    for(int64_t i = 0; i < totalMessages; i++) {
+        messages[i].setPriority(i % TOTAL_PRIORITIES);
+        expectedPrioritySum += i % TOTAL_PRIORITIES;
+    }
+
+    std::thread consumerThread([&]{
+        while(queue.mConsumed.load() < totalMessages) {
+            queue.wait();
+        }
+    });
+
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> producers;
+    for(int32_t p = 0; p < producerCount; p++) {
+        producers.emplace_back([&, p]{
+            int64_t base = (int64_t)p * messagesPerProducer;
+            for(int32_t i = 0; i < messagesPerProducer; i++) {
+                queue.addAndWakeup(&messages[base + i]);
+            }
+        });
+    }
+
+    for(std::thread& producer: producers) {
+        producer.join();
+    }
+    consumerThread.join();
+
+    int64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+                            std::chrono::steady_clock::now() - start).count();
+
+    E_ASSERT((queue.mConsumed.load() == totalMessages));
+    E_ASSERT((queue.mPrioritySum.load() == expectedPrioritySum));
+    E_ASSERT((queue.hasPendingTasks() == false));
+
+    return elapsedUs;
+}
+
+URM_TEST(TestOrderedQueueIngestContention, {
+    int32_t producerCount = 16;
+    int32_t messagesPerProducer = 20000;
+
+    int64_t lockedUs = runIngestContention(ORDERED_QUEUE_LOCKED, producerCount, messagesPerProducer);
+    int64_t ringUs = runIngestContention(ORDERED_QUEUE_INGEST_RING, producerCount, messagesPerProducer);
+
+    std::cout<<LOG_BASE<<producerCount<<" producers x "<<messagesPerProducer<<" messages, "
+             <<"locked: "<<lockedUs<<" us, ingest ring: "<<ringUs<<" us"<<std::endl;
+})
+
+static void testBatchExtraction(OrderedQueueMode queueMode) {
+    IngestTestQueue queue(queueMode);
+
+    std::vector<Message> messages(10);
+    for(int32_t i = 0; i < (int32_t)messages.size(); i++) {
+        messages[i].setPriority(i % TOTAL_PRIORITIES);
+        queue.addAndWakeup(&messages[i]);
+    }
+
+    E_ASSERT((queue.waitForBatch(4) == 4));
+    E_ASSERT((queue.getLastBatchSize() == 4));
+    E_ASSERT((queue.mLastBatch.size() == 4));
+    for(int32_t i = 1; i < 4; i++) {
+        E_ASSERT((queue.mLastBatch[i - 1]->getPriority() <= queue.mLastBatch[i]->getPriority()));
+    }
+
+    E_ASSERT((queue.waitForBatch(16) == 6));
+    E_ASSERT((queue.getLastBatchSize() == 6));
+    E_ASSERT((queue.getAverageBatchSize() == 5.0));
+    E_ASSERT((queue.hasPendingTasks() == false));
+}
+
+URM_TEST(TestOrderedQueueBatchExtraction, {
+    testBatchExtraction(ORDERED_QUEUE_LOCKED);
+    testBatchExtraction(ORDERED_QUEUE_INGEST_RING);
+})
+
+// Producers must be able to enqueue while the consumer is still processing a batch.
+URM_TEST(TestOrderedQueueBatchHookDoesNotBlockProducers, {
+    IngestTestQueue queue(ORDERED_QUEUE_LOCKED);
+    Message first, second;
+    std::atomic<int8_t> producerDone(false);
+
+    queue.mOnBatch = [&]{
+        if(producerDone.load()) return;
+
+        std::thread producer([&]{
+            queue.addAndWakeup(&second);
+            producerDone.store(true);
+        });
+
+        auto start = std::chrono::steady_clock::now();
+        while(!producerDone.load() &&
+              std::chrono::steady_clock::now() - start < std::chrono::seconds(2)) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+
+        producer.join();
+    };
+
+    queue.addAndWakeup(&first);
+    E_ASSERT((queue.waitForBatch(8) == 1));
+    E_ASSERT((producerDone.load() == true));
+
+    E_ASSERT((queue.waitForBatch(8) == 1));
+    E_ASSERT((queue.mLastBatch[0] == &second));
+})
@@ -255,3 +255,203 @@ URM_TEST(TestThreadPoolEnqueueStatusWithExpansion2, {
 	free(ptr);
 	delete threadPool;
 })
+
+// Tests For Work Stealing Mode
+URM_TEST(TestThreadPoolWorkStealingTaskPickup, {
+	ThreadPool* threadPool = new ThreadPool(2, 2, THREAD_POOL_WORK_STEALING);
+	E_ASSERT((threadPool->getPoolMode() == THREAD_POOL_WORK_STEALING));
+
+	int32_t* ptr = (int32_t*) malloc(sizeof(int32_t));
+	*ptr = 11;
+
+	int8_t status = threadPool->enqueueTask(threadPoolTask, (void*)ptr);
+	E_ASSERT((status == true));
+	std::this_thread::sleep_for(std::chrono::seconds(1));
+
+	E_ASSERT((*ptr == 64));
+
+	free(ptr);
+	delete threadPool;
+})
+
+URM_TEST(TestThreadPoolWorkStealingExpansion, {
+	ThreadPool* threadPool = new ThreadPool(1, 2, THREAD_POOL_WORK_STEALING);
+
+	int32_t* ptr = (int32_t*) malloc(sizeof(int32_t));
+	*ptr = 2;
+
+	// First 4 fill up the core thread's quota, the 5th one expands the Pool
+	for(int32_t i = 0; i < 5; i++) {
+		E_ASSERT((threadPool->enqueueTask(threadPoolLongDurationTask, (void*)ptr) == true));
+	}
+
+	std::this_thread::sleep_for(std::chrono::seconds(7));
+	free(ptr);
+	delete threadPool;
+})
+
+static std::atomic<int64_t> completedTasks(0);
+
+static void shortTask(void* arg) {
+	(void)arg;
+	completedTasks.fetch_add(1, std::memory_order_relaxed);
+}
+
+// Each root task fans out child tasks from the worker thread, if the Pool refuses
+// a child (at capacity), it is run inline.
+static void fanOutTask(void* arg) {
+	ThreadPool* threadPool = (ThreadPool*)arg;
+	for(int32_t i = 0; i < 32; i++) {
+		if(!threadPool->enqueueTask(shortTask, nullptr)) {
+			shortTask(nullptr);
+		}
+	}
+	completedTasks.fetch_add(1, std::memory_order_relaxed);
+}
+
+static int64_t runShortTaskThroughput(ThreadPoolMode poolMode,
+                                      void (*task)(void*),
+                                      int64_t rootTasks,
+                                      int64_t expectedTasks) {
+	ThreadPool* threadPool = new ThreadPool(4, 4, poolMode);
+	completedTasks.store(0);
+
+	auto start = std::chrono::steady_clock::now();
+	for(int64_t i = 0; i < rootTasks; i++) {
+		while(!threadPool->enqueueTask(task, (void*)threadPool)) {
+			std::this_thread::yield();
+		}
+	}
+
+	while(completedTasks.load() < expectedTasks &&
+	      std::chrono::steady_clock::now() - start < std::chrono::seconds(60)) {
+		std::this_thread::yield();
+	}
+
+	int64_t elapsedUs = std::chrono::duration_cast<std::chrono::microseconds>(
+							std::chrono::steady_clock::now() - start).count();
+
+	E_ASSERT((completedTasks.load() == expectedTasks));
+	delete threadPool;
+
+	return elapsedUs;
+}
+
+URM_TEST(TestThreadPoolShortTaskThroughput, {
+	int64_t taskCount = 100000;
+	int64_t sharedUs = runShortTaskThroughput(THREAD_POOL_SHARED_QUEUE, shortTask, taskCount, taskCount);
+	int64_t stealingUs = runShortTaskThroughput(THREAD_POOL_WORK_STEALING, shortTask, taskCount, taskCount);
+
+	std::cout<<LOG_BASE<<taskCount<<" external short tasks, shared queue: "<<sharedUs
+	         <<" us, work stealing: "<<stealingUs<<" us"<<std::endl;
+
+	int64_t rootCount = 5000;
+	int64_t fanOutTotal = rootCount * 33;
+	sharedUs = runShortTaskThroughput(THREAD_POOL_SHARED_QUEUE, fanOutTask, rootCount, fanOutTotal);
+	stealingUs = runShortTaskThroughput(THREAD_POOL_WORK_STEALING, fanOutTask, rootCount, fanOutTotal);
+
+	std::cout<<LOG_BASE<<rootCount<<" fan-out tasks (x32 children), shared queue: "<<sharedUs
+	         <<" us, work stealing: "<<stealingUs<<" us"<<std::endl;
+})
+
+// Tests For Priority Lanes
+static std::mutex laneOrderLock;
+static std::vector<int32_t> laneOrder;
+static std::atomic<int8_t> gateOpen(false);
+static std::atomic<int8_t> gateEntered(false);
+
+static void gateTask(void* arg) {
+	(void)arg;
+	gateEntered.store(true);
+	while(!gateOpen.load()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+}
+
+static void recordLaneTask(void* arg) {
+	const std::lock_guard<std::mutex> lock(laneOrderLock);
+	laneOrder.push_back((int32_t)(intptr_t)arg);
+}
+
+// Block the only worker, so that the subsequent tasks are queued up.
+static ThreadPool* createGatedPool(TaskLanePolicy policy, const int32_t weights[TOTAL_TASK_LANES]) {
+	ThreadPool* threadPool = new ThreadPool(1, 1);
+
+	laneOrder.clear();
+	gateOpen.store(false);
+	gateEntered.store(false);
+
+	threadPool->enqueueTask(gateTask, nullptr);
+	while(!gateEntered.load()) {
+		std::this_thread::sleep_for(std::chrono::milliseconds(5));
+	}
+
+	// Configured after the gate task is picked up, so that it does not consume any credits.
+	threadPool->setLanePolicy(policy, weights);
+	return threadPool;
+}
+
+URM_TEST(TestThreadPoolStrictLanes, {
+	ThreadPool* threadPool = createGatedPool(TASK_LANE_STRICT, nullptr);
+
+	for(int32_t i = 0; i < 3; i++) {
+		E_ASSERT((threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_NORMAL, TASK_LANE_NORMAL) == true));
+	}
+	for(int32_t i = 0; i < 2; i++) {
+		E_ASSERT((threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_CRITICAL, TASK_LANE_CRITICAL) == true));
+	}
+
+	gateOpen.store(true);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	std::vector<int32_t> expected = {TASK_LANE_CRITICAL, TASK_LANE_CRITICAL,
+	                                 TASK_LANE_NORMAL, TASK_LANE_NORMAL, TASK_LANE_NORMAL};
+	E_ASSERT((laneOrder == expected));
+
+	delete threadPool;
+})
+
+URM_TEST(TestThreadPoolWeightedLanes, {
+	int32_t weights[TOTAL_TASK_LANES] = {1, 1, 1};
+	ThreadPool* threadPool = createGatedPool(TASK_LANE_WEIGHTED, weights);
+
+	for(int32_t i = 0; i < 3; i++) {
+		E_ASSERT((threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_NORMAL, TASK_LANE_NORMAL) == true));
+	}
+	for(int32_t i = 0; i < 3; i++) {
+		E_ASSERT((threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_CRITICAL, TASK_LANE_CRITICAL) == true));
+	}
+
+	gateOpen.store(true);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	// Lanes are served alternately, the Normal Lane is not starved.
+	std::vector<int32_t> expected = {TASK_LANE_CRITICAL, TASK_LANE_NORMAL,
+	                                 TASK_LANE_CRITICAL, TASK_LANE_NORMAL,
+	                                 TASK_LANE_CRITICAL, TASK_LANE_NORMAL};
+	E_ASSERT((laneOrder == expected));
+
+	delete threadPool;
+})
+
+URM_TEST(TestThreadPoolCriticalLaneHeadroom, {
+	ThreadPool* threadPool = createGatedPool(TASK_LANE_STRICT, nullptr);
+
+	// Saturate the Pool with Normal Lane tasks
+	int32_t accepted = 0;
+	while(threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_NORMAL, TASK_LANE_NORMAL)) {
+		accepted++;
+	}
+	E_ASSERT((accepted == maxLoadPerThread + 1));
+
+	// Critical Lane tasks are still admitted
+	E_ASSERT((threadPool->enqueueTask(recordLaneTask, (void*)(intptr_t)TASK_LANE_CRITICAL, TASK_LANE_CRITICAL) == true));
+
+	gateOpen.store(true);
+	std::this_thread::sleep_for(std::chrono::milliseconds(500));
+
+	E_ASSERT((laneOrder.size() == (size_t)accepted + 1));
+	E_ASSERT((laneOrder[0] == TASK_LANE_CRITICAL));
+
+	delete threadPool;
+})
@@ -2,6 +2,7 @@
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include <cmath>
+#include <dirent.h>
 
 #include "TestUtils.h"
 #include "Timer.h"
@@ -10,8 +11,8 @@
 #define TEST_CLASS "COMPONENT"
 #define TEST_SUBCAT "TIMER"
 
-static std::shared_ptr<ThreadPool> tpoolInstance = std::shared_ptr<ThreadPool> (new ThreadPool(4, 5));
 static std::atomic<int8_t> isFinished;
+static std::atomic<int32_t> expiredCount;
 
 static void afterTimer(void*) {
     isFinished.store(true);
@@ -21,11 +22,31 @@ static void Init() {
     static int8_t initDone = false;
     if(!initDone) {
         initDone = true;
-        Timer::mTimerThreadPool = tpoolInstance.get();
         MakeAlloc<Timer>(10);
     }
 }
 
+static void countExpiry(void*) {
+    expiredCount.fetch_add(1);
+}
+
+static int32_t getThreadCount() {
+    int32_t threadCount = 0;
+    DIR* dir = opendir("/proc/self/task");
+    if(dir == nullptr) {
+        return -1;
+    }
+
+    struct dirent* entry;
+    while((entry = readdir(dir)) != nullptr) {
+        if(entry->d_name[0] != '.') {
+            threadCount++;
+        }
+    }
+    closedir(dir);
+    return threadCount;
+}
+
 static void simulateWork() {
     while(!isFinished.load()){
         std::this_thread::sleep_for(std::chrono::milliseconds(10));
@@ -124,3 +145,70 @@ URM_TEST(RecurringTimerPreMatureKill, {
 
     E_ASSERT_NEAR(dur, 500, 25); //some tolerance
 })
+
+URM_TEST(ManyTimersConstantThreadCount, {
+    Init();
+    const int32_t timerCount = 100000;
+    expiredCount.store(0);
+
+    // Ensure the Timer Wheel is running before taking the baseline
+    Timer* warmUp = new Timer(countExpiry);
+    warmUp->startTimer(10);
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    delete warmUp;
+    expiredCount.store(0);
+
+    int32_t baseThreadCount = getThreadCount();
+    E_ASSERT((baseThreadCount > 0));
+
+    std::vector<Timer*> timers;
+    timers.reserve(timerCount);
+    auto armStart = std::chrono::steady_clock::now();
+    for(int32_t i = 0; i < timerCount; i++) {
+        Timer* timer = new Timer(countExpiry);
+        E_ASSERT((timer->startTimer(2000 + (i % 500)) == true));
+        timers.push_back(timer);
+    }
+
+    std::cout<<LOG_BASE<<"Armed "<<timerCount<<" timers in "
+             <<std::chrono::duration_cast<std::chrono::milliseconds>(
+                    std::chrono::steady_clock::now() - armStart).count()<<" ms"<<std::endl;
+    E_ASSERT((getThreadCount() == baseThreadCount));
+
+    // Cancel every other timer, they should never fire
+    for(int32_t i = 0; i < timerCount; i += 2) {
+        timers[i]->killTimer();
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    while(expiredCount.load() < timerCount / 2) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        auto waited = std::chrono::steady_clock::now() - start;
+        E_ASSERT((waited < std::chrono::seconds(15)));
+    }
+
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    E_ASSERT((expiredCount.load() == timerCount / 2));
+    E_ASSERT((getThreadCount() == baseThreadCount));
+
+    for(Timer* timer: timers) {
+        delete timer;
+    }
+})
+
+URM_TEST(RestartArmedTimer, {
+    Init();
+    Timer* timer = new Timer(afterTimer);
+    isFinished.store(false);
+
+    E_ASSERT((timer != nullptr));
+    auto start = std::chrono::high_resolution_clock::now();
+    timer->startTimer(100);
+    timer->startTimer(300);
+    simulateWork();
+    auto finish = std::chrono::high_resolution_clock::now();
+    auto dur = std::chrono::duration_cast<std::chrono::milliseconds>(finish - start).count();
+
+    E_ASSERT_NEAR(dur, 300, 25); //some tolerance
+    delete timer;
+})
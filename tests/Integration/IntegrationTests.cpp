@@ -2,6 +2,13 @@
 // SPDX-License-Identifier: BSD-3-Clause-Clear
 
 #include <thread>
+#include <poll.h>
+#include <atomic>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <sys/eventfd.h>
 
 #include "Utils.h"
 #include "UrmAPIs.h"
@@ -10,6 +17,8 @@
 #include "TestUtils.h"
 #include "TestBaseline.h"
 #include "UrmPlatformAL.h"
+#include "UrmSettings.h"
+#include "SharedRing.h"
 
 #define TEST_CLASS "INTEGRATION"
 #define TEST_SUBCAT "INTEGRATION"
@@ -113,6 +122,655 @@ URM_TEST(TestPropFetch, {
     E_ASSERT((std::string(buf) == "na"));
 })
 
+/*
+ * Description:
+ * Compare the Request throughput, with a connection per Request (default) and with a
+ * persistent session. getProp is used since it is served directly by the listener,
+ * hence the numbers reflect the transport cost, and the Requests have no side effects.
+ * The results fetched over the persistent session are validated as well.
+ */
+URM_TEST(TestPersistentSessionThroughput, {
+    const int32_t iterations = 5000;
+    char prop[] = "resource_tuner.maximum.concurrent.requests";
+    char buf[64];
+
+    for(int8_t persistent = 0; persistent <= 1; persistent++) {
+        E_ASSERT((setPersistentSession(persistent) == 0));
+
+        auto start = std::chrono::steady_clock::now();
+        for(int32_t i = 0; i < iterations; i++) {
+            memset(buf, 0, sizeof(buf));
+            E_ASSERT((getProp(prop, buf, sizeof(buf), "na") == 0));
+            E_ASSERT((std::string(buf) == "60"));
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double elapsedSec = std::chrono::duration<double>(end - start).count();
+        std::cout<<LOG_BASE<<(persistent ? "Persistent session: " : "Connection per Request: ")
+                 <<(int64_t)(iterations / elapsedSec)<<" requests/sec"<<std::endl;
+    }
+
+    E_ASSERT((setPersistentSession(false) == 0));
+})
+
+/*
+ * Description:
+ * Verify that Tune Requests submitted via the Shared Ring transport receive valid handles, and
+ * compare the submission throughput of untune Requests across the three transports:
+ * a connection per Request, a persistent session and the Shared Ring.
+ * The untune Requests refer to a non-existent handle, hence they are dropped by the server.
+ * The Requests are issued from a separate thread, so that the Rate Limiter penalty incurred
+ * is not carried over to the subsequent tests.
+ */
+URM_TEST(TestSharedRingThroughput, {
+    const int32_t iterations = 5000;
+    int8_t success = true;
+
+    std::thread benchmarkThread([&]() {
+        SysResource resource;
+        memset(&resource, 0, sizeof(SysResource));
+        resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x0002);
+        resource.mNumValues = 1;
+        resource.mResValue.value = 554;
+
+        setRingTransport(true);
+        int64_t handle = tuneResources(1000, 0, 1, &resource);
+        std::cout<<LOG_BASE<<"Handle Returned via Shared Ring: "<<handle<<std::endl;
+        success = (handle > 0) && (untuneResources(handle) == 0);
+        setRingTransport(false);
+
+        const char* modes[] = {"Connection per Request", "Persistent session", "Shared Ring"};
+        for(int32_t mode = 0; mode < 3; mode++) {
+            setPersistentSession(mode == 1);
+            setRingTransport(mode == 2);
+
+            auto start = std::chrono::steady_clock::now();
+            for(int32_t i = 0; i < iterations; i++) {
+                success = success && (untuneResources(INT32_MAX) == 0);
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double elapsedSec = std::chrono::duration<double>(end - start).count();
+            std::cout<<LOG_BASE<<modes[mode]<<": "<<(int64_t)(iterations / elapsedSec)
+                     <<" requests/sec"<<std::endl;
+        }
+
+        setRingTransport(false);
+        setPersistentSession(false);
+    });
+    benchmarkThread.join();
+
+    E_ASSERT((success == true));
+})
+
+/*
+ * Description:
+ * Compare the throughput of small and large Tune Requests over a persistent session, now that
+ * Requests are sent as variable length frames. The large Requests carry 256 Resources, which
+ * would not fit the legacy fixed size (REQ_BUFFER_SIZE) message. The Resources do not exist,
+ * hence the Requests are dropped by the Verifier, however the handle is still returned.
+ * The Requests are issued from a separate thread, so that the Rate Limiter penalty incurred
+ * is not carried over to the subsequent tests. Under such a flood, some of the Requests may be
+ * rejected by the Server's ThreadPool, hence only a majority of the handles are expected to be valid.
+ */
+URM_TEST(TestFramedRequestThroughput, {
+    const int32_t iterations = 2000;
+    const int32_t resourceCounts[] = {1, 256};
+    int32_t handlesReceived = 0;
+
+    std::thread benchmarkThread([&]() {
+        std::vector<SysResource> resources(resourceCounts[1]);
+        for(SysResource& resource: resources) {
+            memset(&resource, 0, sizeof(SysResource));
+            resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x7fff);
+            resource.mNumValues = 1;
+            resource.mResValue.value = 1;
+        }
+
+        setPersistentSession(true);
+        for(int32_t numRes: resourceCounts) {
+            auto start = std::chrono::steady_clock::now();
+            for(int32_t i = 0; i < iterations; i++) {
+                if(tuneResources(1000, 0, numRes, resources.data()) > 0) {
+                    handlesReceived++;
+                }
+            }
+            auto end = std::chrono::steady_clock::now();
+
+            double elapsedSec = std::chrono::duration<double>(end - start).count();
+            std::cout<<LOG_BASE<<numRes<<" Resource(s) per Request: "
+                     <<(int64_t)(iterations / elapsedSec)<<" requests/sec"<<std::endl;
+        }
+        setPersistentSession(false);
+    });
+    benchmarkThread.join();
+
+    E_ASSERT((handlesReceived > iterations));
+})
+
+/*
+ * Description:
+ * Issue Requests via the async APIs, and wait for their completions on the completion fd.
+ * - Verify that the completions carry the tickets returned by the APIs, in order.
+ * - Verify that a valid handle is received for the tune Request, which can then be untuned.
+ * Compare the time taken to issue Tune Requests via the async API (a window at a time), with
+ * that taken via the blocking API (over the Shared Ring). The Resources do not exist, hence the
+ * Requests are dropped by the Verifier. Under such a flood some Requests may be dropped by the
+ * Server (handle -1) as well, hence only the delivery of the completions is verified.
+ * The Requests are issued from a separate thread, so that the Rate Limiter penalty incurred
+ * is not carried over to the subsequent tests.
+ */
+URM_TEST(TestAsyncCompletions, {
+    const int32_t iterations = 2048;
+    const int32_t window = 64;
+    int8_t success = true;
+
+    std::thread benchmarkThread([&]() {
+        int32_t completionFd = urmGetCompletionFd();
+        success = (completionFd >= 0);
+
+        struct pollfd pollInfo;
+        pollInfo.fd = completionFd;
+        pollInfo.events = POLLIN;
+
+        // Wait for the given number of completions, and verify that they are in ticket order.
+        auto reapAll = [&](int64_t firstTicket, int32_t count, int64_t* lastHandle) {
+            UrmCompletion completions[window];
+            int32_t reaped = 0;
+            while(reaped < count) {
+                if(poll(&pollInfo, 1, 2000) <= 0) {
+                    return false;
+                }
+
+                int32_t numReaped = urmReapCompletions(completions, window);
+                if(numReaped < 0) {
+                    return false;
+                }
+
+                for(int32_t i = 0; i < numReaped; i++, reaped++) {
+                    if(completions[i].mTicket != firstTicket + reaped) {
+                        return false;
+                    }
+                    if(lastHandle != nullptr) {
+                        *lastHandle = completions[i].mHandle;
+                    }
+                }
+            }
+            return true;
+        };
+
+        SysResource resource;
+        memset(&resource, 0, sizeof(SysResource));
+        resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x0002);
+        resource.mNumValues = 1;
+        resource.mResValue.value = 554;
+
+        int64_t handle = -1;
+        int64_t ticket = tuneResourcesAsync(1000, 0, 1, &resource);
+        success = success && (ticket > 0) && reapAll(ticket, 1, &handle);
+        std::cout<<LOG_BASE<<"Ticket: "<<ticket<<", Handle Received via Completion: "<<handle<<std::endl;
+        success = success && (handle > 0);
+
+        ticket = untuneResourcesAsync(handle);
+        success = success && (ticket > 0) && reapAll(ticket, 1, nullptr);
+
+        resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x7fff);
+        resource.mResValue.value = 1;
+
+        setRingTransport(true);
+        auto start = std::chrono::steady_clock::now();
+        for(int32_t i = 0; i < iterations; i++) {
+            tuneResources(1000, 0, 1, &resource);
+        }
+        auto end = std::chrono::steady_clock::now();
+        setRingTransport(false);
+
+        double elapsedSec = std::chrono::duration<double>(end - start).count();
+        std::cout<<LOG_BASE<<"Blocking API: "<<(int64_t)(iterations / elapsedSec)
+                 <<" requests/sec"<<std::endl;
+
+        start = std::chrono::steady_clock::now();
+        for(int32_t i = 0; i < iterations; i += window) {
+            int64_t firstTicket = -1;
+            for(int32_t j = 0; j < window; j++) {
+                ticket = tuneResourcesAsync(1000, 0, 1, &resource);
+                firstTicket = (j == 0) ? ticket : firstTicket;
+                success = success && (ticket > 0);
+            }
+            success = reapAll(firstTicket, window, nullptr) && success;
+        }
+        end = std::chrono::steady_clock::now();
+
+        elapsedSec = std::chrono::duration<double>(end - start).count();
+        std::cout<<LOG_BASE<<"Async API (window of "<<window<<"): "
+                 <<(int64_t)(iterations / elapsedSec)<<" requests/sec"<<std::endl;
+    });
+    benchmarkThread.join();
+
+    E_ASSERT((success == true));
+})
+
+/*
+ * Description:
+ * Compare the aggregate throughput of Tune Requests issued by 1, 2 and 4 client threads of the
+ * same process, each over its own persistent session. Since the client threads do not share any
+ * state, the Requests are issued in parallel, and the aggregate throughput is expected to scale
+ * with the number of threads (until the Server or the CPUs are saturated).
+ * The Resources do not exist, hence the Requests are dropped by the Verifier, however the handle
+ * is still returned. The Requests are issued from separate threads, so that the Rate Limiter
+ * penalty incurred is not carried over to the subsequent tests.
+ */
+URM_TEST(TestMultiThreadedClientThroughput, {
+    const int32_t iterations = 4000;
+    const int32_t threadCounts[] = {1, 2, 4};
+    std::atomic<int32_t> handlesReceived(0);
+
+    SysResource resource;
+    memset(&resource, 0, sizeof(SysResource));
+    resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x7fff);
+    resource.mNumValues = 1;
+    resource.mResValue.value = 1;
+
+    setPersistentSession(true);
+    for(int32_t threadCount: threadCounts) {
+        std::vector<std::thread> clientThreads;
+
+        auto start = std::chrono::steady_clock::now();
+        for(int32_t t = 0; t < threadCount; t++) {
+            clientThreads.emplace_back([&]() {
+                SysResource threadResource = resource;
+                for(int32_t i = 0; i < iterations / threadCount; i++) {
+                    if(tuneResources(1000, 0, 1, &threadResource) > 0) {
+                        handlesReceived++;
+                    }
+                }
+            });
+        }
+
+        for(std::thread& clientThread: clientThreads) {
+            clientThread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double elapsedSec = std::chrono::duration<double>(end - start).count();
+        std::cout<<LOG_BASE<<threadCount<<" client thread(s): "
+                 <<(int64_t)(iterations / elapsedSec)<<" requests/sec"<<std::endl;
+    }
+    setPersistentSession(false);
+
+    E_ASSERT((handlesReceived > 0));
+})
+
+/*
+ * Description:
+ * A client which connects to the Server, but stalls before sending its Request, must not hold up
+ * the Requests of the other clients: the client sockets are never waited upon by the listener
+ * threads. The stalled connection is held for 2 seconds, the Tune Request issued in the meantime
+ * is expected to complete well before that.
+ */
+URM_TEST(TestStalledClientDoesNotBlockListener, {
+    int32_t stalledFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    E_ASSERT((stalledFd >= 0));
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, "/run/restune_sock", sizeof(addr.sun_path) - 1);
+    E_ASSERT((connect(stalledFd, (struct sockaddr*)&addr, sizeof(addr)) == 0));
+
+    // Let the Server accept the stalled connection, before the Request is issued.
+    std::this_thread::sleep_for(std::chrono::milliseconds(200));
+
+    SysResource resource;
+    memset(&resource, 0, sizeof(SysResource));
+    resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x7fff);
+    resource.mNumValues = 1;
+    resource.mResValue.value = 1;
+
+    std::atomic<int64_t> elapsedMs(-1);
+    std::thread clientThread([&]() {
+        auto start = std::chrono::steady_clock::now();
+        tuneResources(1000, 0, 1, &resource);
+        auto end = std::chrono::steady_clock::now();
+        elapsedMs = std::chrono::duration_cast<std::chrono::milliseconds>(end - start).count();
+    });
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+    close(stalledFd);
+    clientThread.join();
+
+    std::cout<<LOG_BASE<<"Request served in: "<<elapsedMs<<" ms, while a client was stalled"<<std::endl;
+    E_ASSERT((elapsedMs >= 0 && elapsedMs < 1000));
+})
+
+/*
+ * Description:
+ * Fault injection: the messages are written to the Server one byte at a time, so that every message
+ * is received in fragments. The Server must accumulate the fragments, rather than assuming that a
+ * message arrives in a single read. Covered:
+ * - A legacy (fixed size) Prop Get Request, on a connection carrying a single Request.
+ * - A persistent session, opened via a framed Session Open Request, followed by two pipelined
+ *   framed Prop Get Requests.
+ * The responses must match the property value returned by the getProp API.
+ */
+URM_TEST(TestFragmentedClientWrites, {
+    const char* propName = "urm.logging.level";
+    char expected[64];
+    memset(expected, 0, sizeof(expected));
+    E_ASSERT((getProp(propName, expected, sizeof(expected), "na") == 0));
+    uint64_t expectedLen = strlen(expected);
+
+    auto connectToServer = []() {
+        int32_t fd = socket(AF_UNIX, SOCK_STREAM, 0);
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(sockaddr_un));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, "/run/restune_sock", sizeof(addr.sun_path) - 1);
+        if(fd >= 0 && connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            close(fd);
+            fd = -1;
+        }
+        return fd;
+    };
+
+    auto writeBytewise = [](int32_t fd, const std::vector<char>& msg) {
+        for(char byte: msg) {
+            if(send(fd, &byte, 1, MSG_NOSIGNAL) != 1) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::microseconds(50));
+        }
+        return true;
+    };
+
+    auto readFully = [](int32_t fd, char* buf, size_t size) {
+        size_t received = 0;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        while(received < size && poll(&pfd, 1, 2000) > 0) {
+            ssize_t bytesRead = recv(fd, buf + received, size - received, 0);
+            if(bytesRead <= 0) {
+                break;
+            }
+            received += bytesRead;
+        }
+        return (received == size);
+    };
+
+    // Layout: module, type, client buffer size, property name
+    auto encodePropGet = [&](int8_t framed) {
+        std::vector<char> msg(2 * sizeof(int8_t) + sizeof(uint64_t), 0);
+        msg[0] = MOD_RESTUNE;
+        msg[1] = REQ_PROP_GET;
+        memcpy(msg.data() + 2, &expectedLen, sizeof(uint64_t));
+        msg.insert(msg.end(), propName, propName + strlen(propName) + 1);
+
+        if(!framed) {
+            msg.resize(REQ_BUFFER_SIZE, 0);
+            return msg;
+        }
+
+        uint32_t length = msg.size();
+        std::vector<char> frame(WIRE_FRAME_HEADER_SIZE);
+        frame[0] = (char)WIRE_VERSION_BYTE(WIRE_PROTOCOL_VERSION);
+        memcpy(frame.data() + sizeof(uint8_t), &length, sizeof(uint32_t));
+        frame.insert(frame.end(), msg.begin(), msg.end());
+        return frame;
+    };
+
+    char result[64];
+
+    int32_t fd = connectToServer();
+    E_ASSERT((fd >= 0));
+    E_ASSERT((writeBytewise(fd, encodePropGet(false))));
+    memset(result, 0, sizeof(result));
+    E_ASSERT((readFully(fd, result, expectedLen)));
+    E_ASSERT((strcmp(result, expected) == 0));
+    close(fd);
+
+    fd = connectToServer();
+    E_ASSERT((fd >= 0));
+
+    std::vector<char> sessionOpen(WIRE_FRAME_HEADER_SIZE + 2 * sizeof(int8_t));
+    uint32_t length = 2 * sizeof(int8_t);
+    sessionOpen[0] = (char)WIRE_VERSION_BYTE(WIRE_PROTOCOL_VERSION);
+    memcpy(sessionOpen.data() + sizeof(uint8_t), &length, sizeof(uint32_t));
+    sessionOpen[WIRE_FRAME_HEADER_SIZE] = MOD_RESTUNE;
+    sessionOpen[WIRE_FRAME_HEADER_SIZE + 1] = REQ_SESSION_OPEN;
+
+    int64_t status = 0;
+    E_ASSERT((writeBytewise(fd, sessionOpen)));
+    E_ASSERT((readFully(fd, (char*)&status, sizeof(status))));
+    E_ASSERT((status == 1));
+
+    std::vector<char> pipelined = encodePropGet(true);
+    std::vector<char> second = encodePropGet(true);
+    pipelined.insert(pipelined.end(), second.begin(), second.end());
+    E_ASSERT((writeBytewise(fd, pipelined)));
+
+    for(int32_t i = 0; i < 2; i++) {
+        memset(result, 0, sizeof(result));
+        E_ASSERT((readFully(fd, result, expectedLen)));
+        E_ASSERT((strcmp(result, expected) == 0));
+    }
+    close(fd);
+
+    std::cout<<LOG_BASE<<"Fragmented Requests served, value: "<<expected<<std::endl;
+})
+
+/*
+ * Description:
+ * Frames are variable length, hence a frame may be shorter than the fixed header of its Request type.
+ * Such frames must be rejected without reading past their end. Over a persistent session:
+ * - A Tune Request frame carrying just the module and type is answered with a -1 handle.
+ * - A Prop Get Request frame without the client buffer size and property name is answered with "na".
+ * The session must still serve a well formed Request afterwards.
+ */
+URM_TEST(TestTruncatedFramesRejected, {
+    int32_t fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    E_ASSERT((fd >= 0));
+
+    struct sockaddr_un addr;
+    memset(&addr, 0, sizeof(sockaddr_un));
+    addr.sun_family = AF_UNIX;
+    strncpy(addr.sun_path, "/run/restune_sock", sizeof(addr.sun_path) - 1);
+    E_ASSERT((connect(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0));
+
+    auto encodeFrame = [](const std::vector<char>& payload) {
+        uint32_t length = payload.size();
+        std::vector<char> frame(WIRE_FRAME_HEADER_SIZE);
+        frame[0] = (char)WIRE_VERSION_BYTE(WIRE_PROTOCOL_VERSION);
+        memcpy(frame.data() + sizeof(uint8_t), &length, sizeof(uint32_t));
+        frame.insert(frame.end(), payload.begin(), payload.end());
+        return frame;
+    };
+
+    auto exchange = [&](const std::vector<char>& payload, char* response, size_t size) {
+        std::vector<char> frame = encodeFrame(payload);
+        if(send(fd, frame.data(), frame.size(), MSG_NOSIGNAL) != (ssize_t)frame.size()) {
+            return false;
+        }
+
+        size_t received = 0;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        while(received < size && poll(&pfd, 1, 2000) > 0) {
+            ssize_t bytesRead = recv(fd, response + received, size - received, 0);
+            if(bytesRead <= 0) {
+                break;
+            }
+            received += bytesRead;
+        }
+        return (received == size);
+    };
+
+    int64_t status = 0;
+    E_ASSERT((exchange({MOD_RESTUNE, REQ_SESSION_OPEN}, (char*)&status, sizeof(status))));
+    E_ASSERT((status == 1));
+
+    int64_t handle = 0;
+    E_ASSERT((exchange({MOD_RESTUNE, REQ_RESOURCE_TUNING, 1}, (char*)&handle, sizeof(handle))));
+    E_ASSERT((handle == -1));
+
+    char result[64];
+    memset(result, 0, sizeof(result));
+    E_ASSERT((exchange({MOD_RESTUNE, REQ_PROP_GET, 1}, result, 2)));
+    E_ASSERT((strcmp(result, "na") == 0));
+
+    // Layout: module, type, client buffer size, property name
+    const char* propName = "urm.logging.level";
+    uint64_t clientBufSize = sizeof(result) - 1;
+    std::vector<char> propGet = {MOD_RESTUNE, REQ_PROP_GET};
+    propGet.insert(propGet.end(), (char*)&clientBufSize, (char*)&clientBufSize + sizeof(uint64_t));
+    propGet.insert(propGet.end(), propName, propName + strlen(propName) + 1);
+
+    char expected[64];
+    memset(expected, 0, sizeof(expected));
+    E_ASSERT((getProp(propName, expected, sizeof(expected), "na") == 0));
+
+    memset(result, 0, sizeof(result));
+    E_ASSERT((exchange(propGet, result, strlen(expected))));
+    E_ASSERT((strcmp(result, expected) == 0));
+    close(fd);
+})
+
+/*
+ * Description:
+ * The Shared Ring doorbells are passed by the client, and are read and written by the listener.
+ * - A Ring whose SQ doorbell is not an eventfd (a pipe) must be declined.
+ * - A Ring whose SQ doorbell is a blocking eventfd must be accepted, with the doorbell switched to
+ *   non-blocking mode. The SQ is filled before the Ring is opened, so that the listener serves it
+ *   straight away, which must not block on the (empty) doorbell.
+ * The listener must still serve Requests afterwards.
+ */
+URM_TEST(TestSharedRingDoorbellValidation, {
+    auto openRing = [](int32_t fd, int32_t* fds) {
+        struct sockaddr_un addr;
+        memset(&addr, 0, sizeof(sockaddr_un));
+        addr.sun_family = AF_UNIX;
+        strncpy(addr.sun_path, "/run/restune_sock", sizeof(addr.sun_path) - 1);
+        if(connect(fd, (struct sockaddr*)&addr, sizeof(addr)) != 0) {
+            return (int64_t)-1;
+        }
+
+        char frame[WIRE_FRAME_HEADER_SIZE + 2 * sizeof(int8_t)];
+        uint32_t length = 2 * sizeof(int8_t);
+        frame[0] = (char)WIRE_VERSION_BYTE(WIRE_PROTOCOL_VERSION);
+        memcpy(frame + sizeof(uint8_t), &length, sizeof(uint32_t));
+        frame[WIRE_FRAME_HEADER_SIZE] = MOD_RESTUNE;
+        frame[WIRE_FRAME_HEADER_SIZE + 1] = REQ_RING_OPEN;
+
+        struct iovec iov = {frame, sizeof(frame)};
+        char control[CMSG_SPACE(SHARED_RING_FD_COUNT * sizeof(int32_t))];
+        memset(control, 0, sizeof(control));
+
+        struct msghdr msg;
+        memset(&msg, 0, sizeof(msg));
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control;
+        msg.msg_controllen = sizeof(control);
+
+        struct cmsghdr* cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_SOCKET;
+        cmsg->cmsg_type = SCM_RIGHTS;
+        cmsg->cmsg_len = CMSG_LEN(SHARED_RING_FD_COUNT * sizeof(int32_t));
+        memcpy(CMSG_DATA(cmsg), fds, SHARED_RING_FD_COUNT * sizeof(int32_t));
+        if(sendmsg(fd, &msg, MSG_NOSIGNAL) < 0) {
+            return (int64_t)-1;
+        }
+
+        int64_t status = -1;
+        struct pollfd pfd = {fd, POLLIN, 0};
+        if(poll(&pfd, 1, 2000) <= 0 || recv(fd, &status, sizeof(status), 0) != sizeof(status)) {
+            return (int64_t)-1;
+        }
+        return status;
+    };
+
+    SharedRing ring;
+    E_ASSERT((RC_IS_OK(ring.create())));
+
+    int32_t pipeFds[2];
+    E_ASSERT((pipe(pipeFds) == 0));
+    int32_t fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int32_t pipeDoorbell[SHARED_RING_FD_COUNT] = {ring.getMemFd(), pipeFds[0], ring.getCqEventFd()};
+    E_ASSERT((openRing(fd, pipeDoorbell) == 0));
+    close(fd);
+    close(pipeFds[0]);
+    close(pipeFds[1]);
+
+    char payload[REQ_BUFFER_SIZE];
+    memset(payload, 0, sizeof(payload));
+    E_ASSERT((ring.submit(payload, sizeof(payload)) == true));
+
+    int32_t blockingEventFd = eventfd(0, EFD_CLOEXEC);
+    E_ASSERT((blockingEventFd >= 0));
+    fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    int32_t blockingDoorbell[SHARED_RING_FD_COUNT] = {ring.getMemFd(), blockingEventFd, ring.getCqEventFd()};
+    E_ASSERT((openRing(fd, blockingDoorbell) == 1));
+    E_ASSERT(((fcntl(blockingEventFd, F_GETFL) & O_NONBLOCK) != 0));
+
+    char result[64];
+    memset(result, 0, sizeof(result));
+    E_ASSERT((getProp("urm.logging.level", result, sizeof(result), "na") == 0));
+    E_ASSERT((strcmp(result, "na") != 0));
+
+    close(fd);
+    close(blockingEventFd);
+})
+
+/*
+ * Description:
+ * Benchmark the listener backend (resource_tuner.listener.backend: EPOLL or IO_URING) in use,
+ * with 4 concurrent client threads, each issuing getProp Requests with a connection per Request,
+ * and then over a persistent session. getProp is served directly by the listener, hence the
+ * numbers reflect the cost of accepting, receiving and responding. Compare the backends by
+ * running this test against the Server configured with each of them. All the results are
+ * validated, irrespective of the backend.
+ */
+URM_TEST(TestListenerBackendThroughput, {
+    const int32_t threadCount = 4;
+    const int32_t iterations = 2000;
+    std::atomic<int32_t> mismatches(0);
+
+    char backendProp[] = "resource_tuner.listener.backend";
+    char backend[64];
+    memset(backend, 0, sizeof(backend));
+    E_ASSERT((getProp(backendProp, backend, sizeof(backend), "EPOLL") == 0));
+    std::cout<<LOG_BASE<<"Listener backend: "<<backend<<std::endl;
+
+    for(int8_t persistent = 0; persistent <= 1; persistent++) {
+        std::vector<std::thread> clientThreads;
+
+        auto start = std::chrono::steady_clock::now();
+        for(int32_t t = 0; t < threadCount; t++) {
+            clientThreads.emplace_back([&]() {
+                char prop[] = "resource_tuner.maximum.concurrent.requests";
+                char buf[64];
+
+                setPersistentSession(persistent);
+                for(int32_t i = 0; i < iterations; i++) {
+                    memset(buf, 0, sizeof(buf));
+                    if(getProp(prop, buf, sizeof(buf), "na") != 0 || std::string(buf) != "60") {
+                        mismatches++;
+                    }
+                }
+                setPersistentSession(false);
+            });
+        }
+
+        for(std::thread& clientThread: clientThreads) {
+            clientThread.join();
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        double elapsedSec = std::chrono::duration<double>(end - start).count();
+        std::cout<<LOG_BASE<<(persistent ? "Persistent session: " : "Connection per Request: ")
+                 <<(int64_t)(threadCount * iterations / elapsedSec)<<" requests/sec"<<std::endl;
+    }
+
+    E_ASSERT((mismatches == 0));
+})
+
 /*
  * Description:
  * This Section contains tests which aim to verify the correctness of the Verifier.
@@ -1030,6 +1688,98 @@ URM_TEST(SingleClientTuneRequestMultipleResources, {
     delete[] resourceList;
 })
 
+/**
+ * API under test: tuneResourcesBatch
+ * - Single Client sends two independent tune requests (with different durations) in a single batch.
+ * - Verify that a distinct handle is received for each of the Requests.
+ * - Verify that the supplied values take effect on each of the resource nodes.
+ * - Verify that each Request expires independently, as per its own duration.
+ */
+URM_TEST(SingleClientTuneBatchRequest, {
+    std::string testResourceName1 = "/etc/urm/tests/nodes/sched_util_clamp_min.txt";
+    std::string testResourceName2 = "/etc/urm/tests/nodes/scaling_max_freq.txt";
+
+    int32_t testResourceOriginalValue1 = 300;
+    int32_t testResourceOriginalValue2 = 114;
+
+    std::string value;
+    int32_t originalValue[2], newValue;
+
+    value = AuxRoutines::readFromFile(testResourceName1);
+    originalValue[0] = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName1<<" Original Value: "<<originalValue[0]<<std::endl;
+    E_ASSERT((originalValue[0] == testResourceOriginalValue1));
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    originalValue[1] = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName2<<" Original Value: "<<originalValue[1]<<std::endl;
+    E_ASSERT((originalValue[1] == testResourceOriginalValue2));
+
+    SysResource* resourceList = new SysResource[2];
+    memset(&resourceList[0], 0, sizeof(SysResource));
+    resourceList[0].mResCode = CONSTRUCT_RES_CODE(0xff, 0x0000);
+    resourceList[0].mNumValues = 1;
+    resourceList[0].mResValue.value = 980;
+
+    memset(&resourceList[1], 0, sizeof(SysResource));
+    resourceList[1].mResCode = CONSTRUCT_RES_CODE(0xff, 0x0003);
+    resourceList[1].mNumValues = 1;
+    resourceList[1].mResValue.value = 765;
+
+    TuneRequestInfo requestList[2];
+    requestList[0].mDuration = 2000;
+    requestList[0].mProperties = RequestPriority::REQ_PRIORITY_HIGH;
+    requestList[0].mNumRes = 1;
+    requestList[0].mResourceList = &resourceList[0];
+
+    requestList[1].mDuration = 5000;
+    requestList[1].mProperties = RequestPriority::REQ_PRIORITY_HIGH;
+    requestList[1].mNumRes = 1;
+    requestList[1].mResourceList = &resourceList[1];
+
+    int64_t handles[2] = {-1, -1};
+    int8_t status = tuneResourcesBatch(2, requestList, handles);
+    std::cout<<LOG_BASE<<"Handles Returned: "<<handles[0]<<", "<<handles[1]<<std::endl;
+    E_ASSERT((status == 0));
+    E_ASSERT((handles[0] > 0));
+    E_ASSERT((handles[1] > 0));
+    E_ASSERT((handles[0] != handles[1]));
+
+    std::this_thread::sleep_for(std::chrono::seconds(1));
+
+    value = AuxRoutines::readFromFile(testResourceName1);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName1<<" Configured Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == 980));
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName2<<" Configured Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == 765));
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    // The first Request should have expired, while the second one is still active
+    value = AuxRoutines::readFromFile(testResourceName1);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName1<<" Reset Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == originalValue[0]));
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName2<<" Configured Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == 765));
+
+    std::this_thread::sleep_for(std::chrono::seconds(3));
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName2<<" Reset Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == originalValue[1]));
+
+    delete[] resourceList;
+})
+
 /**
  * API under test: Tune / Untune
  * - Two clients send requests for the same resource concurrently.
@@ -1316,6 +2066,78 @@ URM_TEST(TestMultipleClientsLowerIsBetterPolicy, {
     }
 })
 
+/**
+ * API under test: Tune / Untune
+ * - A client sends a burst of Requests for the same resource, immediately followed by Untune
+ *   Requests for half of them, so that the Requests are processed as part of the same batches
+ *   (and hence the same Write Plans) by the Server.
+ * - Req1 to Req10: value: v1 to v10, v1 < v2 < ... < v10
+ * - Req1 to Req5 are untuned.
+ * - Here the resource in question has the "Lower-Is-Better" policy, hence the value of Req6
+ *   should take effect on the node.
+ * - Verify that once all the Requests are untuned, the Resource Node value is reset.
+ */
+URM_TEST(TestMultipleRequestsLowerIsBetterPolicyChurn, {
+    std::string testResourceName = "/etc/urm/tests/nodes/scaling_min_freq.txt";
+    int32_t testResourceOriginalValue = 107;
+
+    std::string value;
+    int32_t originalValue;
+
+    value = AuxRoutines::readFromFile(testResourceName);
+    originalValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName<<" Original Value: "<<originalValue<<std::endl;
+    E_ASSERT((originalValue == testResourceOriginalValue));
+
+    const int32_t numRequests = 10;
+    std::vector<int64_t> handles(numRequests, -1);
+    int32_t untuneFailures = 0;
+    int32_t configuredValue = -1, resetValue = -1;
+
+    // All the Requests are issued from a dedicated thread, so that the burst is not rate limited
+    // due to the Requests issued earlier by the test thread.
+    std::thread clientThread([&]() {
+        SysResource resource;
+        for(int32_t i = 0; i < numRequests; i++) {
+            memset(&resource, 0, sizeof(SysResource));
+            resource.mResCode = CONSTRUCT_RES_CODE(0xff, 0x0002);
+            resource.mNumValues = 1;
+            resource.mResValue.value = 500 + i;
+            handles[i] = tuneResources(-1, RequestPriority::REQ_PRIORITY_HIGH, 1, &resource);
+        }
+
+        for(int32_t i = 0; i < numRequests / 2; i++) {
+            if(untuneResources(handles[i]) != 0) {
+                untuneFailures++;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        configuredValue = C_STOI(AuxRoutines::readFromFile(testResourceName));
+
+        for(int32_t i = numRequests / 2; i < numRequests; i++) {
+            if(untuneResources(handles[i]) != 0) {
+                untuneFailures++;
+            }
+        }
+
+        std::this_thread::sleep_for(std::chrono::seconds(1));
+        resetValue = C_STOI(AuxRoutines::readFromFile(testResourceName));
+    });
+    clientThread.join();
+
+    for(int64_t handle: handles) {
+        E_ASSERT((handle > 0));
+    }
+    E_ASSERT((untuneFailures == 0));
+
+    std::cout<<LOG_BASE<<testResourceName<<" Configured Value: "<<configuredValue<<std::endl;
+    E_ASSERT((configuredValue == 500 + numRequests / 2));
+
+    std::cout<<LOG_BASE<<testResourceName<<" Reset Value: "<<resetValue<<std::endl;
+    E_ASSERT((resetValue == originalValue));
+})
+
 /**
  * API under test: Tune / Untune
  * - Two clients send requests for the same resource concurrently, with different durations
@@ -4115,6 +4937,85 @@ URM_TEST(TestCgroupWriteAndReset5,  {
     delete[] resourceList;
 })
 
+/**
+ * API under test: Tune
+ * - Applied Priority is tracked per Resource instance (core / cluster / cgroup).
+ * - Here, a High Priority Request configures cpu.uclamp.min for the audio-cgroup, and a Low
+ *   Priority Request configures cpu.uclamp.min for the camera-cgroup.
+ * - Verify that the Low Priority Request is applied to the camera-cgroup, since no other
+ *   Request is acting on that instance.
+ * - Verify that both the instances are reset once the Requests expire.
+ */
+URM_TEST(TestCgroupPerInstancePriority, {
+    std::string testResourceName1 = "/sys/fs/cgroup/audio-cgroup/cpu.uclamp.min";
+    std::string testResourceName2 = "/sys/fs/cgroup/camera-cgroup/cpu.uclamp.min";
+
+    std::string value;
+    int32_t newValue;
+
+    value = AuxRoutines::readFromFile(testResourceName1);
+    int32_t originalValue1 = C_STOI(value);
+    value = AuxRoutines::readFromFile(testResourceName2);
+    int32_t originalValue2 = C_STOI(value);
+
+    SysResource* resourceList1 = new SysResource[1];
+    memset(&resourceList1[0], 0, sizeof(SysResource));
+    resourceList1[0].mResCode = CONSTRUCT_RES_CODE(0x09, 0x0007);
+    resourceList1[0].mNumValues = 2;
+    resourceList1[0].mResValue.values = new int32_t[2];
+    resourceList1[0].mResValue.values[0] = 802;
+    resourceList1[0].mResValue.values[1] = 53;
+
+    int64_t handle = tuneResources(8000, RequestPriority::REQ_PRIORITY_HIGH, 1, resourceList1);
+    std::cout<<LOG_BASE<<"Handle Returned: "<<handle<<std::endl;
+    E_ASSERT((handle > 0));
+
+    SysResource* resourceList2 = new SysResource[1];
+    memset(&resourceList2[0], 0, sizeof(SysResource));
+    resourceList2[0].mResCode = CONSTRUCT_RES_CODE(0x09, 0x0007);
+    resourceList2[0].mNumValues = 2;
+    resourceList2[0].mResValue.values = new int32_t[2];
+    resourceList2[0].mResValue.values[0] = 801;
+    resourceList2[0].mResValue.values[1] = 41;
+
+    handle = tuneResources(6000, RequestPriority::REQ_PRIORITY_LOW, 1, resourceList2);
+    std::cout<<LOG_BASE<<"Handle Returned: "<<handle<<std::endl;
+    E_ASSERT((handle > 0));
+
+    std::this_thread::sleep_for(std::chrono::seconds(2));
+
+    value = AuxRoutines::readFromFile(testResourceName1);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName1<<" Configured Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == 53));
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    newValue = C_STOI(value);
+    std::cout<<LOG_BASE<<testResourceName2<<" Configured Value: "<<newValue<<std::endl;
+    E_ASSERT((newValue == 41));
+
+    std::this_thread::sleep_for(std::chrono::seconds(10));
+
+    value = AuxRoutines::readFromFile(testResourceName1);
+    newValue = C_STOI(value);
+    if(newValue != -1 && originalValue1 != -1) {
+        std::cout<<LOG_BASE<<testResourceName1<<" Reset Value: "<<newValue<<std::endl;
+        E_ASSERT((newValue == originalValue1));
+    }
+
+    value = AuxRoutines::readFromFile(testResourceName2);
+    newValue = C_STOI(value);
+    if(newValue != -1 && originalValue2 != -1) {
+        std::cout<<LOG_BASE<<testResourceName2<<" Reset Value: "<<newValue<<std::endl;
+        E_ASSERT((newValue == originalValue2));
+    }
+
+    delete[] resourceList1[0].mResValue.values;
+    delete[] resourceList2[0].mResValue.values;
+    delete[] resourceList1;
+    delete[] resourceList2;
+})
+
 URM_TEST(TestCgroupWriteAndReset6, {
     std::string testResourceName = "/sys/fs/cgroup/audio-cgroup/cpuset.cpus";
 